@@ -1,6 +1,133 @@
 #include "BicubicBezierPatches.h"
+#include "CubicBezierArcs3.h"
+#include "CubicForwardDifferences.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 using namespace cagd;
+using namespace std;
+
+// control points of the restriction of the cubic Bezier arc to [a, b], the k-th one is the blossom of the arc
+// at k copies of b and 3 - k copies of a
+static inline GLvoid subarc(const DCoordinate3 *p, GLdouble a, GLdouble b, DCoordinate3 *q)
+{
+    for (GLuint k = 0; k < 4; k++)
+    {
+        DCoordinate3 r[4] = {p[0], p[1], p[2], p[3]};
+
+        for (GLuint level = 0; level < 3; level++)
+        {
+            GLdouble t = (level < k) ? b : a;
+
+            for (GLuint i = 0; i < 3 - level; i++)
+            {
+                r[i] = (1.0 - t) * r[i] + t * r[i + 1];
+            }
+        }
+
+        q[k] = r[0];
+    }
+}
+
+// the angle between two vectors, zero if one of them vanishes
+static inline GLdouble angle(const DCoordinate3& lhs, const DCoordinate3& rhs)
+{
+    return atan2((lhs ^ rhs).length(), lhs * rhs);
+}
+
+// special constructor
+BicubicBezierPatch::SubdivisionCriterion::SubdivisionCriterion(
+        const BicubicBezierPatch& patch, GLdouble chord_tolerance, GLdouble angular_tolerance):
+    _patch(patch),
+    _chord_tolerance(chord_tolerance),
+    _angular_tolerance(angular_tolerance)
+{
+}
+
+// decides whether the cell [u_0, u_1] x [v_0, v_1] has to be split
+GLboolean BicubicBezierPatch::SubdivisionCriterion::operator ()(
+        GLdouble u_0, GLdouble u_1, GLdouble v_0, GLdouble v_1) const
+{
+    if (_chord_tolerance > 0.0)
+    {
+        // the rows of the control net are restricted to [v_0, v_1], then its columns to [u_0, u_1]
+        Matrix<DCoordinate3, 4, 4> rows, net;
+
+        for (GLuint i = 0; i < 4; i++)
+        {
+            DCoordinate3 row[4] = {_patch(i, 0), _patch(i, 1), _patch(i, 2), _patch(i, 3)}, restricted[4];
+            subarc(row, v_0, v_1, restricted);
+
+            for (GLuint j = 0; j < 4; j++)
+            {
+                rows(i, j) = restricted[j];
+            }
+        }
+
+        for (GLuint j = 0; j < 4; j++)
+        {
+            DCoordinate3 column[4] = {rows(0, j), rows(1, j), rows(2, j), rows(3, j)}, restricted[4];
+            subarc(column, u_0, u_1, restricted);
+
+            for (GLuint i = 0; i < 4; i++)
+            {
+                net(i, j) = restricted[i];
+            }
+        }
+
+        // the degree elevated control net of the bilinear interpolant consists of its values at (i / 3, j / 3)
+        GLdouble deviation = 0.0;
+
+        for (GLuint i = 0; i < 4; i++)
+        {
+            for (GLuint j = 0; j < 4; j++)
+            {
+                DCoordinate3 bilinear = ((3.0 - i) * (3.0 - j) * net(0, 0) + (3.0 - i) * j * net(0, 3) +
+                                         i * (3.0 - j) * net(3, 0) + i * j * net(3, 3)) / 9.0;
+
+                deviation = max(deviation, (net(i, j) - bilinear).length());
+            }
+        }
+
+        DCoordinate3 twist = net(0, 0) - net(0, 3) + net(3, 3) - net(3, 0);
+
+        if (deviation + 0.25 * twist.length() > _chord_tolerance)
+        {
+            return GL_TRUE;
+        }
+    }
+
+    if (_angular_tolerance > 0.0)
+    {
+        // fixed-size storage, since the criterion is evaluated for every cell of the quadtree
+        TriangularMatrix<DCoordinate3, 2> pd;
+
+        if (!_patch._CalculatePartialDerivatives(0.5 * (u_0 + u_1), 0.5 * (v_0 + v_1), pd))
+        {
+            return GL_FALSE;
+        }
+
+        DCoordinate3 center = pd(1, 0) ^ pd(1, 1);
+
+        GLdouble u[2] = {u_0, u_1}, v[2] = {v_0, v_1};
+
+        for (GLuint a = 0; a < 2; a++)
+        {
+            for (GLuint b = 0; b < 2; b++)
+            {
+                if (_patch._CalculatePartialDerivatives(u[a], v[b], pd) &&
+                    angle(center, pd(1, 0) ^ pd(1, 1)) > _angular_tolerance)
+                {
+                    return GL_TRUE;
+                }
+            }
+        }
+    }
+
+    return GL_FALSE;
+}
 
 BicubicBezierPatch::BicubicBezierPatch(): TensorProductSurface3(0.0, 1.0, 0.0, 1.0, 4, 4)
 {
@@ -13,85 +140,210 @@ GLboolean BicubicBezierPatch::UBlendingFunctionValues(GLdouble u_knot, RowMatrix
         return GL_FALSE;
     }
 
-    blending_values.ResizeColumns(4);
+    return CubicBernsteinDerivatives(0, u_knot, static_cast<Matrix<GLdouble>&>(blending_values));
+}
 
-    GLdouble u = u_knot, u2 = u * u, u3 = u2 * u, w = 1.0 - u, w2 = w * w, w3 = w2 * w;
+GLboolean BicubicBezierPatch::VBlendingFunctionValues(GLdouble v_knot, RowMatrix<GLdouble> &blending_values) const
+{
+    if (v_knot < 0.0 || v_knot > 1.0)
+    {
+        return GL_FALSE;
+    }
 
-    blending_values[0] = w3;
-    blending_values[1] = 3.0 * w2 * u;
-    blending_values[2] = 3.0 * w * u2;
-    blending_values[3] = u3;
+    return CubicBernsteinDerivatives(0, v_knot, static_cast<Matrix<GLdouble>&>(blending_values));
+}
 
-    return GL_TRUE;
+GLboolean BicubicBezierPatch::UBlendingFunctionDerivatives(GLuint maximum_order_of_derivatives, GLdouble u_knot, Matrix<GLdouble> &derivatives) const
+{
+    return CubicBernsteinDerivatives(maximum_order_of_derivatives, u_knot, derivatives);
 }
 
-GLboolean BicubicBezierPatch::VBlendingFunctionValues(GLdouble v_knot, RowMatrix<GLdouble> &blending_values) const
+GLboolean BicubicBezierPatch::VBlendingFunctionDerivatives(GLuint maximum_order_of_derivatives, GLdouble v_knot, Matrix<GLdouble> &derivatives) const
 {
-    if (v_knot < 0.0 || v_knot > 1.0)
+    return CubicBernsteinDerivatives(maximum_order_of_derivatives, v_knot, derivatives);
+}
+
+GLboolean BicubicBezierPatch::CalculatePartialDerivatives(GLuint maximum_order_of_partial_derivatives, GLdouble u, GLdouble v, PartialDerivatives &pd) const
+{
+    if (maximum_order_of_partial_derivatives > 1)
     {
         return GL_FALSE;
     }
 
-    blending_values.ResizeColumns(4);
+    pd.ResizeRows(2);
 
-    GLdouble v = v_knot, v2 = v * v, v3 = v2 * v, w = 1.0 - v, w2 = w * w, w3 = w2 * w;
+    return _CalculatePartialDerivatives(u, v, pd);
+}
 
-    blending_values[0] = w3;
-    blending_values[1] = 3.0 * w2 * v;
-    blending_values[2] = 3.0 * w * v2;
-    blending_values[3] = v3;
+template <class Derivatives>
+GLboolean BicubicBezierPatch::_CalculatePartialDerivatives(GLdouble u, GLdouble v, Derivatives &pd) const
+{
+    if (u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0)
+    {
+        return GL_FALSE;
+    }
+
+    // zeroth and first order derivatives of the blending functions in directions u and v,
+    // stored in fixed-size matrices that do not need dynamical memory allocation
+    Matrix<GLdouble, 2, 4> u_blending_values, v_blending_values;
+
+    CubicBernsteinDerivatives(1, u, u_blending_values);
+    CubicBernsteinDerivatives(1, v, v_blending_values);
+
+    pd(0, 0) = pd(1, 0) = pd(1, 1) = DCoordinate3();
+
+    for (GLuint row = 0; row < 4; row++)
+    {
+        DCoordinate3 aux_d0_v, aux_d1_v;
+        for (GLuint column = 0; column < 4; column++)
+        {
+            aux_d0_v += _data(row, column) * v_blending_values(0, column);
+            aux_d1_v += _data(row, column) * v_blending_values(1, column);
+        }
+        pd(0, 0) += aux_d0_v * u_blending_values(0, row);
+        pd(1, 0) += aux_d0_v * u_blending_values(1, row);
+        pd(1, 1) += aux_d1_v * u_blending_values(0, row);
+    }
 
     return GL_TRUE;
 }
 
-GLboolean BicubicBezierPatch::CalculatePartialDerivatives(GLuint maximum_order_of_partial_derivatives, GLdouble u, GLdouble v, PartialDerivatives &pd) const
+GLboolean BicubicBezierPatch::SecondOrderPartialDerivativeBounds(GLdouble &uu, GLdouble &uv, GLdouble &vv) const
 {
-    if (u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0 || maximum_order_of_partial_derivatives > 1)
+    uu = uv = vv = 0.0;
+
+    // the blending functions are evaluated at the parameters themselves, thus the bounds below do not hold outside
+    // of the unit square
+    if (_u_min < 0.0 || _u_max > 1.0 || _v_min < 0.0 || _v_max > 1.0)
     {
         return GL_FALSE;
     }
 
-    RowMatrix<GLdouble> u_blending_values(4), d1_u_blending_values(4);
+    for (GLuint i = 0; i < 4; i++)
+    {
+        for (GLuint j = 0; j < 4; j++)
+        {
+            if (i < 2)
+                uu = max(uu, (_data(i + 2, j) - 2.0 * _data(i + 1, j) + _data(i, j)).length());
 
-    GLdouble u2 = u * u, u3 = u2 * u, wu = 1.0 - u, wu2 = wu * wu, wu3 = wu2 * wu;
+            if (j < 2)
+                vv = max(vv, (_data(i, j + 2) - 2.0 * _data(i, j + 1) + _data(i, j)).length());
 
-    u_blending_values[0] = wu3;
-    u_blending_values[1] = 3.0 * wu2 * u;
-    u_blending_values[2] = 3.0 * wu * u2;
-    u_blending_values[3] = u3;
+            if (i < 3 && j < 3)
+                uv = max(uv, (_data(i + 1, j + 1) - _data(i + 1, j) - _data(i, j + 1) + _data(i, j)).length());
+        }
+    }
 
-    d1_u_blending_values[0] = -3.0 * wu2;
-    d1_u_blending_values[1] = -6.0 * wu * u + 3.0 * wu2;
-    d1_u_blending_values[2] = -3.0 * u2 + 6.0 * wu * u;
-    d1_u_blending_values[3] = 3.0 * u2;
+    // s_uu = 6 sum_{i=0}^{1} sum_{j=0}^{3} (p_{i+2,j} - 2 p_{i+1,j} + p_{i,j}) B_{1,i}(u) B_{3,j}(v), similarly for
+    // s_vv, while s_uv = 9 sum_{i=0}^{2} sum_{j=0}^{2} (p_{i+1,j+1} - p_{i+1,j} - p_{i,j+1} + p_{i,j}) B_{2,i}(u) B_{2,j}(v),
+    // and the Bernstein polynomials form partitions of unity
+    uu *= 6.0;
+    vv *= 6.0;
+    uv *= 9.0;
 
-    RowMatrix<GLdouble> v_blending_values(4), d1_v_blending_values(4);
+    return GL_TRUE;
+}
 
-    GLdouble v2 = v * v, v3 = v2 * v, wv = 1.0 - v, wv2 = wv * wv, wv3 = wv2 * wv;
+GLboolean BicubicBezierPatch::_EvaluateOnUniformGrid(
+        GLuint u_div_point_count, GLuint v_div_point_count,
+        vector<DCoordinate3>& points, vector<DCoordinate3>& normals) const
+{
+    if (_u_min != 0.0 || _u_max != 1.0 || _v_min != 0.0 || _v_max != 1.0 ||
+        u_div_point_count < 2 || v_div_point_count < 2 ||
+        points.size() < u_div_point_count * v_div_point_count || normals.size() < points.size())
+    {
+        return GL_FALSE;
+    }
 
-    v_blending_values[0] = wv3;
-    v_blending_values[1] = 3.0 * wv2 * v;
-    v_blending_values[2] = 3.0 * wv * v2;
-    v_blending_values[3] = v3;
+    // the columns of the control net define cubic arcs in direction u, at u_i their points and first order
+    // derivatives are the control points of the v-directional isoparametric line and of its u-directional
+    // derivative, respectively
+    vector<CubicForwardDifferences> columns;
+    columns.reserve(4);
+
+    for (GLuint column = 0; column < 4; column++)
+    {
+        columns.push_back(CubicForwardDifferences(
+                _data(0, column), _data(1, column), _data(2, column), _data(3, column), u_div_point_count));
+    }
 
-    d1_v_blending_values[0] = -3.0 * wv2;
-    d1_v_blending_values[1] = -6.0 * wv * v + 3.0 * wv2;
-    d1_v_blending_values[2] = -3.0 * v2 + 6.0 * wv * v;
-    d1_v_blending_values[3] = 3.0 * v2;
+    GLuint index = 0;
 
-    pd.ResizeRows(2);
-    pd.LoadNullVectors();
-    for (GLuint row = 0; row < 4; row++)
+    for (GLuint i = 0; i < u_div_point_count; i++)
     {
-        DCoordinate3 aux_d0_v, aux_d1_v;
+        CubicForwardDifferences line(
+                columns[0].Point(), columns[1].Point(), columns[2].Point(), columns[3].Point(),
+                v_div_point_count);
+
+        CubicForwardDifferences u_derivative(
+                columns[0].FirstDerivative(), columns[1].FirstDerivative(),
+                columns[2].FirstDerivative(), columns[3].FirstDerivative(),
+                v_div_point_count);
+
+        for (GLuint j = 0; j < v_div_point_count; j++, index++)
+        {
+            points[index] = line.Point();
+
+            normals[index] = u_derivative.Point();
+            normals[index] ^= line.FirstDerivative();
+            normals[index].normalize();
+
+            line.Advance();
+            u_derivative.Advance();
+        }
+
         for (GLuint column = 0; column < 4; column++)
         {
-            aux_d0_v += _data(row, column) * v_blending_values(column);
-            aux_d1_v += _data(row, column) * d1_v_blending_values(column);
+            columns[column].Advance();
         }
-        pd(0, 0) += aux_d0_v * u_blending_values(row);
-        pd(1, 0) += aux_d0_v * d1_u_blending_values(row);
-        pd(1, 1) += aux_d1_v * u_blending_values(row);
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean BicubicBezierPatch::_EvaluateIsoparametricLineUniformly(
+        GLuint direction, GLdouble fixed_parameter,
+        GLuint maximum_order_of_derivatives, GenericCurve3& line) const
+{
+    GLuint div_point_count = line.GetPointCount();
+
+    if (_u_min != 0.0 || _u_max != 1.0 || _v_min != 0.0 || _v_max != 1.0 ||
+        direction > 1 || maximum_order_of_derivatives > 2 ||
+        maximum_order_of_derivatives > line.GetMaximumOrderOfDerivatives() || div_point_count < 2)
+    {
+        return GL_FALSE;
+    }
+
+    // Bernstein polynomials at the fixed parameter
+    RowMatrix<GLdouble> blending_values;
+
+    if (!UBlendingFunctionValues(fixed_parameter, blending_values))
+    {
+        return GL_FALSE;
+    }
+
+    // control points of the isoparametric line
+    DCoordinate3 control_points[4];
+
+    for (GLuint i = 0; i < 4; i++)
+    {
+        for (GLuint j = 0; j < 4; j++)
+        {
+            control_points[i] += blending_values[j] * (direction ? _data(j, i) : _data(i, j));
+        }
+    }
+
+    CubicForwardDifferences arc(control_points[0], control_points[1], control_points[2], control_points[3], div_point_count);
+
+    for (GLuint k = 0; k < div_point_count; k++, arc.Advance())
+    {
+        line(0, k) = arc.Point();
+
+        if (maximum_order_of_derivatives >= 1)
+            line(1, k) = arc.FirstDerivative();
+
+        if (maximum_order_of_derivatives >= 2)
+            line(2, k) = arc.SecondDerivative();
     }
 
     return GL_TRUE;
@@ -5,13 +5,54 @@
 namespace cagd {
     class BicubicBezierPatch: public TensorProductSurface3
     {
+    protected:
+        // uniform grids and isoparametric lines by forward differencing
+        GLboolean _EvaluateOnUniformGrid(
+                GLuint u_div_point_count, GLuint v_div_point_count,
+                std::vector<DCoordinate3>& points, std::vector<DCoordinate3>& normals) const;
+
+        GLboolean _EvaluateIsoparametricLineUniformly(
+                GLuint direction, GLdouble fixed_parameter,
+                GLuint maximum_order_of_derivatives, GenericCurve3& line) const;
+
+        // zeroth and first order partial derivatives, stored in any triangular matrix of at least two rows (e.g., in
+        // a fixed-size TriangularMatrix<DCoordinate3, 2> by internal evaluators that must not allocate memory)
+        template <class Derivatives>
+        GLboolean _CalculatePartialDerivatives(GLdouble u, GLdouble v, Derivatives& pd) const;
 
     public:
+        // refinement criterion of restricted quadtrees over the definition domain (see Core/RestrictedQuadtrees.h):
+        // a cell is split if
+        //  - the control net of the subpatch over the cell deviates from the bilinear interpolant of its corners by
+        //    more than the chord tolerance, after the distance of the bilinear patch from its two triangles (a quarter
+        //    of its twist) has been added; due to the convex hull property this bounds the distance of the subpatch
+        //    from the triangles;
+        //  - or the unit normal at the center of the cell and the one at a corner enclose an angle that is greater
+        //    than the angular tolerance (in radians);
+        // non-positive tolerances switch the corresponding criteria off
+        class SubdivisionCriterion
+        {
+        private:
+            const BicubicBezierPatch &_patch;
+            GLdouble                  _chord_tolerance, _angular_tolerance;
+
+        public:
+            SubdivisionCriterion(const BicubicBezierPatch& patch, GLdouble chord_tolerance, GLdouble angular_tolerance);
+
+            GLboolean operator ()(GLdouble u_0, GLdouble u_1, GLdouble v_0, GLdouble v_1) const;
+        };
+
         BicubicBezierPatch();
 
         GLboolean UBlendingFunctionValues(GLdouble u_knot, RowMatrix<GLdouble>& blending_values) const;
         GLboolean VBlendingFunctionValues(GLdouble v_knot, RowMatrix<GLdouble>& blending_values) const;
+        GLboolean UBlendingFunctionDerivatives(GLuint maximum_order_of_derivatives, GLdouble u_knot, Matrix<GLdouble>& derivatives) const;
+        GLboolean VBlendingFunctionDerivatives(GLuint maximum_order_of_derivatives, GLdouble v_knot, Matrix<GLdouble>& derivatives) const;
         GLboolean CalculatePartialDerivatives(GLuint maximum_order_of_partial_derivatives, GLdouble u, GLdouble v, PartialDerivatives& pd) const;
 
+        // the second order partial derivatives are Bezier patches, whose control points are the scaled second
+        // differences of the control net, thus their lengths are bounded by the longest ones of these differences
+        GLboolean SecondOrderPartialDerivativeBounds(GLdouble& uu, GLdouble& uv, GLdouble& vv) const;
+
     };
 }
@@ -3,6 +3,7 @@
 #include <Core/Exceptions.h>
 #include <iostream>
 #include <fstream>
+#include <map>
 #include <QRandomGenerator>
 
 using namespace std;
@@ -25,7 +26,8 @@ namespace cagd
     }
 
     BicubicCompositeSurface3::PatchAttributes::PatchAttributes():
-        patch(nullptr), image(nullptr), neighbours(8, nullptr), u_lines(nullptr), v_lines(nullptr)
+        patch(nullptr), image(nullptr), neighbours(8, nullptr), u_lines(nullptr), v_lines(nullptr),
+        u_div_point_count(0), v_div_point_count(0), image_is_preview(GL_FALSE)
     {
         matInd = QRandomGenerator::global()->bounded(4);
         texInd = QRandomGenerator::global()->bounded(4);
@@ -47,6 +49,13 @@ namespace cagd
         matInd = attribute.matInd;
         texInd = attribute.texInd;
 
+        u_div_point_count = attribute.u_div_point_count;
+        v_div_point_count = attribute.v_div_point_count;
+        image_is_preview = attribute.image_is_preview;
+
+        adaptive_tree = attribute.adaptive_tree;
+        matched_tree = attribute.matched_tree;
+
         neighbours.resize(8, nullptr);
         for (int i = 0; i < 8; ++i)
         {
@@ -65,6 +74,11 @@ namespace cagd
             delete image; image = nullptr;
         }
 
+        _DeleteIsoparametricLines();
+    }
+
+    void BicubicCompositeSurface3::PatchAttributes::_DeleteIsoparametricLines()
+    {
         if (u_lines)
         {
             for (GLuint i=0; i<u_lines->GetColumnCount(); ++i)
@@ -305,10 +319,62 @@ namespace cagd
         }
     }
 
+    GLboolean BicubicCompositeSurface3::PatchAttributes::_GetSharedBoundary(
+            Direction direction,
+            RestrictedQuadtree::Side &side,
+            RestrictedQuadtree::Side &neighbourSide,
+            GLboolean &reversed) const
+    {
+        if ((direction != N && direction != W && direction != S && direction != E) || !neighbours[direction])
+        {
+            return GL_FALSE;
+        }
+
+        // the rows of the control net correspond to the parameter u, the boundary runs from the corner
+        // (firstRow, firstColumn) to the corner (lastRow, lastColumn)
+        GLuint firstRow = (direction == S) ? 3 : 0, firstColumn = (direction == E) ? 3 : 0;
+        GLuint lastRow = (direction == N) ? 0 : 3, lastColumn = (direction == W) ? 0 : 3;
+
+        switch (direction)
+        {
+        case N:  side = RestrictedQuadtree::U_MIN; break;
+        case S:  side = RestrictedQuadtree::U_MAX; break;
+        case W:  side = RestrictedQuadtree::V_MIN; break;
+        default: side = RestrictedQuadtree::V_MAX; break;
+        }
+
+        // the corners of the neighbour that coincide with the end points of the boundary
+        GLuint i0 = 4, j0 = 4, i1 = 4, j1 = 4;
+
+        _GetSymmetricPointIndexes(firstRow, firstColumn, direction, i0, j0);
+        _GetSymmetricPointIndexes(lastRow, lastColumn, direction, i1, j1);
+
+        if (i0 == i1 && (i0 == 0 || i0 == 3) && j0 + j1 == 3 && (j0 == 0 || j0 == 3))
+        {
+            neighbourSide = (i0 == 0) ? RestrictedQuadtree::U_MIN : RestrictedQuadtree::U_MAX;
+            reversed = (j0 == 3);
+
+            return GL_TRUE;
+        }
+
+        if (j0 == j1 && (j0 == 0 || j0 == 3) && i0 + i1 == 3 && (i0 == 0 || i0 == 3))
+        {
+            neighbourSide = (j0 == 0) ? RestrictedQuadtree::V_MIN : RestrictedQuadtree::V_MAX;
+            reversed = (i0 == 3);
+
+            return GL_TRUE;
+        }
+
+        return GL_FALSE;
+    }
+
     // --------------------------------------------------------------------------------
 
     BicubicCompositeSurface3::BicubicCompositeSurface3(GLuint patchCount):
-            _u_iso_line_count(50), _v_iso_line_count(50)
+            _u_iso_line_count(50), _v_iso_line_count(50),
+            _adaptive_tessellation(GL_FALSE), _chord_tolerance(1.0e-3), _angular_tolerance(0.1),
+            _maximum_tessellation_level(6), _maximum_deviation(0.0), _interactive_preview(GL_FALSE),
+            _image_resolutions_are_valid(GL_FALSE)
     {
         _loadTextures();
         for (GLuint i = 0; i < patchCount; i++)
@@ -316,6 +382,11 @@ namespace cagd
             PatchAttributes* newAttr = new PatchAttributes;
             _attributes.push_back(newAttr);
             (*_attributes[i]).patch = InitializePatch();
+        }
+
+        // the images are generated after all patches have been inserted, thus the resolutions are calculated once
+        for (GLuint i = 0; i < patchCount; i++)
+        {
             UpdateVBOs(_attributes[i]);
         }
     }
@@ -323,6 +394,8 @@ namespace cagd
     GLvoid BicubicCompositeSurface3::UpdateUIsoLines(GLuint iso_line_count)
     {
         _u_iso_line_count = iso_line_count;
+        _InvalidateImageResolutions();
+
         for (GLuint i = 0; i < _attributes.size(); i++)
         {
             PatchAttributes *attribute = _attributes[i];
@@ -333,6 +406,8 @@ namespace cagd
     GLvoid BicubicCompositeSurface3::UpdateVIsoLines(GLuint iso_line_count)
     {
         _v_iso_line_count = iso_line_count;
+        _InvalidateImageResolutions();
+
         for (GLuint i = 0; i < _attributes.size(); i++)
         {
             PatchAttributes *attribute = _attributes[i];
@@ -340,6 +415,235 @@ namespace cagd
         }
     }
 
+    GLvoid BicubicCompositeSurface3::SetAdaptiveTessellation(GLboolean enabled, GLdouble chord_tolerance, GLdouble angular_tolerance, GLuint maximum_level)
+    {
+        _adaptive_tessellation = enabled;
+        _chord_tolerance = chord_tolerance;
+        _angular_tolerance = angular_tolerance;
+        _maximum_tessellation_level = maximum_level;
+
+        // the quadtrees of all patches have to be rebuilt by the new parameters, before the first one is matched
+        // with its neighbours
+        for (GLuint i = 0; i < _attributes.size(); i++)
+        {
+            PatchAttributes *attribute = _attributes[i];
+
+            attribute->adaptive_tree = RestrictedQuadtree(_maximum_tessellation_level);
+            attribute->matched_tree = RestrictedQuadtree(_maximum_tessellation_level);
+
+            if (_adaptive_tessellation)
+            {
+                attribute->adaptive_tree.Build(BicubicBezierPatch::SubdivisionCriterion(
+                        *attribute->patch, _chord_tolerance, _angular_tolerance));
+            }
+        }
+
+        for (GLuint i = 0; i < _attributes.size(); i++)
+        {
+            UpdateVBOs(_attributes[i]);
+        }
+    }
+
+    GLboolean BicubicCompositeSurface3::IsTessellationAdaptive() const
+    {
+        return _adaptive_tessellation;
+    }
+
+    GLvoid BicubicCompositeSurface3::SetMaximumDeviation(GLdouble maximum_deviation)
+    {
+        _maximum_deviation = maximum_deviation;
+        _InvalidateImageResolutions();
+
+        for (GLuint i = 0; i < _attributes.size(); i++)
+        {
+            UpdateVBOs(_attributes[i]);
+        }
+    }
+
+    GLdouble BicubicCompositeSurface3::GetMaximumDeviation() const
+    {
+        return _maximum_deviation;
+    }
+
+    GLvoid BicubicCompositeSurface3::SetInteractivePreview(GLboolean enabled)
+    {
+        if (_interactive_preview == enabled)
+        {
+            return;
+        }
+
+        _interactive_preview = enabled;
+
+        if (!_interactive_preview)
+        {
+            for (GLuint i = 0; i < _attributes.size(); i++)
+            {
+                if (_attributes[i]->image_is_preview)
+                {
+                    UpdateVBOs(_attributes[i]);
+                }
+            }
+        }
+    }
+
+    // the resolution of the uniform image of the given patch (see _UpdateImageResolutions)
+    GLvoid BicubicCompositeSurface3::_GetImageResolution(const PatchAttributes *attribute, GLuint &u_div_point_count, GLuint &v_div_point_count) const
+    {
+        if (!_image_resolutions_are_valid || _attribute_indexes.size() != _attributes.size())
+        {
+            _UpdateImageResolutions();
+        }
+
+        std::map<const PatchAttributes*, GLuint>::const_iterator it = _attribute_indexes.find(attribute);
+
+        if (it == _attribute_indexes.end())
+        {
+            throw Exception("The patch does not belong to the composite surface!");
+        }
+
+        u_div_point_count = _u_div_point_counts[it->second];
+        v_div_point_count = _v_div_point_counts[it->second];
+    }
+
+    GLvoid BicubicCompositeSurface3::_InvalidateImageResolutions()
+    {
+        _image_resolutions_are_valid = GL_FALSE;
+    }
+
+    // each patch needs the smallest resolution that guarantees the maximum deviation, or the iso-line counts if it
+    // is not set (or if the guarantee would need too many points); the images of joined patches have vertices in
+    // common only if they have the same number of points along their shared boundary, therefore the point counts
+    // that are linked by shared boundaries form classes, and each of them is raised to the largest one of its class
+    GLvoid BicubicCompositeSurface3::_UpdateImageResolutions() const
+    {
+        GLuint patch_count = _attributes.size();
+
+        _attribute_indexes.clear();
+
+        for (GLuint i = 0; i < patch_count; i++)
+        {
+            _attribute_indexes[_attributes[i]] = i;
+        }
+
+        // the u and v point counts of the ith patch are the (2i)th and (2i+1)st elements of the classes
+        std::vector<GLuint> counts(2 * patch_count), parents(2 * patch_count);
+
+        for (GLuint i = 0; i < patch_count; i++)
+        {
+            if (_maximum_deviation <= 0.0 ||
+                !_attributes[i]->patch->UniformResolutionForChordalError(_maximum_deviation, counts[2 * i], counts[2 * i + 1]))
+            {
+                counts[2 * i] = _u_iso_line_count;
+                counts[2 * i + 1] = _v_iso_line_count;
+            }
+
+            parents[2 * i] = 2 * i;
+            parents[2 * i + 1] = 2 * i + 1;
+        }
+
+        // boundaries u = const run along v, and vice versa
+        for (GLuint i = 0; i < patch_count; i++)
+        {
+            const PatchAttributes *attribute = _attributes[i];
+            Direction directions[4] = {N, W, S, E};
+
+            for (GLuint d = 0; d < 4; d++)
+            {
+                RestrictedQuadtree::Side side, neighbour_side;
+                GLboolean reversed;
+
+                if (!attribute->_GetSharedBoundary(directions[d], side, neighbour_side, reversed))
+                {
+                    continue;
+                }
+
+                std::map<const PatchAttributes*, GLuint>::const_iterator it =
+                        _attribute_indexes.find(attribute->neighbours[directions[d]]);
+
+                if (it == _attribute_indexes.end())
+                {
+                    continue;
+                }
+
+                GLuint neighbour = it->second;
+
+                GLuint first = 2 * i + ((side == RestrictedQuadtree::U_MIN || side == RestrictedQuadtree::U_MAX) ? 1 : 0);
+                GLuint second = 2 * neighbour +
+                        ((neighbour_side == RestrictedQuadtree::U_MIN || neighbour_side == RestrictedQuadtree::U_MAX) ? 1 : 0);
+
+                while (parents[first] != first)
+                {
+                    first = parents[first] = parents[parents[first]];
+                }
+
+                while (parents[second] != second)
+                {
+                    second = parents[second] = parents[parents[second]];
+                }
+
+                if (first != second)
+                {
+                    parents[second] = first;
+                    counts[first] = max(counts[first], counts[second]);
+                }
+            }
+        }
+
+        _u_div_point_counts.resize(patch_count);
+        _v_div_point_counts.resize(patch_count);
+
+        for (GLuint i = 0; i < patch_count; i++)
+        {
+            GLuint u_root = 2 * i, v_root = 2 * i + 1;
+
+            while (parents[u_root] != u_root)
+            {
+                u_root = parents[u_root];
+            }
+
+            while (parents[v_root] != v_root)
+            {
+                v_root = parents[v_root];
+            }
+
+            _u_div_point_counts[i] = counts[u_root];
+            _v_div_point_counts[i] = counts[v_root];
+        }
+
+        _image_resolutions_are_valid = GL_TRUE;
+    }
+
+    // regenerates the uniform images whose resolution does not match the one of their class any more, e.g., after
+    // an edit that changed the resolution of a joined patch, or after patches were joined
+    GLboolean BicubicCompositeSurface3::_MatchImageResolutions()
+    {
+        if (_adaptive_tessellation)
+        {
+            return GL_TRUE;
+        }
+
+        if (!_image_resolutions_are_valid || _attribute_indexes.size() != _attributes.size())
+        {
+            _UpdateImageResolutions();
+        }
+
+        for (GLuint i = 0; i < _attributes.size(); i++)
+        {
+            PatchAttributes *attribute = _attributes[i];
+
+            if (attribute->image &&
+                (_u_div_point_counts[i] != attribute->u_div_point_count || _v_div_point_counts[i] != attribute->v_div_point_count))
+            {
+                if (!UpdateVBOs(attribute))
+                {
+                    return GL_FALSE;
+                }
+            }
+        }
+
+        return GL_TRUE;
+    }
+
     BicubicBezierPatch* BicubicCompositeSurface3::InitializePatch()
     {
         BicubicBezierPatch* patch = new BicubicBezierPatch();
@@ -379,6 +683,9 @@ namespace cagd
             throw Exception("Could not update the VBO of data of the patch!");
         }
 
+        // the previous lines and image are replaced, thus they are deleted together with their VBOs
+        attribute->_DeleteIsoparametricLines();
+
         attribute->u_lines = attribute->patch->GenerateUIsoparametricLines(_u_iso_line_count, 1, 30);
         attribute->v_lines = attribute->patch->GenerateVIsoparametricLines(_v_iso_line_count, 1, 30);
         for(GLuint i=0; i<attribute->u_lines->GetColumnCount(); ++i)
@@ -396,11 +703,27 @@ namespace cagd
             }
         }
 
-        attribute->image = attribute->patch->GenerateImage(_u_iso_line_count, _v_iso_line_count);
-        if (!attribute->image)
+        attribute->partials.Clear();
+
+        if (_adaptive_tessellation)
+        {
+            return _UpdateAdaptiveImages(attribute);
+        }
+
+        _GetImageResolution(attribute, attribute->u_div_point_count, attribute->v_div_point_count);
+
+        TriangulatedMesh3 *image = _interactive_preview ?
+                attribute->patch->GeneratePreviewImage(attribute->u_div_point_count, attribute->v_div_point_count) :
+                attribute->patch->GenerateImage(attribute->u_div_point_count, attribute->v_div_point_count);
+        if (!image)
         {
             throw Exception("Could not generate the image of patch!");
         }
+
+        delete attribute->image;
+        attribute->image = image;
+        attribute->image_is_preview = _interactive_preview;
+
         if (!attribute->image->UpdateVertexBufferObjects())
         {
             throw Exception("Could not update the VBO of patch image");
@@ -674,6 +997,7 @@ namespace cagd
     {
         PatchAttributes* attribute = new PatchAttributes;
         _attributes.push_back(attribute);
+        _InvalidateImageResolutions();
 
         try
         {
@@ -702,16 +1026,294 @@ namespace cagd
 
         std::vector<PointUpdate> points;
         points.push_back(PointUpdate(row, column, position));
-        return UpdatePatch(_attributes[patchIndex], points);
+        return UpdatePatch(_attributes[patchIndex], points) && _MatchImageResolutions();
     }
 
     GLboolean BicubicCompositeSurface3::UpdatePatch(PatchAttributes *attribute, std::vector<PointUpdate> points)
     {
-        PatchAttributes *neighbour;
+        // the control points of every affected patch are set before the first image is updated, thus the
+        // resolutions of the images are calculated only once
+        std::vector<PatchAttributes*> changed_attributes;
+        std::vector<Matrix<DCoordinate3> > previous_data;
+
+        _SetPointsRecursively(attribute, points, changed_attributes, previous_data);
+
+        for (GLuint i = 0; i < changed_attributes.size(); i++)
+        {
+            if (!_UpdateImagesForDataChange(changed_attributes[i], previous_data[i]))
+            {
+                return GL_FALSE;
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    // sets the given control points of the patch and the ones of its joined neighbours that they determine, the
+    // changed patches are collected together with their previous control points
+    GLvoid BicubicCompositeSurface3::_SetPointsRecursively(
+            PatchAttributes *attribute, const std::vector<PointUpdate> &points,
+            std::vector<PatchAttributes*> &changed_attributes, std::vector<Matrix<DCoordinate3> > &previous_data)
+    {
         std::vector<PointUpdate> neighbour_points[8];
-        GLuint i, j;
         attribute->updated = true;
 
+        // the images are updated by the differences of the old and new control points
+        Matrix<DCoordinate3> data(4, 4);
+        for (GLuint i = 0; i <= 3; ++i)
+        {
+            for (GLuint j = 0; j <= 3; ++j)
+            {
+                data(i, j) = (*attribute->patch)(i, j);
+            }
+        }
+
+        changed_attributes.push_back(attribute);
+        previous_data.push_back(data);
+
+        _SetPointsAndCollectNeighbourUpdates(attribute, points, neighbour_points);
+
+        for (GLuint i = 0; i < 8; i++)
+        {
+            if (attribute->neighbours[i] && neighbour_points[i].size() > 0)
+            {
+                _SetPointsRecursively(attribute->neighbours[i], neighbour_points[i], changed_attributes, previous_data);
+            }
+        }
+    }
+
+    // the patch depends linearly on its control points, therefore the image and the iso-lines are updated
+    // in place by rank-one corrections of the moved control points, and only the changed vertices are
+    // uploaded again; everything is regenerated if the incremental update is not possible
+    GLboolean BicubicCompositeSurface3::_UpdateImagesForDataChange(PatchAttributes *attribute, const Matrix<DCoordinate3> &previous_data)
+    {
+        // the quadtrees of adaptive images depend on the shape of the patches, thus they are rebuilt
+        if (_adaptive_tessellation || !attribute->image || !attribute->u_lines || !attribute->v_lines)
+        {
+            return UpdateVBOs(attribute);
+        }
+
+        if (!attribute->patch->UpdateVertexBufferObjectsOfData())
+        {
+            throw Exception("Could not update the VBO of data of the patch!");
+        }
+
+        // the partial derivatives at the vertices are needed by the updates of the normal vectors, the first
+        // incremental update of the image regenerates it together with them, as well as the first one that
+        // changes the resolution of the image; this happens in double precision also in preview mode, since
+        // the following moves of a drag are cheaper by the rank-one updates than by any regeneration (see the
+        // check "preview" of Test/Checks), previews are only generated by UpdateVBOs
+        GLuint u_div_point_count, v_div_point_count;
+        _GetImageResolution(attribute, u_div_point_count, v_div_point_count);
+
+        GLboolean image_is_regenerated = attribute->partials.IsEmpty() ||
+                u_div_point_count != attribute->u_div_point_count || v_div_point_count != attribute->v_div_point_count;
+
+        if (image_is_regenerated)
+        {
+            attribute->u_div_point_count = u_div_point_count;
+            attribute->v_div_point_count = v_div_point_count;
+
+            TriangulatedMesh3 *image = attribute->patch->GenerateImageWithPartialDerivatives(
+                    u_div_point_count, v_div_point_count, attribute->partials);
+
+            if (!image)
+            {
+                throw Exception("Could not generate the image of patch!");
+            }
+
+            delete attribute->image;
+            attribute->image = image;
+            attribute->image_is_preview = GL_FALSE;
+
+            if (!attribute->image->UpdateVertexBufferObjects())
+            {
+                throw Exception("Could not update the VBO of patch image");
+            }
+        }
+
+        // index range of the changed vertices
+        GLuint first_changed_vertex = 0, last_changed_vertex = 0;
+
+        for (GLuint i = 0; i <= 3; ++i)
+        {
+            for (GLuint j = 0; j <= 3; ++j)
+            {
+                DCoordinate3 delta = (*attribute->patch)(i, j) - previous_data(i, j);
+
+                if (delta[0] == 0.0 && delta[1] == 0.0 && delta[2] == 0.0)
+                {
+                    continue;
+                }
+
+                if (!attribute->patch->UpdateIsoparametricLinesForDataChange(0, i, j, delta, *attribute->u_lines) ||
+                    !attribute->patch->UpdateIsoparametricLinesForDataChange(1, i, j, delta, *attribute->v_lines))
+                {
+                    return UpdateVBOs(attribute);
+                }
+
+                if (image_is_regenerated)
+                {
+                    continue;
+                }
+
+                GLuint first_vertex, vertex_count;
+
+                if (!attribute->patch->UpdateImageForDataChange(
+                        i, j, delta, *attribute->image, attribute->partials, first_vertex, vertex_count))
+                {
+                    return UpdateVBOs(attribute);
+                }
+
+                if (vertex_count)
+                {
+                    if (first_changed_vertex == last_changed_vertex)
+                    {
+                        first_changed_vertex = first_vertex;
+                        last_changed_vertex = first_vertex + vertex_count;
+                    }
+                    else
+                    {
+                        first_changed_vertex = min(first_changed_vertex, first_vertex);
+                        last_changed_vertex = max(last_changed_vertex, first_vertex + vertex_count);
+                    }
+                }
+            }
+        }
+
+        if (!attribute->image->UpdateVertexBufferObjectsOfGeometry(first_changed_vertex, last_changed_vertex - first_changed_vertex))
+        {
+            throw Exception("Could not update the VBO of patch image");
+        }
+
+        RowMatrix<GenericCurve3*>* lines[2] = {attribute->u_lines, attribute->v_lines};
+
+        for (GLuint l = 0; l < 2; ++l)
+        {
+            for (GLuint i = 0; i < lines[l]->GetColumnCount(); ++i)
+            {
+                if ((*lines[l])[i] && !(*lines[l])[i]->UpdateVertexBufferObjectsInPlace())
+                {
+                    throw Exception("Could not update the VBO of an iso-line");
+                }
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    // rebuilds the quadtree of the patch, refines the quadtrees of all patches until the breakpoints of joined
+    // ones match along their shared boundaries, then regenerates the image of the patch and those images whose
+    // quadtrees changed
+    GLboolean BicubicCompositeSurface3::_UpdateAdaptiveImages(PatchAttributes *attribute)
+    {
+        attribute->adaptive_tree = RestrictedQuadtree(_maximum_tessellation_level);
+        attribute->adaptive_tree.Build(BicubicBezierPatch::SubdivisionCriterion(
+                *attribute->patch, _chord_tolerance, _angular_tolerance));
+
+        std::vector<PatchAttributes*> attributes(_attributes);
+        if (IndexOfAttribute(attribute) < 0)
+        {
+            attributes.push_back(attribute);
+        }
+
+        std::map<const PatchAttributes*, GLuint> indexes;
+        std::vector<RestrictedQuadtree> trees;
+        trees.reserve(attributes.size());
+
+        for (GLuint i = 0; i < attributes.size(); ++i)
+        {
+            indexes[attributes[i]] = i;
+            trees.push_back(attributes[i]->adaptive_tree);
+        }
+
+        // inserting breakpoints may add further ones due to balancing, thus the boundaries are matched until
+        // none of the quadtrees changes
+        static const Direction directions[4] = {N, W, S, E};
+
+        GLuint resolution = RestrictedQuadtree(_maximum_tessellation_level).GetResolution();
+        std::vector<GLuint> positions;
+        GLboolean changed;
+
+        do
+        {
+            changed = GL_FALSE;
+
+            for (GLuint i = 0; i < attributes.size(); ++i)
+            {
+                for (GLuint k = 0; k < 4; ++k)
+                {
+                    RestrictedQuadtree::Side side, neighbourSide;
+                    GLboolean reversed;
+
+                    if (!attributes[i]->_GetSharedBoundary(directions[k], side, neighbourSide, reversed))
+                    {
+                        continue;
+                    }
+
+                    std::map<const PatchAttributes*, GLuint>::const_iterator neighbour =
+                            indexes.find(attributes[i]->neighbours[directions[k]]);
+
+                    if (neighbour == indexes.end())
+                    {
+                        continue;
+                    }
+
+                    trees[neighbour->second].GetBoundaryBreakpoints(neighbourSide, positions);
+
+                    for (GLuint p = 0; p < positions.size(); ++p)
+                    {
+                        if (trees[i].InsertBoundaryBreakpoint(side, reversed ? resolution - positions[p] : positions[p]))
+                        {
+                            changed = GL_TRUE;
+                        }
+                    }
+                }
+            }
+        }
+        while (changed);
+
+        for (GLuint i = 0; i < attributes.size(); ++i)
+        {
+            PatchAttributes *current = attributes[i];
+
+            if (current != attribute && current->image && current->matched_tree == trees[i])
+            {
+                continue;
+            }
+
+            current->matched_tree = trees[i];
+
+            TriangulatedMesh3 *image = current->patch->GenerateAdaptiveImage(current->matched_tree);
+            if (!image)
+            {
+                throw Exception("Could not generate the image of patch!");
+            }
+
+            delete current->image;
+            current->image = image;
+            current->image_is_preview = GL_FALSE;
+            current->partials.Clear();
+
+            if (!current->image->UpdateVertexBufferObjects())
+            {
+                throw Exception("Could not update the VBO of patch image");
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    // sets the given control points of the patch and collects the control points of those joined
+    // patches that are not updated yet, which have to move in order to preserve continuity
+    GLvoid BicubicCompositeSurface3::_SetPointsAndCollectNeighbourUpdates(
+            PatchAttributes *attribute, const std::vector<PointUpdate> &points, std::vector<PointUpdate> neighbour_points[8])
+    {
+        PatchAttributes *neighbour;
+        GLuint i, j;
+
+        _InvalidateImageResolutions();
+
         for (auto it = points.begin(); it != points.end(); it++)
         {
             GLuint row = it->row;
@@ -883,37 +1485,162 @@ namespace cagd
                 neighbour_points[E].push_back(PointUpdate(i, j, 2 * position - (*attribute->patch)(row, 2)));
             }
         }
+    }
+
+    GLboolean BicubicCompositeSurface3::MovePatch(const GLuint patchIndex, const DCoordinate3 difference)
+    {
+        return TransformPatch(patchIndex, HomogeneousTransformation3::Translation(difference.x(), difference.y(), difference.z()));
+    }
+
+    GLboolean BicubicCompositeSurface3::TransformPatch(const GLuint patchIndex, const HomogeneousTransformation3 &transformation)
+    {
+        return TransformPatches(std::vector<GLuint>(1, patchIndex), transformation);
+    }
+
+    GLboolean BicubicCompositeSurface3::TransformPatches(const std::vector<GLuint> &patchIndexes, const HomogeneousTransformation3 &transformation)
+    {
+        if (!transformation.IsAffine())
+        {
+            cout << "Only affine transformations are supported!" << endl;
+            return GL_FALSE;
+        }
 
-        for (i = 0; i < 8; i++)
+        for (auto it = patchIndexes.begin(); it != patchIndexes.end(); it++)
         {
-            if (attribute->neighbours[i] && neighbour_points[i].size() > 0)
+            if (*it >= _attributes.size())
             {
-                UpdatePatch(attribute->neighbours[i], neighbour_points[i]);
+                cout << "Invalid patch index!" << endl;
+                return GL_FALSE;
             }
         }
 
-        return UpdateVBOs(attribute);
+        for (auto it = _attributes.begin(); it != _attributes.end(); it++)
+        {
+            (*it)->updated = false;
+        }
+
+        for (auto it = patchIndexes.begin(); it != patchIndexes.end(); it++)
+        {
+            _attributes[*it]->updated = true;
+        }
+
+        for (auto it = patchIndexes.begin(); it != patchIndexes.end(); it++)
+        {
+            if (!_attributes[*it]->patch->TransformData(transformation))
+            {
+                return GL_FALSE;
+            }
+        }
+
+        _InvalidateImageResolutions();
+
+        // joined patches outside of the group inherit some transformed control points, therefore they
+        // have to be re-evaluated; all control points are set before the first image is updated
+        std::vector<PatchAttributes*> changed_attributes;
+        std::vector<Matrix<DCoordinate3> > previous_data;
+
+        for (auto it = patchIndexes.begin(); it != patchIndexes.end(); it++)
+        {
+            PatchAttributes *attribute = _attributes[*it];
+
+            std::vector<PointUpdate> points;
+            for (GLuint i = 0; i <= 3; ++i)
+            {
+                for (GLuint j = 0; j <= 3; ++j)
+                {
+                    points.push_back(PointUpdate(i, j, (*attribute->patch)(i, j)));
+                }
+            }
+
+            std::vector<PointUpdate> neighbour_points[8];
+            _SetPointsAndCollectNeighbourUpdates(attribute, points, neighbour_points);
+
+            for (GLuint i = 0; i < 8; i++)
+            {
+                if (attribute->neighbours[i] && !attribute->neighbours[i]->updated && neighbour_points[i].size() > 0)
+                {
+                    _SetPointsRecursively(attribute->neighbours[i], neighbour_points[i], changed_attributes, previous_data);
+                }
+            }
+        }
+
+        // Bezier patches are affine invariant, thus the cached images of the selected patches are
+        // transformed instead of being re-evaluated
+        for (auto it = patchIndexes.begin(); it != patchIndexes.end(); it++)
+        {
+            if (!_TransformImages(_attributes[*it], transformation))
+            {
+                return GL_FALSE;
+            }
+        }
+
+        for (GLuint i = 0; i < changed_attributes.size(); i++)
+        {
+            if (!_UpdateImagesForDataChange(changed_attributes[i], previous_data[i]))
+            {
+                return GL_FALSE;
+            }
+        }
+
+        return _MatchImageResolutions();
     }
 
-    GLboolean BicubicCompositeSurface3::MovePatch(const GLuint patchIndex, const DCoordinate3 difference)
+    // transforms the image, the iso-lines and their vertex buffer objects of a patch, the control net of which has
+    // already been transformed; the unit normal vectors of the image are transformed by the inverse transpose of
+    // the linear part of the transformation
+    GLboolean BicubicCompositeSurface3::_TransformImages(PatchAttributes *attribute, const HomogeneousTransformation3 &transformation)
     {
-        if (patchIndex >= _attributes.size())
+        if (!attribute->image || !attribute->u_lines || !attribute->v_lines)
         {
-            cout << "Invalid patch index!" << endl;
-            return GL_FALSE;
+            return UpdateVBOs(attribute);
         }
 
-        PatchAttributes *attribute = _attributes[patchIndex];
+        // scaling may change the resolution that guarantees the maximum deviation
+        if (!_adaptive_tessellation && _maximum_deviation > 0.0)
+        {
+            GLuint u_div_point_count, v_div_point_count;
+            _GetImageResolution(attribute, u_div_point_count, v_div_point_count);
+
+            if (u_div_point_count != attribute->u_div_point_count || v_div_point_count != attribute->v_div_point_count)
+            {
+                return UpdateVBOs(attribute);
+            }
+        }
+
+        if (!attribute->patch->UpdateVertexBufferObjectsOfData())
+        {
+            throw Exception("Could not update the VBO of data of the patch!");
+        }
+
+        // the partial derivatives at the vertices are regenerated by the next incremental update
+        attribute->partials.Clear();
+
+        if (!attribute->image->Transform(transformation))
+        {
+            // the linear part is singular, the normal vectors have to be recalculated
+            return UpdateVBOs(attribute);
+        }
+
+        if (!attribute->image->UpdateVertexBufferObjectsOfGeometry())
+        {
+            throw Exception("Could not update the VBO of patch image");
+        }
+
+        RowMatrix<GenericCurve3*>* lines[2] = {attribute->u_lines, attribute->v_lines};
 
-        for (GLuint i=0; i<=3; ++i)
+        for (GLuint l = 0; l < 2; ++l)
         {
-            for (GLuint j=0; j<=3; ++j)
+            for (GLuint i = 0; i < lines[l]->GetColumnCount(); ++i)
             {
-                (*attribute->patch)(i, j) += difference;
+                if ((*lines[l])[i])
+                {
+                    (*lines[l])[i]->Transform(transformation);
+                    (*lines[l])[i]->UpdateVertexBufferObjects();
+                }
             }
         }
 
-        return UpdateVBOs(attribute);
+        return GL_TRUE;
     }
 
     GLboolean BicubicCompositeSurface3::ContinueExistingPatch(const GLuint &patchIndex, Direction direction)
@@ -934,6 +1661,7 @@ namespace cagd
 
         PatchAttributes* newAttribute = new PatchAttributes;
         _attributes.push_back(newAttribute);
+        _InvalidateImageResolutions();
 
         newAttribute->patch = new BicubicBezierPatch();
         BicubicBezierPatch* patch = newAttribute->patch;
@@ -1035,7 +1763,10 @@ namespace cagd
             attribute->neighbours[E] = newAttribute;
             newAttribute->neighbours[W] = attribute;
         }
-        return UpdateVBOs(newAttribute);
+        // the control points were set after the resolutions might have been calculated
+        _InvalidateImageResolutions();
+
+        return UpdateVBOs(newAttribute) && _MatchImageResolutions();
     }
 
     // TODO: szomszédokat bekötni
@@ -1058,6 +1789,7 @@ namespace cagd
 
         PatchAttributes *newAttribute = new PatchAttributes;
         _attributes.push_back(newAttribute);
+        _InvalidateImageResolutions();
 
         newAttribute->patch = new BicubicBezierPatch();
 
@@ -1205,7 +1937,10 @@ namespace cagd
         }
         secondAttribute->neighbours[secondDirection] = newAttribute;
 
-        return UpdateVBOs(newAttribute);
+        // the control points were set after the resolutions might have been calculated
+        _InvalidateImageResolutions();
+
+        return UpdateVBOs(newAttribute) && _MatchImageResolutions();
     }
 
     GLboolean BicubicCompositeSurface3::MergeExistingPatches(const GLuint &firstPatchIndex, Direction firstDirection, const GLuint &secondPatchIndex, Direction secondDirection)
@@ -1227,6 +1962,7 @@ namespace cagd
 
         firstAttribute->neighbours[firstDirection] = secondAttribute;
         secondAttribute->neighbours[secondDirection] = firstAttribute;
+        _InvalidateImageResolutions();
 
         if (firstDirection == N && secondDirection == N)
         {
@@ -1973,7 +2709,10 @@ namespace cagd
             break;
         }
 
-        return UpdateVBOs(firstAttribute) && UpdateVBOs(secondAttribute);
+        // the control points were set after the resolutions might have been calculated
+        _InvalidateImageResolutions();
+
+        return UpdateVBOs(firstAttribute) && UpdateVBOs(secondAttribute) && _MatchImageResolutions();
     }
 
     std::ostream& operator <<(std::ostream& lhs, const BicubicCompositeSurface3& surface)
@@ -2015,8 +2754,6 @@ namespace cagd
 
             attribute->patch = new BicubicBezierPatch();
             lhs >> *attribute->patch;
-
-            surface.UpdateVBOs(attribute);
         }
 
         GLint index;
@@ -2036,6 +2773,14 @@ namespace cagd
             }
         }
 
+        // the images are generated after the patches have been joined, thus the resolutions are calculated once
+        surface._InvalidateImageResolutions();
+
+        for (GLuint i=0; i<n; ++i)
+        {
+            surface.UpdateVBOs(surface._attributes[i]);
+        }
+
         return lhs;
     }
 
@@ -5,6 +5,7 @@
 #include "BicubicBezierPatches.h"
 #include <Core/ShaderPrograms.h>
 #include <QOpenGLTexture>
+#include <map>
 
 namespace cagd
 {
@@ -35,7 +36,27 @@ namespace cagd
             RowMatrix<GenericCurve3*>* u_lines;
             RowMatrix<GenericCurve3*>* v_lines;
 
+            // resolution of the uniform image
+            GLuint u_div_point_count, v_div_point_count;
+
+            // whether the image was generated in single precision during interactive editing
+            GLboolean image_is_preview;
+
+            // partial derivatives at the vertices of the image, generated on demand for incremental updates
+            TensorProductSurface3::ImagePartialDerivatives partials;
+
+            // adaptive tessellations: the quadtree that is refined by the subdivision criterion of the patch, and
+            // the one of the image, which is refined further along the boundaries shared with joined patches
+            RestrictedQuadtree adaptive_tree, matched_tree;
+
             void _GetSymmetricPointIndexes(const GLuint row, const GLuint column, Direction direction, GLuint &symmetricRow, GLuint &symmetricColumn) const;
+
+            // the sides of the unit square along which the patch and its neighbour in the given direction are joined,
+            // and whether their boundary parameters run in opposite directions; fails if they do not share a boundary
+            GLboolean _GetSharedBoundary(Direction direction, RestrictedQuadtree::Side &side, RestrictedQuadtree::Side &neighbourSide, GLboolean &reversed) const;
+            // deletes the isoparametric lines together with their VBOs
+            void _DeleteIsoparametricLines();
+
             PatchAttributes();
             PatchAttributes(const PatchAttributes &attributes);
             ~PatchAttributes();
@@ -59,8 +80,35 @@ namespace cagd
         GLuint _u_iso_line_count;
         GLuint _v_iso_line_count;
 
+        // parameters of adaptive tessellations (see SetAdaptiveTessellation)
+        GLboolean _adaptive_tessellation;
+        GLdouble  _chord_tolerance, _angular_tolerance;
+        GLuint    _maximum_tessellation_level;
+
+        // uniform images are generated at the resolution that is needed by this chordal error, if it is positive
+        GLdouble  _maximum_deviation;
+
+        // uniform images are generated by TensorProductSurface3::GeneratePreviewImage while it is set
+        GLboolean _interactive_preview;
+
+        // resolutions of the uniform images and indexes of the patches (see _UpdateImageResolutions), they are
+        // recalculated only after the control points, the maximum deviation, the iso-line counts or the joins changed
+        mutable GLboolean                                _image_resolutions_are_valid;
+        mutable std::vector<GLuint>                      _u_div_point_counts, _v_div_point_counts;
+        mutable std::map<const PatchAttributes*, GLuint> _attribute_indexes;
+
     private:
         GLvoid   _loadTextures();
+        GLvoid   _SetPointsAndCollectNeighbourUpdates(PatchAttributes *attribute, const std::vector<PointUpdate> &points, std::vector<PointUpdate> neighbour_points[8]);
+        GLvoid    _SetPointsRecursively(PatchAttributes *attribute, const std::vector<PointUpdate> &points,
+                                        std::vector<PatchAttributes*> &changed_attributes, std::vector<Matrix<DCoordinate3> > &previous_data);
+        GLboolean _TransformImages(PatchAttributes *attribute, const HomogeneousTransformation3 &transformation);
+        GLboolean _UpdateImagesForDataChange(PatchAttributes *attribute, const Matrix<DCoordinate3> &previous_data);
+        GLboolean _UpdateAdaptiveImages(PatchAttributes *attribute);
+        GLvoid    _GetImageResolution(const PatchAttributes *attribute, GLuint &u_div_point_count, GLuint &v_div_point_count) const;
+        GLvoid    _UpdateImageResolutions() const;
+        GLvoid    _InvalidateImageResolutions();
+        GLboolean _MatchImageResolutions();
 
     public:
         // special/default ctor
@@ -82,6 +130,11 @@ namespace cagd
         GLboolean UpdatePatch(PatchAttributes *attribute, std::vector<PointUpdate> points);
         GLboolean MovePatch(const GLuint patchIndex, const DCoordinate3 difference);
 
+        // affine transformations of whole patches, the cached images are transformed instead of being
+        // re-evaluated (only joined patches outside of the group are re-evaluated)
+        GLboolean TransformPatch(const GLuint patchIndex, const HomogeneousTransformation3 &transformation);
+        GLboolean TransformPatches(const std::vector<GLuint> &patchIndexes, const HomogeneousTransformation3 &transformation);
+
         GLboolean RenderAllPatchesWithMaterials();
         GLboolean RenderAllPatchesWithTextures();
         GLboolean RenderAllPatchesIsoU() const;
@@ -108,6 +161,24 @@ namespace cagd
         GLvoid UpdateUIsoLines(GLuint iso_line_count);
         GLvoid UpdateVIsoLines(GLuint iso_line_count);
 
+        // by default the images are uniform grids of the same size as the iso-line counts; adaptive images triangulate
+        // restricted quadtrees that are refined by BicubicBezierPatch::SubdivisionCriterion up to the maximum level,
+        // and the quadtrees of joined patches are refined until their breakpoints match along the shared boundaries,
+        // thus the network of images stays crack-free; all images are regenerated
+        GLvoid    SetAdaptiveTessellation(GLboolean enabled, GLdouble chord_tolerance = 1.0e-3, GLdouble angular_tolerance = 0.1, GLuint maximum_level = 6);
+        GLboolean IsTessellationAdaptive() const;
+
+        // if the maximum deviation is positive, each uniform image is generated at its own resolution, the smallest one
+        // that guarantees the given chordal error (see TensorProductSurface3::UniformResolutionForChordalError),
+        // otherwise the div point counts are the iso-line counts; all images are regenerated
+        GLvoid    SetMaximumDeviation(GLdouble maximum_deviation);
+        GLdouble  GetMaximumDeviation() const;
+
+        // while the interactive preview is enabled (e.g., while a control point is dragged), the uniform images that
+        // have to be rebuilt by UpdateVBOs are generated in single precision, whereas moved control points are still
+        // applied by incremental updates; disabling it regenerates the previewed images in double precision
+        GLvoid    SetInteractivePreview(GLboolean enabled);
+
         int MouseOnPatch(DCoordinate3 mC);
         GLboolean MouseOnCP(int selectedPatch, DCoordinate3 mC, int &cpX, int &cpY);
         void      moveToMouse(int patchInd, int cpX, int cpY, DCoordinate3 mC, GLdouble& x, GLdouble& y);
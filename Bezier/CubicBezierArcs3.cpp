@@ -1,6 +1,21 @@
 #include "CubicBezierArcs3.h"
+#include "CubicForwardDifferences.h"
 
 namespace cagd {
+    // the r-th row stores the r-th order derivatives of the cubic Bernstein polynomials at t in [0, 1]
+    GLboolean CubicBernsteinDerivatives(GLuint maximum_order_of_derivatives, GLdouble t, Matrix<GLdouble>& derivatives)
+    {
+        if (t < 0.0 || t > 1.0)
+        {
+            return GL_FALSE;
+        }
+
+        derivatives.ResizeRows(maximum_order_of_derivatives + 1);
+        derivatives.ResizeColumns(4);
+
+        return CubicBernsteinDerivatives<Matrix<GLdouble> >(maximum_order_of_derivatives, t, derivatives);
+    }
+
     CubicBezierArc3::CubicBezierArc3(GLenum data_usage_flag):
         LinearCombination3(0.0, 1.0, 4, data_usage_flag)
     {
@@ -11,16 +26,7 @@ namespace cagd {
         if (u < _u_min || u > _u_max)
             return GL_FALSE;
 
-        values.ResizeColumns(4);
-
-        GLdouble u2 = u * u, u3 = u2 * u;
-
-        values[0] = 1 - 3 * u + 3 * u2 - u3;
-        values[1] = 3 * u - 6 * u2 + 3 * u3;
-        values[2] = 3 * u2 - 3 * u3;
-        values[3] = u3;
-
-        return GL_TRUE;
+        return CubicBernsteinDerivatives(0, u, static_cast<Matrix<GLdouble>&>(values));
     }
 
     GLboolean CubicBezierArc3::CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u, Derivatives &d) const
@@ -33,27 +39,54 @@ namespace cagd {
         d.ResizeRows(max_order_of_derivatives + 1);
         d.LoadNullVectors();
 
-        GLdouble u2 = u * u, u3 = u2 * u;
+        // the r-th row stores the r-th order derivatives of the cubic Bernstein polynomials,
+        // the fixed-size matrix lives on the stack
+        Matrix<GLdouble, 3, 4> blending_values;
+        CubicBernsteinDerivatives(max_order_of_derivatives, u, blending_values);
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+        {
+            for (GLuint i = 0; i < 4; ++i)
+            {
+                d[r] += _data[i] * blending_values(r, i);
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    GLboolean CubicBezierArc3::BlendingFunctionDerivatives(GLuint max_order_of_derivatives, GLdouble u, Matrix<GLdouble> &derivatives) const
+    {
+        if (u < _u_min || u > _u_max)
+            return GL_FALSE;
+
+        return CubicBernsteinDerivatives(max_order_of_derivatives, u, derivatives);
+    }
 
-        d[0] += _data[0] * (1 - 3 * u + 3 * u2 - u3);
-        d[0] += _data[1] * (3 * u - 6 * u2 + 3 * u3);
-        d[0] += _data[2] * (3 * u2 - 3 * u3);
-        d[0] += _data[3] * u3;
+    GLboolean CubicBezierArc3::_EvaluateUniformly(GLuint max_order_of_derivatives, GLuint div_point_count, Matrix<DCoordinate3> &derivatives) const
+    {
+        // the Bernstein polynomials are evaluated in [0, 1], other domains are handled by the general method
+        if (max_order_of_derivatives > 2 || div_point_count < 2 || _u_min != 0.0 || _u_max != 1.0)
+        {
+            return GL_FALSE;
+        }
 
-        if (max_order_of_derivatives > 0)
+        if (!derivatives.ResizeRows(max_order_of_derivatives + 1) || !derivatives.ResizeColumns(div_point_count))
         {
-            d[1] += _data[0] * (-3 + 6 * u - 3 * u2);
-            d[1] += _data[1] * (3 - 12 * u + 9 * u2);
-            d[1] += _data[2] * (6 * u - 9 * u2);
-            d[1] += _data[3] * 3 * u2;
+            return GL_FALSE;
         }
 
-        if (max_order_of_derivatives > 1)
+        CubicForwardDifferences arc(_data[0], _data[1], _data[2], _data[3], div_point_count);
+
+        for (GLuint k = 0; k < div_point_count; ++k, arc.Advance())
         {
-            d[2] += _data[0] * (6 - 6 * u);
-            d[2] += _data[1] * (-12 + 18 * u);
-            d[2] += _data[2] * (6 - 18 * u);
-            d[2] += _data[3] * 6 * u;
+            derivatives(0, k) = arc.Point();
+
+            if (max_order_of_derivatives >= 1)
+                derivatives(1, k) = arc.FirstDerivative();
+
+            if (max_order_of_derivatives >= 2)
+                derivatives(2, k) = arc.SecondDerivative();
         }
 
         return GL_TRUE;
@@ -4,7 +4,70 @@
 
 namespace cagd {
 
+    // the r-th row stores the r-th order derivatives of the cubic Bernstein polynomials at t in [0, 1]
+    GLboolean CubicBernsteinDerivatives(GLuint maximum_order_of_derivatives, GLdouble t, Matrix<GLdouble>& derivatives);
+
+    // the same values, stored in any matrix of at least maximum_order_of_derivatives + 1 rows and 4 columns, which is
+    // not resized (e.g., in a fixed-size Matrix<GLdouble, 3, 4> by evaluators that must not allocate memory)
+    template <class Derivatives>
+    GLboolean CubicBernsteinDerivatives(GLuint maximum_order_of_derivatives, GLdouble t, Derivatives& derivatives)
+    {
+        if (t < 0.0 || t > 1.0)
+        {
+            return GL_FALSE;
+        }
+
+        GLdouble t2 = t * t, t3 = t2 * t, w = 1.0 - t, w2 = w * w, w3 = w2 * w;
+
+        for (GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+        {
+            switch (r)
+            {
+            case 0:
+                derivatives(0, 0) = w3;
+                derivatives(0, 1) = 3.0 * w2 * t;
+                derivatives(0, 2) = 3.0 * w * t2;
+                derivatives(0, 3) = t3;
+                break;
+
+            case 1:
+                derivatives(1, 0) = -3.0 * w2;
+                derivatives(1, 1) = -6.0 * w * t + 3.0 * w2;
+                derivatives(1, 2) = -3.0 * t2 + 6.0 * w * t;
+                derivatives(1, 3) = 3.0 * t2;
+                break;
+
+            case 2:
+                derivatives(2, 0) = 6.0 * w;
+                derivatives(2, 1) = 6.0 * t - 12.0 * w;
+                derivatives(2, 2) = 6.0 * w - 12.0 * t;
+                derivatives(2, 3) = 6.0 * t;
+                break;
+
+            case 3:
+                derivatives(3, 0) = -6.0;
+                derivatives(3, 1) = 18.0;
+                derivatives(3, 2) = -18.0;
+                derivatives(3, 3) = 6.0;
+                break;
+
+            default:
+                for (GLuint i = 0; i < 4; i++)
+                {
+                    derivatives(r, i) = 0.0;
+                }
+                break;
+            }
+        }
+
+        return GL_TRUE;
+    }
+
     class CubicBezierArc3: public LinearCombination3 {
+    protected:
+        // points, first and second order derivatives along the uniform subdivision of [0, 1] by forward differencing
+        GLboolean _EvaluateUniformly(GLuint max_order_of_derivatives, GLuint div_point_count, Matrix<DCoordinate3> &derivatives) const;
+
     public:
         // special constructor
         CubicBezierArc3(GLenum data_usage_flag = GL_STATIC_DRAW);
@@ -13,6 +76,9 @@ namespace cagd {
         GLboolean BlendingFunctionValues(GLdouble u, RowMatrix<GLdouble>& values) const;
         GLboolean CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u, Derivatives &d) const;
 
+        // tables of blending function derivatives of arbitrary order
+        GLboolean BlendingFunctionDerivatives(GLuint max_order_of_derivatives, GLdouble u, Matrix<GLdouble> &derivatives) const;
+
         GLboolean GetData(GLuint index, DCoordinate3& data) const;
     };
 
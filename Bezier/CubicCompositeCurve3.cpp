@@ -1,5 +1,7 @@
 #include "CubicCompositeCurve3.h"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <QRandomGenerator>
 
 using namespace std;
@@ -89,7 +91,9 @@ namespace cagd {
     }
 
     CubicCompositeCurve3::CubicCompositeCurve3(GLuint arcCount):
-       _div_point_count(100)
+       _div_point_count(100),
+       _hierarchy_is_valid(GL_FALSE),
+       _arcLengthsAreValid(GL_FALSE)
     {
         _attributes.reserve(100);
         for (GLuint i = 0; i < arcCount; i++)
@@ -132,6 +136,8 @@ namespace cagd {
             _attributes.back().arc = InitializeArc();
             _attributes.back().image = _attributes.back().arc -> GenerateImage(2, _div_point_count);
             _attributes.back().image -> UpdateVertexBufferObjects();
+            _hierarchy_is_valid = GL_FALSE;
+            _arcLengthsAreValid = GL_FALSE;
             return GL_TRUE;
         }  catch (Exception e) {
             cout << "Error in inserting a new arc!" << endl;
@@ -152,6 +158,8 @@ namespace cagd {
 
         ArcAttributes* attribute = &_attributes[arcIndex];
 
+        _arcLengthsAreValid = GL_FALSE;
+
         DCoordinate3 difference = (*attribute->arc)[pointIndex] - position;
 
         (*attribute->arc)[pointIndex] = position;
@@ -262,12 +270,28 @@ namespace cagd {
             throw Exception("Could not update the VBO of arc image");
         }
 
+        // the neighbors are stored by the same vector, their indices follow from the addresses
+        _RefitArc(arcIndex);
+
+        if (attribute->previous)
+        {
+            _RefitArc(static_cast<GLuint>(attribute->previous - _attributes.data()));
+        }
+
+        if (attribute->next)
+        {
+            _RefitArc(static_cast<GLuint>(attribute->next - _attributes.data()));
+        }
+
         return GL_TRUE;
     }
 
     GLboolean CubicCompositeCurve3::UpdateImageOfArc(const GLuint arcIndex)
     {
         ArcAttributes* attribute = &_attributes[arcIndex];
+
+        _arcLengthsAreValid = GL_FALSE;
+
         if (!attribute->arc->UpdateVertexBufferObjectsOfData())
         {
             return GL_FALSE;
@@ -279,6 +303,8 @@ namespace cagd {
             return GL_FALSE;
         }
 
+        _RefitArc(arcIndex);
+
         return GL_TRUE;
     }
 
@@ -292,34 +318,9 @@ namespace cagd {
 
     int CubicCompositeCurve3::mouseOnCurve(DCoordinate3 mC)
     {
-        int clickedArc = -1;
         GLdouble minDist = 0.1;
-        GLdouble x = mC.x();
-        GLdouble y = mC.y();
-        for (GLuint j = 0; j < _attributes.size(); j++)
-        {
-            ArcAttributes* it = &_attributes[j];
-            if (it ->image)
-            {
-                DCoordinate3 c;
-                GLuint pointCount;
-                pointCount = it -> image -> GetPointCount();
-                for (GLuint i = 0; i < pointCount; i++)
-                {
-                    it -> image -> GetDerivative(0, i, c);
-                    GLdouble tX = c.x();
-                    GLdouble tY = c.y();
-                    GLdouble tZ = c.z();
-                    GLdouble distance = (x - tX) * (x - tX) + (y - tY) * (y - tY) + tZ * tZ;
-                    if (distance < minDist){
-                        minDist = distance;
-                        clickedArc = j;
-                    }
-                }
-            }
-        }
 
-        return clickedArc;
+        return NearestArc(DCoordinate3(mC.x(), mC.y(), 0.0), minDist);
     }
 
     int CubicCompositeCurve3::mouseOnCP(int arcInd, DCoordinate3 mC)
@@ -369,31 +370,15 @@ namespace cagd {
 
     GLboolean CubicCompositeCurve3::mouseNotOnCurveOnCP(DCoordinate3 mC, int &arcInd, int &cp)
     {
+        // the line through the eye (0, 0, 5) and the mouse position on the plane z = 0
         GLdouble minDist = 0.1;
-        GLdouble x0 = mC.x();
-        GLdouble y0 = mC.y();
-        for (GLuint j = 0; j < _attributes.size(); j++)
-        {
-            ArcAttributes* selectedArc = &_attributes[j];
-            DCoordinate3 c;
-            cout<<"Tavolsagok az egyenestol\n";
-            for (GLuint i = 0; i < 4; i++)
-            {
-                selectedArc -> arc -> GetData(i, c);
-                GLdouble x1 = c.x();
-                GLdouble y1 = c.y();
-                GLdouble z1 = c.z();
-                GLdouble a = 5*y1 + y0*z1-5*y0;
-                GLdouble b = 5*x0-5*x1-x0*z1;
-                GLdouble c = x0*y1-x1*y0;
-                GLdouble distance = (a*a+b*b+c*c)/(x0*x0+y0*y0+25);
-                cout << a << ' ' << b << ' ' << c << ' ' << distance << endl;
-                if (distance < minDist){
-                    minDist = distance;
-                    arcInd = j;
-                    cp = i;
-                }
-            }
+        GLint    selectedArc, selectedCP;
+
+        if (NearestControlPointToLine(DCoordinate3(0.0, 0.0, 5.0), DCoordinate3(mC.x(), mC.y(), -5.0),
+                                      selectedArc, selectedCP, minDist))
+        {
+            arcInd = selectedArc;
+            cp = selectedCP;
         }
 
         return GL_TRUE;
@@ -427,6 +412,8 @@ namespace cagd {
 
         ArcAttributes attribute;
         _attributes.push_back(attribute);
+        _hierarchy_is_valid = GL_FALSE;
+        _arcLengthsAreValid = GL_FALSE;
 
         ArcAttributes &connectingAttribute = _attributes.back();
 
@@ -508,6 +495,8 @@ namespace cagd {
             return GL_FALSE;
         }
 
+        _arcLengthsAreValid = GL_FALSE;
+
         if (firstDirection == LEFT && secondDirection == LEFT)
         {
             (*firstAttribute.arc)[0] = (*secondAttribute.arc)[0] = 0.5 * ((*firstAttribute.arc)[1] + (*secondAttribute.arc)[1]);
@@ -562,6 +551,9 @@ namespace cagd {
             throw Exception("Could not update the VBO of arc image");
         }
 
+        _RefitArc(firstArcIndex);
+        _RefitArc(secondArcIndex);
+
         return GL_TRUE;
     }
 
@@ -584,6 +576,8 @@ namespace cagd {
 
         ArcAttributes newAttr;
         _attributes.push_back(newAttr);
+        _hierarchy_is_valid = GL_FALSE;
+        _arcLengthsAreValid = GL_FALSE;
         ArcAttributes* newAttribute = &_attributes.back();
         attribute = &_attributes[arcIndex];
 
@@ -695,9 +689,13 @@ namespace cagd {
 
     GLboolean CubicCompositeCurve3::RenderAllData(GLuint selectedCurveInd, GLuint selectedPointInd)
     {
+        // read-only access, so that the arc length table of the arc remains valid
+        DCoordinate3 selectedPoint;
+        _attributes[selectedCurveInd].arc->GetData(selectedPointInd, selectedPoint);
+
         glPointSize(10.0f);
         glBegin(GL_POINTS);
-            glVertex3dv(&(*_attributes[selectedCurveInd].arc)[selectedPointInd][0]);
+            glVertex3dv(&selectedPoint[0]);
         glEnd();
         glPointSize(1.0f);
 
@@ -722,7 +720,8 @@ namespace cagd {
     GLboolean CubicCompositeCurve3::GetDataPointValues(
             const GLuint &arcInd, const GLuint &dataPointInd, GLdouble &x, GLdouble &y, GLdouble &z)
     {
-        DCoordinate3 dataPoint = (*_attributes[arcInd].arc)[dataPointInd];
+        DCoordinate3 dataPoint;
+        _attributes[arcInd].arc->GetData(dataPointInd, dataPoint);
         x = dataPoint.x();
         y = dataPoint.y();
         z = dataPoint.z();
@@ -732,7 +731,7 @@ namespace cagd {
     GLboolean CubicCompositeCurve3::GetDataPointValues(
             const GLuint &arcInd, const GLuint &dataPointInd, DCoordinate3 &p)
     {
-        p = (*_attributes[arcInd].arc)[dataPointInd];
+        _attributes[arcInd].arc->GetData(dataPointInd, p);
         return GL_TRUE;
     }
 
@@ -761,6 +760,292 @@ namespace cagd {
         return _attributes.size();
     }
 
+    GLdouble CubicCompositeCurve3::GetArcLength() const
+    {
+        _UpdateCumulativeArcLengths();
+
+        return _cumulativeArcLengths.empty() ? 0.0 : _cumulativeArcLengths.back();
+    }
+
+    GLboolean CubicCompositeCurve3::ParameterAtArcLength(GLdouble s, GLuint &arcInd, GLdouble &u) const
+    {
+        if (_attributes.empty())
+        {
+            return GL_FALSE;
+        }
+
+        _UpdateCumulativeArcLengths();
+
+        // the first arc whose end is not shorter than s, i.e., an arc length shared by two arcs belongs to the
+        // former one; lengths beyond the total length belong to the last arc
+        GLuint last = _attributes.size() - 1;
+
+        arcInd = std::lower_bound(_cumulativeArcLengths.begin(), _cumulativeArcLengths.begin() + last, s) -
+                 _cumulativeArcLengths.begin();
+
+        GLdouble offset = arcInd ? _cumulativeArcLengths[arcInd - 1] : 0.0;
+
+        u = _attributes[arcInd].arc->ParameterAtArcLength(s - offset);
+
+        return GL_TRUE;
+    }
+
+    GLboolean CubicCompositeCurve3::PointsAtUniformArcLengths(GLuint point_count, std::vector<DCoordinate3> &points) const
+    {
+        if (_attributes.empty() || point_count < 2)
+        {
+            return GL_FALSE;
+        }
+
+        _UpdateCumulativeArcLengths();
+
+        GLdouble total_length = _cumulativeArcLengths.back();
+
+        points.resize(point_count);
+
+        LinearCombination3::Derivatives d(0);
+        GLuint   arcInd = 0;
+        GLdouble offset = 0.0;   // total length of the arcs preceding arcInd
+
+        for (GLuint i = 0; i < point_count; i++)
+        {
+            GLdouble s = total_length * i / (point_count - 1);
+
+            // the arc lengths increase, thus the arcs are visited in a single pass
+            while (arcInd + 1 < _attributes.size() && s > _cumulativeArcLengths[arcInd])
+            {
+                offset = _cumulativeArcLengths[arcInd];
+                arcInd++;
+            }
+
+            const CubicBezierArc3 *arc = _attributes[arcInd].arc;
+
+            if (!arc->CalculateDerivatives(0, arc->ParameterAtArcLength(s - offset), d))
+            {
+                return GL_FALSE;
+            }
+
+            points[i] = d[0];
+        }
+
+        return GL_TRUE;
+    }
+
+    GLvoid CubicCompositeCurve3::_UpdateCumulativeArcLengths() const
+    {
+        if (_arcLengthsAreValid && _cumulativeArcLengths.size() == _attributes.size())
+        {
+            return;
+        }
+
+        _cumulativeArcLengths.resize(_attributes.size());
+
+        GLdouble length = 0.0;
+
+        for (GLuint i = 0; i < _attributes.size(); i++)
+        {
+            length += _attributes[i].arc->GetArcLength();
+            _cumulativeArcLengths[i] = length;
+        }
+
+        _arcLengthsAreValid = GL_TRUE;
+    }
+
+    BoundingBox3 CubicCompositeCurve3::_BoundingBoxOfArc(GLuint arcInd) const
+    {
+        BoundingBox3 box;
+        const CubicBezierArc3 &arc = *_attributes[arcInd].arc;
+
+        for (GLuint i = 0; i < 4; i++)
+        {
+            box.Enclose(arc[i]);
+        }
+
+        return box;
+    }
+
+    GLvoid CubicCompositeCurve3::_RefitArc(GLuint arcInd)
+    {
+        if (_hierarchy_is_valid && arcInd < _hierarchy.GetPrimitiveCount())
+        {
+            _hierarchy.Refit(arcInd, _BoundingBoxOfArc(arcInd));
+        }
+        else
+        {
+            _hierarchy_is_valid = GL_FALSE;
+        }
+    }
+
+    GLvoid CubicCompositeCurve3::_UpdateHierarchy()
+    {
+        if (_hierarchy_is_valid && _hierarchy.GetPrimitiveCount() == _attributes.size())
+        {
+            return;
+        }
+
+        std::vector<BoundingBox3> boxes(_attributes.size());
+
+        for (GLuint i = 0; i < _attributes.size(); i++)
+        {
+            boxes[i] = _BoundingBoxOfArc(i);
+        }
+
+        _hierarchy.Build(boxes);
+        _hierarchy_is_valid = GL_TRUE;
+    }
+
+    namespace
+    {
+        // squared distance of a point from the points of the images of the arcs
+        class ArcImageDistance
+        {
+        private:
+            const std::vector<CubicCompositeCurve3::ArcAttributes> &_attributes;
+            DCoordinate3                                             _point;
+
+        public:
+            ArcImageDistance(const std::vector<CubicCompositeCurve3::ArcAttributes> &attributes, const DCoordinate3 &point):
+                _attributes(attributes), _point(point)
+            {
+            }
+
+            GLdouble LowerBound(const BoundingBox3 &box) const
+            {
+                return box.SquaredDistance(_point);
+            }
+
+            GLdouble operator ()(GLuint arcInd) const
+            {
+                GLdouble result = std::numeric_limits<GLdouble>::max();
+                const GenericCurve3 *image = _attributes[arcInd].image;
+
+                if (image)
+                {
+                    DCoordinate3 c;
+
+                    for (GLuint i = 0; i < image->GetPointCount(); i++)
+                    {
+                        image->GetDerivative(0, i, c);
+
+                        DCoordinate3 difference = c - _point;
+                        result = std::min(result, difference * difference);
+                    }
+                }
+
+                return result;
+            }
+        };
+
+        // squared distance of a point or a line from the control points of the arcs
+        class ControlPointDistance
+        {
+        private:
+            const std::vector<CubicCompositeCurve3::ArcAttributes> &_attributes;
+            DCoordinate3                                             _origin, _direction;
+            GLboolean                                                _is_line;
+
+        public:
+            ControlPointDistance(
+                    const std::vector<CubicCompositeCurve3::ArcAttributes> &attributes,
+                    const DCoordinate3 &origin, const DCoordinate3 &direction, GLboolean is_line):
+                _attributes(attributes), _origin(origin), _direction(direction),
+                _is_line(is_line && direction * direction > 0.0)
+            {
+            }
+
+            GLdouble LowerBound(const BoundingBox3 &box) const
+            {
+                return _is_line ? box.SquaredDistanceLowerBound(_origin, _direction) : box.SquaredDistance(_origin);
+            }
+
+            GLdouble SquaredDistance(const DCoordinate3 &p) const
+            {
+                DCoordinate3 difference = p - _origin;
+
+                if (_is_line)
+                {
+                    DCoordinate3 cross = difference ^ _direction;
+                    return (cross * cross) / (_direction * _direction);
+                }
+
+                return difference * difference;
+            }
+
+            GLdouble operator ()(GLuint arcInd) const
+            {
+                GLint cpInd;
+                return Nearest(arcInd, cpInd);
+            }
+
+            GLdouble Nearest(GLuint arcInd, GLint &cpInd) const
+            {
+                const CubicBezierArc3 &arc = *_attributes[arcInd].arc;
+
+                GLdouble result = SquaredDistance(arc[0]);
+                cpInd = 0;
+
+                for (GLuint i = 1; i < 4; i++)
+                {
+                    GLdouble d = SquaredDistance(arc[i]);
+
+                    if (d < result)
+                    {
+                        result = d;
+                        cpInd = i;
+                    }
+                }
+
+                return result;
+            }
+        };
+    }
+
+    GLint CubicCompositeCurve3::NearestArc(const DCoordinate3 &point, GLdouble &squaredDistance)
+    {
+        _UpdateHierarchy();
+
+        return _hierarchy.Nearest(ArcImageDistance(_attributes, point), squaredDistance);
+    }
+
+    GLboolean CubicCompositeCurve3::NearestControlPoint(
+            const DCoordinate3 &point, GLint &arcInd, GLint &cpInd, GLdouble &squaredDistance)
+    {
+        _UpdateHierarchy();
+
+        ControlPointDistance distance(_attributes, point, DCoordinate3(), GL_FALSE);
+
+        arcInd = _hierarchy.Nearest(distance, squaredDistance);
+
+        if (arcInd < 0)
+        {
+            return GL_FALSE;
+        }
+
+        distance.Nearest(arcInd, cpInd);
+
+        return GL_TRUE;
+    }
+
+    GLboolean CubicCompositeCurve3::NearestControlPointToLine(
+            const DCoordinate3 &origin, const DCoordinate3 &direction,
+            GLint &arcInd, GLint &cpInd, GLdouble &squaredDistance)
+    {
+        _UpdateHierarchy();
+
+        ControlPointDistance distance(_attributes, origin, direction, GL_TRUE);
+
+        arcInd = _hierarchy.Nearest(distance, squaredDistance);
+
+        if (arcInd < 0)
+        {
+            return GL_FALSE;
+        }
+
+        distance.Nearest(arcInd, cpInd);
+
+        return GL_TRUE;
+    }
+
     std::ostream& operator << (std::ostream& lhs, const CubicCompositeCurve3& rhs)
     {
         lhs << rhs._div_point_count << endl;
@@ -791,6 +1076,8 @@ namespace cagd {
         lhs >> n;
 
         rhs._attributes.resize(n);
+        rhs._hierarchy_is_valid = GL_FALSE;
+        rhs._arcLengthsAreValid = GL_FALSE;
 
         // attributes
         for (auto it = rhs._attributes.begin(); it != rhs._attributes.end(); ++it)
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "CubicBezierArcs3.h"
+#include <Core/BoundingVolumeHierarchies.h>
 #include <Core/Colors4.h>
 #include <Core/Constants.h>
 #include <Core/Exceptions.h>
@@ -45,6 +46,24 @@ namespace cagd
         std::vector<Color4>        _colors{ darkRed, yellow, darkGreen, green, darkBlue, blue, purple, pink, orange, grey };
         GLuint _div_point_count;
 
+        // hierarchy of the bounding boxes of the control polygons, which contain the arcs by the convex hull
+        // property; it is refitted when the control points of an arc change and rebuilt lazily, at the first
+        // query after arcs have been inserted
+        BoundingVolumeHierarchy _hierarchy;
+        GLboolean               _hierarchy_is_valid;
+
+        BoundingBox3 _BoundingBoxOfArc(GLuint arcInd) const;
+        GLvoid       _RefitArc(GLuint arcInd);
+        GLvoid       _UpdateHierarchy();
+
+        // _cumulativeArcLengths[i] is the total length of the arcs 0, 1,..., i; like the hierarchy, it is
+        // invalidated when the control points of an arc change or arcs are inserted, and recalculated at the
+        // next arc length query
+        mutable std::vector<GLdouble> _cumulativeArcLengths;
+        mutable GLboolean             _arcLengthsAreValid;
+
+        GLvoid _UpdateCumulativeArcLengths() const;
+
     public:
         CubicCompositeCurve3(GLuint arcCount = 0);
         ~CubicCompositeCurve3();
@@ -74,6 +93,22 @@ namespace cagd
 
         int       GetArcCount();
 
+        // arc length based queries, the arcs are traversed in the order of their indices; the arc length tables of
+        // the arcs are rebuilt lazily, at the first query after their control points have changed
+        GLdouble  GetArcLength() const;
+        GLboolean ParameterAtArcLength(GLdouble s, GLuint &arcInd, GLdouble &u) const;
+
+        // points at point_count uniformly distributed arc lengths of the whole composite curve
+        GLboolean PointsAtUniformArcLengths(GLuint point_count, std::vector<DCoordinate3> &points) const;
+
+        // proximity queries, squaredDistance bounds the accepted squared distances on input and stores the squared
+        // distance of the result on success; the distance of an arc is measured from the points of its image
+        GLint     NearestArc(const DCoordinate3 &point, GLdouble &squaredDistance);
+        GLboolean NearestControlPoint(const DCoordinate3 &point, GLint &arcInd, GLint &cpInd, GLdouble &squaredDistance);
+        GLboolean NearestControlPointToLine(
+                const DCoordinate3 &origin, const DCoordinate3 &direction,
+                GLint &arcInd, GLint &cpInd, GLdouble &squaredDistance);
+
         GLboolean ChangeColor(GLuint arcInd, GLuint colorInd);
         GLuint    GetColorInd(GLuint arcInd);
         int       mouseOnCurve(DCoordinate3 mC);
@@ -0,0 +1,50 @@
+#include "CubicForwardDifferences.h"
+
+using namespace cagd;
+
+// special constructor
+CubicForwardDifferences::CubicForwardDifferences(
+        const DCoordinate3& p0, const DCoordinate3& p1, const DCoordinate3& p2, const DCoordinate3& p3,
+        GLuint sample_count, GLuint reanchoring_period):
+    _h(sample_count > 1 ? 1.0 / (sample_count - 1) : 1.0),
+    _sample_count(sample_count),
+    _reanchoring_period(reanchoring_period ? reanchoring_period : 1),
+    _index(0)
+{
+    _p[0] = p0;
+    _p[1] = p1;
+    _p[2] = p2;
+    _p[3] = p3;
+
+    // coefficients of the power form
+    _a[0] = p0;
+    _a[1] = 3.0 * (p1 - p0);
+    _a[2] = 3.0 * (p0 - 2.0 * p1 + p2);
+    _a[3] = p3 - p0 + 3.0 * (p1 - p2);
+
+    _Anchor();
+}
+
+// evaluates the state at the current sample
+GLvoid CubicForwardDifferences::_Anchor()
+{
+    GLdouble t  = (_index + 1 >= _sample_count) ? 1.0 : _index * _h;
+    GLdouble h  = _h, h2 = h * h, h3 = h2 * h;
+
+    GLdouble w  = 1.0 - t, t2 = t * t, w2 = w * w;
+
+    const DCoordinate3 &a1 = _a[1], &a2 = _a[2], &a3 = _a[3];
+
+    // the Bernstein form is exact at the end points of the arc
+    _d0   = _p[0] * (w2 * w) + _p[1] * (3.0 * w2 * t) + _p[2] * (3.0 * w * t2) + _p[3] * (t2 * t);
+    _d0_1 = a1 * h + a2 * (2.0 * t * h + h2) + a3 * (3.0 * t * t * h + 3.0 * t * h2 + h3);
+    _d0_2 = a2 * (2.0 * h2) + a3 * (6.0 * t * h2 + 6.0 * h3);
+    _d0_3 = a3 * (6.0 * h3);
+
+    _d1   = ((_p[1] - _p[0]) * w2 + (_p[2] - _p[1]) * (2.0 * w * t) + (_p[3] - _p[2]) * t2) * 3.0;
+    _d1_1 = a2 * (2.0 * h) + a3 * (6.0 * t * h + 3.0 * h2);
+    _d1_2 = a3 * (6.0 * h2);
+
+    _d2   = ((_p[2] - 2.0 * _p[1] + _p[0]) * w + (_p[3] - 2.0 * _p[2] + _p[1]) * t) * 6.0;
+    _d2_1 = a3 * (6.0 * h);
+}
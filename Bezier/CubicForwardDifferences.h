@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "../Core/DCoordinates3.h"
+
+namespace cagd
+{
+    //------------------------------
+    // class CubicForwardDifferences
+    //------------------------------
+    // Steps a cubic Bezier arc b(t) = sum_{i=0}^{3} p_i B_{3,i}(t) along the uniform parameters
+    // t_k = k / (sample_count - 1), k = 0, 1, ..., sample_count - 1. Since the third forward difference of
+    // a cubic polynomial is constant, a step costs three additions per coordinate for the point, two for
+    // the first and one for the second order derivative. Rounding errors of the differences accumulate,
+    // therefore the state is recomputed from the Bernstein form of the arc in every reanchoring_period-th
+    // step and at the last sample, which also reproduces the end point p_3 exactly.
+    class CubicForwardDifferences
+    {
+    protected:
+        DCoordinate3 _p[4];                         // control points
+        DCoordinate3 _a[4];                         // power form: b(t) = a_0 + a_1 t + a_2 t^2 + a_3 t^3
+        GLdouble     _h;                            // parameter step
+        GLuint       _sample_count, _reanchoring_period;
+        GLuint       _index;                        // index of the current sample
+
+        DCoordinate3 _d0, _d0_1, _d0_2, _d0_3;      // b(t_k) and its forward differences of order 1, 2 and 3
+        DCoordinate3 _d1, _d1_1, _d1_2;             // b'(t_k) and its forward differences of order 1 and 2
+        DCoordinate3 _d2, _d2_1;                    // b''(t_k) and its first order forward difference
+
+        // evaluates the state at the current sample
+        GLvoid _Anchor();
+
+    public:
+        // special constructor, sample_count has to be at least 2
+        CubicForwardDifferences(
+                const DCoordinate3& p0, const DCoordinate3& p1, const DCoordinate3& p2, const DCoordinate3& p3,
+                GLuint sample_count, GLuint reanchoring_period = 32);
+
+        // zeroth, first and second order derivatives at the current sample
+        const DCoordinate3& Point() const;
+        const DCoordinate3& FirstDerivative() const;
+        const DCoordinate3& SecondDerivative() const;
+
+        // index of the current sample
+        GLuint GetIndex() const;
+
+        // steps to the next sample
+        GLvoid Advance();
+    };
+
+    inline const DCoordinate3& CubicForwardDifferences::Point() const
+    {
+        return _d0;
+    }
+
+    inline const DCoordinate3& CubicForwardDifferences::FirstDerivative() const
+    {
+        return _d1;
+    }
+
+    inline const DCoordinate3& CubicForwardDifferences::SecondDerivative() const
+    {
+        return _d2;
+    }
+
+    inline GLuint CubicForwardDifferences::GetIndex() const
+    {
+        return _index;
+    }
+
+    inline GLvoid CubicForwardDifferences::Advance()
+    {
+        ++_index;
+
+        if (_index % _reanchoring_period == 0 || _index + 1 >= _sample_count)
+        {
+            _Anchor();
+            return;
+        }
+
+        _d0   += _d0_1;
+        _d0_1 += _d0_2;
+        _d0_2 += _d0_3;
+
+        _d1   += _d1_1;
+        _d1_1 += _d1_2;
+
+        _d2   += _d2_1;
+    }
+}
@@ -0,0 +1,82 @@
+#include "AdaptiveCurveSamplers.h"
+
+#include <cmath>
+
+using namespace cagd;
+using namespace std;
+
+// special constructor
+AdaptiveCurveSampler::AdaptiveCurveSampler(
+        GLdouble chord_tolerance, GLdouble angular_tolerance,
+        GLuint initial_segment_count, GLuint maximum_depth):
+    _chord_tolerance(chord_tolerance),
+    _angular_tolerance(angular_tolerance),
+    _initial_segment_count(initial_segment_count),
+    _maximum_depth(maximum_depth)
+{
+}
+
+// the angle between two vectors, zero if one of them vanishes
+static inline GLdouble angle(const DCoordinate3& lhs, const DCoordinate3& rhs)
+{
+    return atan2((lhs ^ rhs).length(), lhs * rhs);
+}
+
+// decides whether the segment can be represented by its chord
+GLboolean AdaptiveCurveSampler::_IsFlat(
+        const DCoordinate3 *a, const DCoordinate3 *m, const DCoordinate3 *b,
+        GLuint evaluated_order_count, GLdouble h) const
+{
+    // unit direction of the chord (the null vector if the chord degenerates)
+    DCoordinate3 direction = b[0] - a[0];
+    GLdouble     chord_length = direction.length();
+
+    if (chord_length > 0.0)
+    {
+        direction /= chord_length;
+    }
+
+    if (_chord_tolerance > 0.0)
+    {
+        // distance of the midpoint from the chord
+        DCoordinate3 deviation = m[0] - a[0];
+        deviation -= direction * (deviation * direction);
+
+        if (deviation.length() > _chord_tolerance)
+        {
+            return GL_FALSE;
+        }
+    }
+
+    if (evaluated_order_count < 2)
+    {
+        return GL_TRUE;
+    }
+
+    if (_chord_tolerance > 0.0)
+    {
+        // the midpoint of the cubic Hermite arc minus the midpoint of the chord equals h (a' - b') / 8,
+        // only its component that is perpendicular to the chord matters
+        DCoordinate3 bulge = (a[1] - b[1]) * (h / 8.0);
+        bulge -= direction * (bulge * direction);
+
+        if (bulge.length() > _chord_tolerance)
+        {
+            return GL_FALSE;
+        }
+    }
+
+    // segments that are shorter than the chord tolerance cannot be distinguished from their chords,
+    // this stops the refinement at cusps, where the tangent vanishes and flips
+    if (_angular_tolerance > 0.0 && (_chord_tolerance <= 0.0 || chord_length > _chord_tolerance ||
+                                     (m[0] - a[0]).length() > _chord_tolerance))
+    {
+        // total turning of the tangent along the segment
+        if (angle(a[1], m[1]) + angle(m[1], b[1]) > _angular_tolerance)
+        {
+            return GL_FALSE;
+        }
+    }
+
+    return GL_TRUE;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <new>
+#include <vector>
+#include "DCoordinates3.h"
+#include "GenericCurves3.h"
+#include "Matrices.h"
+
+namespace cagd
+{
+    //---------------------------
+    // class AdaptiveCurveSampler
+    //---------------------------
+    // Generates images of curves with a variable number of points. The definition domain is subdivided
+    // uniformly into a few initial segments, then each segment is halved recursively until
+    //  - the midpoint of the segment lies closer than the chord tolerance to the chord;
+    //  - the cubic Hermite arc that is determined by the end points and tangents of the segment deviates
+    //    less than the chord tolerance from the chord (this also detects inflections, at which the midpoint
+    //    may lie on the chord);
+    //  - the tangent turns less than the angular tolerance (in radians) along the segment;
+    // or the maximal depth of subdivision is reached. Non-positive tolerances switch the corresponding
+    // criteria off. Thus flat stretches are represented by few vertices, while tight bends are refined
+    // until consecutive tangents differ by less than the angular tolerance.
+    //
+    // The evaluator is a function object with a method
+    //
+    //      GLboolean operator ()(GLdouble u, DCoordinate3 *d) const
+    //
+    // that stores the point and its first evaluated_order_count - 1 derivatives at u in d[0], d[1], ...
+    // The criteria based on tangents require evaluated_order_count >= 2.
+    class AdaptiveCurveSampler
+    {
+    protected:
+        GLdouble _chord_tolerance, _angular_tolerance;
+        GLuint   _initial_segment_count, _maximum_depth;
+
+        // decides whether the segment [a, b] of length h with midpoint m can be represented by its chord,
+        // the arrays store the evaluated derivatives
+        GLboolean _IsFlat(const DCoordinate3 *a, const DCoordinate3 *m, const DCoordinate3 *b,
+                          GLuint evaluated_order_count, GLdouble h) const;
+
+    public:
+        // special constructor
+        AdaptiveCurveSampler(
+                GLdouble chord_tolerance, GLdouble angular_tolerance,
+                GLuint initial_segment_count = 16, GLuint maximum_depth = 10);
+
+        // the r-th row of the image stores the r-th order derivatives, where r = 0, 1, ..., max_order_of_derivatives
+        // and max_order_of_derivatives < evaluated_order_count; returns a null pointer if an evaluation fails
+        template <class Evaluator>
+        GenericCurve3* GenerateImage(
+                const Evaluator& evaluate, GLdouble u_min, GLdouble u_max,
+                GLuint evaluated_order_count, GLuint max_order_of_derivatives,
+                GLenum usage_flag = GL_STATIC_DRAW) const;
+    };
+
+    template <class Evaluator>
+    GenericCurve3* AdaptiveCurveSampler::GenerateImage(
+            const Evaluator& evaluate, GLdouble u_min, GLdouble u_max,
+            GLuint evaluated_order_count, GLuint max_order_of_derivatives,
+            GLenum usage_flag) const
+    {
+        GLuint n = evaluated_order_count;
+
+        if (u_min >= u_max || max_order_of_derivatives >= n)
+        {
+            return nullptr;
+        }
+
+        // accepted samples in increasing order of their parameters
+        std::vector<GLdouble>     parameters;
+        std::vector<DCoordinate3> derivatives;
+
+        // end points of the segments that still have to be processed, the nearest one is on the top
+        std::vector<GLdouble>     pending_parameters;
+        std::vector<GLuint>       pending_depths;
+        std::vector<DCoordinate3> pending_derivatives;
+
+        parameters.push_back(u_min);
+        derivatives.resize(n);
+
+        if (!evaluate(u_min, &derivatives[0]))
+        {
+            return nullptr;
+        }
+
+        GLuint   segment_count = _initial_segment_count ? _initial_segment_count : 1;
+        GLdouble step = (u_max - u_min) / segment_count;
+
+        pending_derivatives.resize(segment_count * n);
+
+        for (GLuint i = segment_count; i > 0; i--)
+        {
+            GLdouble u = (i == segment_count) ? u_max : u_min + i * step;
+
+            pending_parameters.push_back(u);
+            pending_depths.push_back(0);
+
+            if (!evaluate(u, &pending_derivatives[(segment_count - i) * n]))
+            {
+                return nullptr;
+            }
+        }
+
+        std::vector<DCoordinate3> middle(n);
+
+        while (!pending_parameters.empty())
+        {
+            GLuint top = static_cast<GLuint>(pending_parameters.size()) - 1;
+
+            GLdouble u_a = parameters.back(), u_b = pending_parameters[top];
+            GLdouble u_m = 0.5 * (u_a + u_b);
+
+            if (!evaluate(u_m, &middle[0]))
+            {
+                return nullptr;
+            }
+
+            const DCoordinate3 *a = &derivatives[derivatives.size() - n];
+            const DCoordinate3 *b = &pending_derivatives[top * n];
+
+            if (pending_depths[top] >= _maximum_depth || _IsFlat(a, &middle[0], b, n, u_b - u_a))
+            {
+                // the segment is accepted, its end point becomes the next sample
+                parameters.push_back(u_b);
+                derivatives.insert(derivatives.end(), b, b + n);
+
+                pending_parameters.pop_back();
+                pending_depths.pop_back();
+                pending_derivatives.resize(top * n);
+            }
+            else
+            {
+                // the left half is processed first
+                GLuint depth = ++pending_depths[top];
+
+                pending_parameters.push_back(u_m);
+                pending_depths.push_back(depth);
+                pending_derivatives.insert(pending_derivatives.end(), middle.begin(), middle.end());
+            }
+        }
+
+        GLuint sample_count = static_cast<GLuint>(parameters.size());
+
+        Matrix<DCoordinate3> image(max_order_of_derivatives + 1, sample_count);
+
+        for (GLuint k = 0; k < sample_count; k++)
+        {
+            for (GLuint r = 0; r <= max_order_of_derivatives; r++)
+            {
+                image(r, k) = derivatives[k * n + r];
+            }
+        }
+
+        return new (std::nothrow) GenericCurve3(image, usage_flag);
+    }
+}
@@ -0,0 +1,27 @@
+#include "ArcLengthTables.h"
+
+using namespace cagd;
+using namespace std;
+
+// the nodes are uniformly distributed, thus the segment of a parameter value is found directly
+GLuint ArcLengthTable::_SegmentOfParameter(GLdouble u) const
+{
+    GLuint   segment_count = static_cast<GLuint>(_u.size()) - 1;
+    GLdouble position = (u - _u.front()) / (_u.back() - _u.front()) * segment_count;
+
+    if (position <= 0.0)
+    {
+        return 0;
+    }
+
+    return min(static_cast<GLuint>(position), segment_count - 1);
+}
+
+// binary search in the increasing sequence of arc lengths
+GLuint ArcLengthTable::_SegmentOfArcLength(GLdouble s) const
+{
+    GLuint segment_count = static_cast<GLuint>(_s.size()) - 1;
+    GLuint k = static_cast<GLuint>(upper_bound(_s.begin(), _s.end(), s) - _s.begin());
+
+    return k ? min(k - 1, segment_count - 1) : 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cagd
+{
+    //---------------------
+    // class ArcLengthTable
+    //---------------------
+    // Tabulates the arc length s(u) = int_{u_min}^{u} |c'(t)| dt of a curve at the nodes of the uniform
+    // subdivision of its definition domain, the integral over each segment is calculated by the 5-point
+    // Gauss-Legendre rule. The speed |c'| at the nodes is stored as well, thus the inverse u(s) can be
+    // approximated by a cubic Hermite polynomial on each segment, which is refined by safeguarded Newton
+    // steps: after a binary search for the segment, a lookup usually costs one or two Newton iterations.
+    //
+    // The speed is evaluated by a function object with a method
+    //
+    //      GLdouble operator ()(GLdouble u) const
+    //
+    // that returns the length of the first order derivative at u.
+    class ArcLengthTable
+    {
+    protected:
+        std::vector<GLdouble> _u, _s, _speed;   // nodes, arc lengths and speeds at the nodes
+
+        static const GLuint _maximum_newton_iteration_count = 8;
+
+        // 5-point Gauss-Legendre quadrature of the speed over [a, b]
+        template <class Speed>
+        static GLdouble _Integrate(const Speed& speed, GLdouble a, GLdouble b);
+
+        // index of the segment that contains the parameter value or the arc length
+        GLuint _SegmentOfParameter(GLdouble u) const;
+        GLuint _SegmentOfArcLength(GLdouble s) const;
+
+    public:
+        // the table is empty until it is built
+        GLboolean IsEmpty() const;
+
+        // tabulates the arc length at segment_count + 1 uniformly distributed nodes of [u_min, u_max]
+        template <class Speed>
+        GLboolean Build(const Speed& speed, GLdouble u_min, GLdouble u_max, GLuint segment_count = 64);
+
+        // total length of the curve
+        GLdouble GetLength() const;
+
+        // arc length s(u), the parameter value is clamped to the definition domain
+        template <class Speed>
+        GLdouble ArcLength(const Speed& speed, GLdouble u) const;
+
+        // parameter value u(s), the arc length is clamped to [0, GetLength()]
+        template <class Speed>
+        GLdouble Parameter(const Speed& speed, GLdouble s) const;
+    };
+
+    inline GLboolean ArcLengthTable::IsEmpty() const
+    {
+        return _u.empty();
+    }
+
+    inline GLdouble ArcLengthTable::GetLength() const
+    {
+        return _s.empty() ? 0.0 : _s.back();
+    }
+
+    template <class Speed>
+    GLdouble ArcLengthTable::_Integrate(const Speed& speed, GLdouble a, GLdouble b)
+    {
+        static const GLdouble x[3] = {0.0, 0.5384693101056831, 0.9061798459386640};
+        static const GLdouble w[3] = {0.5688888888888889, 0.4786286704993665, 0.2369268850561891};
+
+        GLdouble c = 0.5 * (a + b), h = 0.5 * (b - a);
+
+        GLdouble sum = w[0] * speed(c);
+
+        for (GLuint i = 1; i < 3; i++)
+        {
+            sum += w[i] * (speed(c - h * x[i]) + speed(c + h * x[i]));
+        }
+
+        return h * sum;
+    }
+
+    template <class Speed>
+    GLboolean ArcLengthTable::Build(const Speed& speed, GLdouble u_min, GLdouble u_max, GLuint segment_count)
+    {
+        if (u_min >= u_max || !segment_count)
+        {
+            return GL_FALSE;
+        }
+
+        _u.resize(segment_count + 1);
+        _s.resize(segment_count + 1);
+        _speed.resize(segment_count + 1);
+
+        GLdouble step = (u_max - u_min) / segment_count;
+
+        for (GLuint i = 0; i <= segment_count; i++)
+        {
+            _u[i] = (i == segment_count) ? u_max : u_min + i * step;
+            _speed[i] = speed(_u[i]);
+        }
+
+        _s[0] = 0.0;
+
+        for (GLuint i = 0; i < segment_count; i++)
+        {
+            _s[i + 1] = _s[i] + _Integrate(speed, _u[i], _u[i + 1]);
+        }
+
+        return GL_TRUE;
+    }
+
+    template <class Speed>
+    GLdouble ArcLengthTable::ArcLength(const Speed& speed, GLdouble u) const
+    {
+        if (_u.empty())
+        {
+            return 0.0;
+        }
+
+        u = std::min(std::max(u, _u.front()), _u.back());
+
+        GLuint k = _SegmentOfParameter(u);
+
+        return _s[k] + _Integrate(speed, _u[k], u);
+    }
+
+    template <class Speed>
+    GLdouble ArcLengthTable::Parameter(const Speed& speed, GLdouble s) const
+    {
+        if (_u.empty())
+        {
+            return 0.0;
+        }
+
+        if (s <= 0.0)
+        {
+            return _u.front();
+        }
+
+        if (s >= _s.back())
+        {
+            return _u.back();
+        }
+
+        GLuint k = _SegmentOfArcLength(s);
+
+        GLdouble u_0 = _u[k], u_1 = _u[k + 1];
+        GLdouble s_0 = _s[k], h = _s[k + 1] - s_0;
+
+        if (h <= 0.0)
+        {
+            return u_0;
+        }
+
+        // cubic Hermite approximation of u(s) on the segment, the derivatives of the inverse are the
+        // reciprocals of the speed (or the slope of the chord, if the speed vanishes)
+        GLdouble slope = (u_1 - u_0) / h;
+        GLdouble m_0 = _speed[k] > 0.0 ? 1.0 / _speed[k] : slope;
+        GLdouble m_1 = _speed[k + 1] > 0.0 ? 1.0 / _speed[k + 1] : slope;
+
+        GLdouble t = (s - s_0) / h, t2 = t * t, t3 = t2 * t;
+
+        GLdouble u = (2.0 * t3 - 3.0 * t2 + 1.0) * u_0 + (t3 - 2.0 * t2 + t) * h * m_0 +
+                     (3.0 * t2 - 2.0 * t3) * u_1 + (t3 - t2) * h * m_1;
+
+        // Newton's method for s_0 + int_{u_0}^{u} |c'| - s = 0, the root is bracketed by [lower, upper]
+        GLdouble lower = u_0, upper = u_1;
+        GLdouble tolerance = 1.0e-14 * std::max(std::fabs(u_0), std::fabs(u_1)) + 1.0e-300;
+
+        if (u <= lower || u >= upper)
+        {
+            u = 0.5 * (lower + upper);
+        }
+
+        for (GLuint iteration = 0; iteration < _maximum_newton_iteration_count; iteration++)
+        {
+            GLdouble f = s_0 + _Integrate(speed, u_0, u) - s;
+
+            if (std::fabs(f) <= 1.0e-14 * _s.back())
+            {
+                break;
+            }
+
+            if (f > 0.0)
+            {
+                upper = u;
+            }
+            else
+            {
+                lower = u;
+            }
+
+            GLdouble v = speed(u);
+            GLdouble next = (v > 0.0) ? u - f / v : 0.5 * (lower + upper);
+
+            // bisection, if Newton's step leaves the bracket
+            if (next <= lower || next >= upper)
+            {
+                next = 0.5 * (lower + upper);
+            }
+
+            GLboolean converged = std::fabs(next - u) <= tolerance;
+
+            u = next;
+
+            if (converged)
+            {
+                break;
+            }
+        }
+
+        return u;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <memory>
+#include "CollocationFactorizationCaches.h"
+#include "LRUCaches.h"
+#include "Matrices.h"
+
+namespace cagd
+{
+    //---------------------------------
+    // class BlendingFunctionTableCache
+    //---------------------------------
+    // Stores the most recently used tables of blending function values and derivatives. Similarly to
+    // collocation matrices, such a table is uniquely determined by the type and the shape parameters
+    // of the basis, by the maximal order of derivatives and by the parameter values at which the
+    // blending functions are evaluated, therefore the keys of collocation matrices are reused: the
+    // maximal order of derivatives is appended to the shape parameters and the knot vector is replaced
+    // by the parameter values. E.g., every arc of a composite curve that is sampled at the same
+    // parameter values shares the same table. If the cache is full, the least recently used table is
+    // discarded.
+    typedef LRUCache<CollocationKey, std::shared_ptr<const Matrix<GLdouble> > > BlendingFunctionTableCache;
+}
@@ -0,0 +1,208 @@
+#include "BoundingVolumeHierarchies.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // orders primitives by the coordinates of the centers of their boxes along the given axis
+    class CenterComparator
+    {
+    private:
+        const vector<BoundingBox3> &_boxes;
+        GLuint                      _axis;
+
+    public:
+        CenterComparator(const vector<BoundingBox3>& boxes, GLuint axis): _boxes(boxes), _axis(axis)
+        {
+        }
+
+        bool operator ()(GLuint lhs, GLuint rhs) const
+        {
+            return _boxes[lhs].lower[_axis] + _boxes[lhs].upper[_axis] <
+                   _boxes[rhs].lower[_axis] + _boxes[rhs].upper[_axis];
+        }
+    };
+}
+
+// default constructor, creates an empty box
+BoundingBox3::BoundingBox3():
+    lower( numeric_limits<GLdouble>::max(),  numeric_limits<GLdouble>::max(),  numeric_limits<GLdouble>::max()),
+    upper(-numeric_limits<GLdouble>::max(), -numeric_limits<GLdouble>::max(), -numeric_limits<GLdouble>::max())
+{
+}
+
+// enlarges the box
+GLvoid BoundingBox3::Enclose(const DCoordinate3& point)
+{
+    for (GLuint i = 0; i < 3; i++)
+    {
+        lower[i] = min(lower[i], point[i]);
+        upper[i] = max(upper[i], point[i]);
+    }
+}
+
+GLvoid BoundingBox3::Enclose(const BoundingBox3& box)
+{
+    for (GLuint i = 0; i < 3; i++)
+    {
+        lower[i] = min(lower[i], box.lower[i]);
+        upper[i] = max(upper[i], box.upper[i]);
+    }
+}
+
+GLboolean BoundingBox3::IsEmpty() const
+{
+    return lower[0] > upper[0] || lower[1] > upper[1] || lower[2] > upper[2];
+}
+
+DCoordinate3 BoundingBox3::GetCenter() const
+{
+    return 0.5 * (lower + upper);
+}
+
+// squared distance of the point from the box, zero if the point lies inside
+GLdouble BoundingBox3::SquaredDistance(const DCoordinate3& point) const
+{
+    GLdouble result = 0.0;
+
+    for (GLuint i = 0; i < 3; i++)
+    {
+        GLdouble d = max(max(lower[i] - point[i], point[i] - upper[i]), 0.0);
+        result += d * d;
+    }
+
+    return result;
+}
+
+// a lower bound for the squared distance of the line from the box
+GLdouble BoundingBox3::SquaredDistanceLowerBound(const DCoordinate3& origin, const DCoordinate3& direction) const
+{
+    GLdouble length = direction.length();
+
+    if (length == 0.0)
+    {
+        return SquaredDistance(origin);
+    }
+
+    // distance of the center from the line minus the radius of the circumscribed sphere
+    DCoordinate3 center = GetCenter();
+    GLdouble     d = ((center - origin) ^ direction).length() / length - 0.5 * (upper - lower).length();
+
+    return d > 0.0 ? d * d : 0.0;
+}
+
+// builds the subtree over primitives[first], ..., primitives[last - 1], returns the index of its root
+GLint BoundingVolumeHierarchy::_Build(
+        const vector<BoundingBox3>& boxes, vector<GLuint>& primitives,
+        GLuint first, GLuint last, GLint parent)
+{
+    GLint index = static_cast<GLint>(_nodes.size());
+
+    _nodes.push_back(Node());
+    _nodes[index].parent = parent;
+    _nodes[index].left = _nodes[index].right = -1;
+    _nodes[index].primitive = -1;
+
+    if (last - first == 1)
+    {
+        _nodes[index].box = boxes[primitives[first]];
+        _nodes[index].primitive = primitives[first];
+        _leaves[primitives[first]] = index;
+
+        return index;
+    }
+
+    // the primitives are split at the median of their centers along the longest axis of the centers
+    BoundingBox3 centers;
+
+    for (GLuint i = first; i < last; i++)
+    {
+        centers.Enclose(boxes[primitives[i]].GetCenter());
+    }
+
+    DCoordinate3 extent = centers.upper - centers.lower;
+    GLuint axis = 0;
+
+    if (extent[1] > extent[axis])
+    {
+        axis = 1;
+    }
+
+    if (extent[2] > extent[axis])
+    {
+        axis = 2;
+    }
+
+    GLuint middle = first + (last - first) / 2;
+
+    nth_element(primitives.begin() + first, primitives.begin() + middle, primitives.begin() + last,
+                CenterComparator(boxes, axis));
+
+    // the vector of nodes may be reallocated by the recursive calls
+    GLint left  = _Build(boxes, primitives, first, middle, index);
+    GLint right = _Build(boxes, primitives, middle, last, index);
+
+    _nodes[index].left = left;
+    _nodes[index].right = right;
+    _nodes[index].box = _nodes[left].box;
+    _nodes[index].box.Enclose(_nodes[right].box);
+
+    return index;
+}
+
+// builds the hierarchy over the boxes of the primitives
+GLvoid BoundingVolumeHierarchy::Build(const vector<BoundingBox3>& boxes)
+{
+    Clear();
+
+    if (boxes.empty())
+    {
+        return;
+    }
+
+    vector<GLuint> primitives(boxes.size());
+
+    for (GLuint i = 0; i < primitives.size(); i++)
+    {
+        primitives[i] = i;
+    }
+
+    _nodes.reserve(2 * boxes.size() - 1);
+    _leaves.resize(boxes.size());
+
+    _Build(boxes, primitives, 0, static_cast<GLuint>(boxes.size()), -1);
+}
+
+GLvoid BoundingVolumeHierarchy::Clear()
+{
+    _nodes.clear();
+    _leaves.clear();
+}
+
+// replaces the box of the primitive and updates the boxes of its ancestors
+GLboolean BoundingVolumeHierarchy::Refit(GLuint primitive, const BoundingBox3& box)
+{
+    if (primitive >= _leaves.size())
+    {
+        return GL_FALSE;
+    }
+
+    GLint index = static_cast<GLint>(_leaves[primitive]);
+
+    _nodes[index].box = box;
+
+    for (index = _nodes[index].parent; index >= 0; index = _nodes[index].parent)
+    {
+        Node &node = _nodes[index];
+
+        node.box = _nodes[node.left].box;
+        node.box.Enclose(_nodes[node.right].box);
+    }
+
+    return GL_TRUE;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "DCoordinates3.h"
+
+namespace cagd
+{
+    //-------------------
+    // class BoundingBox3
+    //-------------------
+    // Axis aligned box, the default constructor creates an empty box that can be enlarged by points
+    // and boxes.
+    class BoundingBox3
+    {
+    public:
+        DCoordinate3 lower, upper;
+
+        // default constructor, creates an empty box
+        BoundingBox3();
+
+        // enlarges the box
+        GLvoid Enclose(const DCoordinate3& point);
+        GLvoid Enclose(const BoundingBox3& box);
+
+        GLboolean IsEmpty() const;
+
+        DCoordinate3 GetCenter() const;
+
+        // squared distance of the point from the box, zero if the point lies inside
+        GLdouble SquaredDistance(const DCoordinate3& point) const;
+
+        // a lower bound for the squared distance of the line origin + t * direction from the box,
+        // based on the circumscribed sphere of the box
+        GLdouble SquaredDistanceLowerBound(const DCoordinate3& origin, const DCoordinate3& direction) const;
+    };
+
+    //------------------------------
+    // class BoundingVolumeHierarchy
+    //------------------------------
+    // Binary tree of axis aligned boxes over a set of primitives, which are identified by their indices
+    // 0, 1, ..., primitive_count - 1. The tree is built top-down by splitting the primitives at the median
+    // of their box centers along the longest axis, thus its depth is logarithmic. If the box of a primitive
+    // changes, the hierarchy can be refitted along the path from the corresponding leaf to the root.
+    //
+    // Nearest neighbour queries are answered by best-first branch and bound. The metric is given by a
+    // function object with the methods
+    //
+    //      GLdouble LowerBound(const BoundingBox3& box) const
+    //      GLdouble operator ()(GLuint primitive) const
+    //
+    // where the first one has to underestimate the distance of any primitive that lies inside the box,
+    // while the second one returns the distance of the given primitive.
+    class BoundingVolumeHierarchy
+    {
+    protected:
+        class Node
+        {
+        public:
+            BoundingBox3 box;
+            GLint        parent, left, right;
+            GLint        primitive;         // non-negative only for leaves
+        };
+
+        std::vector<Node>   _nodes;         // the root is the first node
+        std::vector<GLuint> _leaves;        // index of the leaf node of each primitive
+
+        GLint _Build(const std::vector<BoundingBox3>& boxes, std::vector<GLuint>& primitives,
+                     GLuint first, GLuint last, GLint parent);
+
+    public:
+        // builds the hierarchy over the boxes of the primitives
+        GLvoid Build(const std::vector<BoundingBox3>& boxes);
+
+        GLvoid Clear();
+
+        GLuint GetPrimitiveCount() const;
+
+        // replaces the box of the primitive and updates the boxes of its ancestors
+        GLboolean Refit(GLuint primitive, const BoundingBox3& box);
+
+        // returns the index of the nearest primitive whose distance is less than the input value of
+        // minimum_distance, or -1 if there is no such primitive; on success minimum_distance is
+        // overwritten by the distance of the returned primitive
+        template <class Distance>
+        GLint Nearest(const Distance& distance, GLdouble& minimum_distance) const;
+    };
+
+    inline GLuint BoundingVolumeHierarchy::GetPrimitiveCount() const
+    {
+        return static_cast<GLuint>(_leaves.size());
+    }
+
+    template <class Distance>
+    GLint BoundingVolumeHierarchy::Nearest(const Distance& distance, GLdouble& minimum_distance) const
+    {
+        if (_nodes.empty())
+        {
+            return -1;
+        }
+
+        typedef std::pair<GLdouble, GLint> Candidate;
+
+        // nodes ordered by the lower bounds of their distances, the nearest one is on the top
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+
+        GLint nearest = -1;
+
+        candidates.push(Candidate(distance.LowerBound(_nodes[0].box), 0));
+
+        while (!candidates.empty())
+        {
+            Candidate candidate = candidates.top();
+            candidates.pop();
+
+            // none of the remaining nodes can contain a nearer primitive
+            if (candidate.first >= minimum_distance)
+            {
+                break;
+            }
+
+            const Node &node = _nodes[candidate.second];
+
+            if (node.primitive >= 0)
+            {
+                GLdouble d = distance(static_cast<GLuint>(node.primitive));
+
+                if (d < minimum_distance)
+                {
+                    minimum_distance = d;
+                    nearest = node.primitive;
+                }
+
+                continue;
+            }
+
+            GLint children[2] = {node.left, node.right};
+
+            for (GLuint i = 0; i < 2; i++)
+            {
+                GLdouble bound = distance.LowerBound(_nodes[children[i]].box);
+
+                if (bound < minimum_distance)
+                {
+                    candidates.push(Candidate(bound, children[i]));
+                }
+            }
+        }
+
+        return nearest;
+    }
+}
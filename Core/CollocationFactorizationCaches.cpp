@@ -0,0 +1,61 @@
+#include "CollocationFactorizationCaches.h"
+
+#include <cstring>
+
+using namespace cagd;
+using namespace std;
+
+// FNV-1a step over the bit pattern of a real number (negative zeros are replaced by positive ones,
+// since they are equal when compared)
+static inline size_t _CombineHash(size_t hash, GLdouble value)
+{
+    value += 0.0;
+
+    GLuint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    for (GLuint i = 0; i < sizeof(bits); ++i)
+    {
+        hash ^= static_cast<size_t>((bits >> (8 * i)) & 0xff);
+        hash *= static_cast<size_t>(1099511628211ull);
+    }
+
+    return hash;
+}
+
+// special constructor
+CollocationKey::CollocationKey(
+        const type_info& basis_type, GLuint direction,
+        const vector<GLdouble>& shape_parameters, const Matrix<GLdouble>& knot_vector):
+    _basis_type(basis_type),
+    _direction(direction),
+    _shape_parameters(shape_parameters),
+    _knots(knot_vector.data(), knot_vector.data() + knot_vector.GetRowCount() * knot_vector.GetColumnCount())
+{
+    _hash = static_cast<size_t>(14695981039346656037ull);
+
+    _hash ^= _basis_type.hash_code();
+    _hash = _CombineHash(_hash, _direction);
+    _hash = _CombineHash(_hash, _shape_parameters.size());
+
+    for (vector<GLdouble>::const_iterator it = _shape_parameters.begin(); it != _shape_parameters.end(); ++it)
+        _hash = _CombineHash(_hash, *it);
+
+    for (vector<GLdouble>::const_iterator it = _knots.begin(); it != _knots.end(); ++it)
+        _hash = _CombineHash(_hash, *it);
+}
+
+// equality test, hash values are compared first
+GLboolean CollocationKey::operator ==(const CollocationKey& rhs) const
+{
+    return _hash == rhs._hash &&
+           _basis_type == rhs._basis_type &&
+           _direction == rhs._direction &&
+           _shape_parameters == rhs._shape_parameters &&
+           _knots == rhs._knots;
+}
+
+size_t CollocationKey::GetHash() const
+{
+    return _hash;
+}
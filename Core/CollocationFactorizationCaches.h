@@ -0,0 +1,47 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+#include "LRUCaches.h"
+#include "Matrices.h"
+#include "RealSquareMatrices.h"
+
+namespace cagd
+{
+    //---------------------
+    // class CollocationKey
+    //---------------------
+    // A collocation matrix [F_i(u_r)] is uniquely determined by the type of the basis {F_i}, by the shape
+    // parameters of the basis (including its definition domain) and by the knot vector {u_r}.
+    class CollocationKey
+    {
+    protected:
+        std::type_index         _basis_type;        // dynamic type of the basis
+        GLuint                  _direction;         // 0: u-direction, 1: v-direction
+        std::vector<GLdouble>   _shape_parameters;
+        std::vector<GLdouble>   _knots;
+        std::size_t             _hash;
+
+    public:
+        // special constructor
+        CollocationKey(const std::type_info& basis_type, GLuint direction,
+                       const std::vector<GLdouble>& shape_parameters, const Matrix<GLdouble>& knot_vector);
+
+        // equality test, hash values are compared first
+        GLboolean operator ==(const CollocationKey& rhs) const;
+
+        std::size_t GetHash() const;
+    };
+
+    //------------------------------------
+    // class CollocationFactorizationCache
+    //------------------------------------
+    // Stores the LU decompositions of the most recently used collocation matrices, therefore repeated
+    // interpolation problems with fixed knots cost only two triangular solves. If the cache is full,
+    // the least recently used factorization is discarded.
+    typedef LRUCache<CollocationKey, std::shared_ptr<RealSquareMatrix> > CollocationFactorizationCache;
+}
@@ -0,0 +1,587 @@
+#include "DCoordinate3Batches.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define CAGD_X86_KERNELS
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define CAGD_TARGET(instruction_sets)
+    #else
+        #define CAGD_TARGET(instruction_sets) __attribute__((target(instruction_sets)))
+    #endif
+#endif
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // kernels that process the component arrays of batches
+    struct Kernels
+    {
+        // y[i] += x[i]
+        GLvoid (*add)(GLuint n, const GLdouble *x, GLdouble *y);
+
+        // y[i] *= alpha
+        GLvoid (*scale)(GLuint n, GLdouble alpha, GLdouble *y);
+
+        // y[i] += alpha * x[i]
+        GLvoid (*axpy)(GLuint n, GLdouble alpha, const GLdouble *x, GLdouble *y);
+
+        // c[i] = a[i] ^ b[i]
+        GLvoid (*cross)(GLuint n,
+                        const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                        const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                        GLdouble *cx, GLdouble *cy, GLdouble *cz);
+
+        // d[i] = a[i] * b[i]
+        GLvoid (*dot)(GLuint n,
+                      const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                      const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                      GLdouble *d);
+
+        // a[i] /= |a[i]|, unless a[i] is the null vector
+        GLvoid (*normalize)(GLuint n, GLdouble *x, GLdouble *y, GLdouble *z);
+    };
+
+    //---------------
+    // scalar kernels
+    //---------------
+    GLvoid ScalarAdd(GLuint n, const GLdouble *x, GLdouble *y)
+    {
+        for (GLuint i = 0; i < n; ++i)
+            y[i] += x[i];
+    }
+
+    GLvoid ScalarScale(GLuint n, GLdouble alpha, GLdouble *y)
+    {
+        for (GLuint i = 0; i < n; ++i)
+            y[i] *= alpha;
+    }
+
+    GLvoid ScalarAxpy(GLuint n, GLdouble alpha, const GLdouble *x, GLdouble *y)
+    {
+        for (GLuint i = 0; i < n; ++i)
+            y[i] += alpha * x[i];
+    }
+
+    GLvoid ScalarCross(GLuint n,
+                       const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                       const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                       GLdouble *cx, GLdouble *cy, GLdouble *cz)
+    {
+        for (GLuint i = 0; i < n; ++i)
+        {
+            GLdouble x = ay[i] * bz[i] - az[i] * by[i];
+            GLdouble y = az[i] * bx[i] - ax[i] * bz[i];
+            GLdouble z = ax[i] * by[i] - ay[i] * bx[i];
+
+            cx[i] = x;
+            cy[i] = y;
+            cz[i] = z;
+        }
+    }
+
+    GLvoid ScalarDot(GLuint n,
+                     const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                     const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                     GLdouble *d)
+    {
+        for (GLuint i = 0; i < n; ++i)
+            d[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+    }
+
+    GLvoid ScalarNormalize(GLuint n, GLdouble *x, GLdouble *y, GLdouble *z)
+    {
+        for (GLuint i = 0; i < n; ++i)
+        {
+            GLdouble l = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+
+            if (l && l != 1.0)
+            {
+                x[i] /= l;
+                y[i] /= l;
+                z[i] /= l;
+            }
+        }
+    }
+
+    const Kernels scalar_kernels =
+    {
+        ScalarAdd, ScalarScale, ScalarAxpy, ScalarCross, ScalarDot, ScalarNormalize
+    };
+
+#ifdef CAGD_X86_KERNELS
+    //-------------
+    // SSE2 kernels
+    //-------------
+    // 2 lanes, the remaining element is processed by the scalar code
+    CAGD_TARGET("sse2") GLvoid SSE2Add(GLuint n, const GLdouble *x, GLdouble *y)
+    {
+        GLuint i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+
+        ScalarAdd(n - i, x + i, y + i);
+    }
+
+    CAGD_TARGET("sse2") GLvoid SSE2Scale(GLuint n, GLdouble alpha, GLdouble *y)
+    {
+        __m128d a = _mm_set1_pd(alpha);
+
+        GLuint i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(y + i, _mm_mul_pd(_mm_loadu_pd(y + i), a));
+
+        ScalarScale(n - i, alpha, y + i);
+    }
+
+    CAGD_TARGET("sse2") GLvoid SSE2Axpy(GLuint n, GLdouble alpha, const GLdouble *x, GLdouble *y)
+    {
+        __m128d a = _mm_set1_pd(alpha);
+
+        GLuint i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+
+        ScalarAxpy(n - i, alpha, x + i, y + i);
+    }
+
+    CAGD_TARGET("sse2") GLvoid SSE2Cross(GLuint n,
+                                         const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                                         const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                                         GLdouble *cx, GLdouble *cy, GLdouble *cz)
+    {
+        GLuint i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d axi = _mm_loadu_pd(ax + i), ayi = _mm_loadu_pd(ay + i), azi = _mm_loadu_pd(az + i);
+            __m128d bxi = _mm_loadu_pd(bx + i), byi = _mm_loadu_pd(by + i), bzi = _mm_loadu_pd(bz + i);
+
+            _mm_storeu_pd(cx + i, _mm_sub_pd(_mm_mul_pd(ayi, bzi), _mm_mul_pd(azi, byi)));
+            _mm_storeu_pd(cy + i, _mm_sub_pd(_mm_mul_pd(azi, bxi), _mm_mul_pd(axi, bzi)));
+            _mm_storeu_pd(cz + i, _mm_sub_pd(_mm_mul_pd(axi, byi), _mm_mul_pd(ayi, bxi)));
+        }
+
+        ScalarCross(n - i, ax + i, ay + i, az + i, bx + i, by + i, bz + i, cx + i, cy + i, cz + i);
+    }
+
+    CAGD_TARGET("sse2") GLvoid SSE2Dot(GLuint n,
+                                       const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                                       const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                                       GLdouble *d)
+    {
+        GLuint i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d sum = _mm_mul_pd(_mm_loadu_pd(ax + i), _mm_loadu_pd(bx + i));
+            sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(ay + i), _mm_loadu_pd(by + i)));
+            sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(az + i), _mm_loadu_pd(bz + i)));
+
+            _mm_storeu_pd(d + i, sum);
+        }
+
+        ScalarDot(n - i, ax + i, ay + i, az + i, bx + i, by + i, bz + i, d + i);
+    }
+
+    CAGD_TARGET("sse2") GLvoid SSE2Normalize(GLuint n, GLdouble *x, GLdouble *y, GLdouble *z)
+    {
+        __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+
+        GLuint i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d xi = _mm_loadu_pd(x + i), yi = _mm_loadu_pd(y + i), zi = _mm_loadu_pd(z + i);
+
+            __m128d l = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(xi, xi), _mm_mul_pd(yi, yi)), _mm_mul_pd(zi, zi)));
+
+            // null vectors are divided by 1
+            __m128d is_null = _mm_cmpeq_pd(l, zero);
+            l = _mm_or_pd(_mm_and_pd(is_null, one), _mm_andnot_pd(is_null, l));
+
+            _mm_storeu_pd(x + i, _mm_div_pd(xi, l));
+            _mm_storeu_pd(y + i, _mm_div_pd(yi, l));
+            _mm_storeu_pd(z + i, _mm_div_pd(zi, l));
+        }
+
+        ScalarNormalize(n - i, x + i, y + i, z + i);
+    }
+
+    const Kernels sse2_kernels =
+    {
+        SSE2Add, SSE2Scale, SSE2Axpy, SSE2Cross, SSE2Dot, SSE2Normalize
+    };
+
+    //-------------
+    // AVX2 kernels
+    //-------------
+    // 4 lanes with fused multiply-add instructions, the remaining elements are processed by the
+    // SSE2 kernels
+    CAGD_TARGET("avx2,fma") GLvoid AVX2Add(GLuint n, const GLdouble *x, GLdouble *y)
+    {
+        GLuint i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+
+        SSE2Add(n - i, x + i, y + i);
+    }
+
+    CAGD_TARGET("avx2,fma") GLvoid AVX2Scale(GLuint n, GLdouble alpha, GLdouble *y)
+    {
+        __m256d a = _mm256_set1_pd(alpha);
+
+        GLuint i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(y + i, _mm256_mul_pd(_mm256_loadu_pd(y + i), a));
+
+        SSE2Scale(n - i, alpha, y + i);
+    }
+
+    CAGD_TARGET("avx2,fma") GLvoid AVX2Axpy(GLuint n, GLdouble alpha, const GLdouble *x, GLdouble *y)
+    {
+        __m256d a = _mm256_set1_pd(alpha);
+
+        GLuint i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+
+        SSE2Axpy(n - i, alpha, x + i, y + i);
+    }
+
+    CAGD_TARGET("avx2,fma") GLvoid AVX2Cross(GLuint n,
+                                             const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                                             const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                                             GLdouble *cx, GLdouble *cy, GLdouble *cz)
+    {
+        GLuint i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d axi = _mm256_loadu_pd(ax + i), ayi = _mm256_loadu_pd(ay + i), azi = _mm256_loadu_pd(az + i);
+            __m256d bxi = _mm256_loadu_pd(bx + i), byi = _mm256_loadu_pd(by + i), bzi = _mm256_loadu_pd(bz + i);
+
+            _mm256_storeu_pd(cx + i, _mm256_fmsub_pd(ayi, bzi, _mm256_mul_pd(azi, byi)));
+            _mm256_storeu_pd(cy + i, _mm256_fmsub_pd(azi, bxi, _mm256_mul_pd(axi, bzi)));
+            _mm256_storeu_pd(cz + i, _mm256_fmsub_pd(axi, byi, _mm256_mul_pd(ayi, bxi)));
+        }
+
+        SSE2Cross(n - i, ax + i, ay + i, az + i, bx + i, by + i, bz + i, cx + i, cy + i, cz + i);
+    }
+
+    CAGD_TARGET("avx2,fma") GLvoid AVX2Dot(GLuint n,
+                                           const GLdouble *ax, const GLdouble *ay, const GLdouble *az,
+                                           const GLdouble *bx, const GLdouble *by, const GLdouble *bz,
+                                           GLdouble *d)
+    {
+        GLuint i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d sum = _mm256_mul_pd(_mm256_loadu_pd(ax + i), _mm256_loadu_pd(bx + i));
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(ay + i), _mm256_loadu_pd(by + i), sum);
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(az + i), _mm256_loadu_pd(bz + i), sum);
+
+            _mm256_storeu_pd(d + i, sum);
+        }
+
+        SSE2Dot(n - i, ax + i, ay + i, az + i, bx + i, by + i, bz + i, d + i);
+    }
+
+    CAGD_TARGET("avx2,fma") GLvoid AVX2Normalize(GLuint n, GLdouble *x, GLdouble *y, GLdouble *z)
+    {
+        __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+
+        GLuint i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d xi = _mm256_loadu_pd(x + i), yi = _mm256_loadu_pd(y + i), zi = _mm256_loadu_pd(z + i);
+
+            __m256d l = _mm256_mul_pd(xi, xi);
+            l = _mm256_fmadd_pd(yi, yi, l);
+            l = _mm256_fmadd_pd(zi, zi, l);
+            l = _mm256_sqrt_pd(l);
+
+            // null vectors are divided by 1
+            l = _mm256_blendv_pd(l, one, _mm256_cmp_pd(l, zero, _CMP_EQ_OQ));
+
+            _mm256_storeu_pd(x + i, _mm256_div_pd(xi, l));
+            _mm256_storeu_pd(y + i, _mm256_div_pd(yi, l));
+            _mm256_storeu_pd(z + i, _mm256_div_pd(zi, l));
+        }
+
+        SSE2Normalize(n - i, x + i, y + i, z + i);
+    }
+
+    const Kernels avx2_kernels =
+    {
+        AVX2Add, AVX2Scale, AVX2Axpy, AVX2Cross, AVX2Dot, AVX2Normalize
+    };
+#endif
+
+    const Kernels& SelectKernels(DCoordinate3Batch::InstructionSet instruction_set)
+    {
+        switch (instruction_set)
+        {
+#ifdef CAGD_X86_KERNELS
+        case DCoordinate3Batch::AVX2: return avx2_kernels;
+        case DCoordinate3Batch::SSE2: return sse2_kernels;
+#endif
+        default:                      return scalar_kernels;
+        }
+    }
+
+    // the instruction set in use, initialized on first use
+    DCoordinate3Batch::InstructionSet& ActiveInstructionSet()
+    {
+        static DCoordinate3Batch::InstructionSet active = DCoordinate3Batch::DetectInstructionSet();
+        return active;
+    }
+
+    const Kernels& ActiveKernels()
+    {
+        return SelectKernels(ActiveInstructionSet());
+    }
+}
+
+// the widest instruction set supported by the processor
+DCoordinate3Batch::InstructionSet DCoordinate3Batch::DetectInstructionSet()
+{
+#if defined(CAGD_X86_KERNELS) && defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+    GLboolean fma     = (info[2] & (1 << 12)) != 0;
+    GLboolean osxsave = (info[2] & (1 << 27)) != 0;
+    GLboolean avx     = (info[2] & (1 << 28)) != 0;
+    GLboolean sse2    = (info[3] & (1 << 26)) != 0;
+
+    // the operating system has to save the ymm registers
+    GLboolean ymm_state = osxsave && avx && ((_xgetbv(0) & 6) == 6);
+
+    __cpuidex(info, 7, 0);
+    GLboolean avx2 = (info[1] & (1 << 5)) != 0;
+
+    if (ymm_state && avx2 && fma)
+        return AVX2;
+
+    return sse2 ? SSE2 : SCALAR;
+#elif defined(CAGD_X86_KERNELS)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return AVX2;
+
+    return __builtin_cpu_supports("sse2") ? SSE2 : SCALAR;
+#else
+    return SCALAR;
+#endif
+}
+
+// get/set the instruction set used by the kernels of all batches
+DCoordinate3Batch::InstructionSet DCoordinate3Batch::GetInstructionSet()
+{
+    return ActiveInstructionSet();
+}
+
+GLboolean DCoordinate3Batch::SetInstructionSet(InstructionSet instruction_set)
+{
+    if (instruction_set > DetectInstructionSet())
+        return GL_FALSE;
+
+    ActiveInstructionSet() = instruction_set;
+
+    return GL_TRUE;
+}
+
+// special/default constructor
+DCoordinate3Batch::DCoordinate3Batch(GLuint size):
+    _x(size, 0.0), _y(size, 0.0), _z(size, 0.0)
+{
+}
+
+// conversion from an array of points
+DCoordinate3Batch::DCoordinate3Batch(const vector<DCoordinate3>& points):
+    _x(points.size()), _y(points.size()), _z(points.size())
+{
+    if (!points.empty())
+        Load(points.data());
+}
+
+// get/set the number of points
+GLuint DCoordinate3Batch::GetSize() const
+{
+    return static_cast<GLuint>(_x.size());
+}
+
+GLboolean DCoordinate3Batch::Resize(GLuint size)
+{
+    _x.resize(size, 0.0);
+    _y.resize(size, 0.0);
+    _z.resize(size, 0.0);
+
+    return GL_TRUE;
+}
+
+// get/set a point by value
+DCoordinate3 DCoordinate3Batch::operator [](GLuint index) const
+{
+    return DCoordinate3(_x[index], _y[index], _z[index]);
+}
+
+GLvoid DCoordinate3Batch::Set(GLuint index, const DCoordinate3& point)
+{
+    _x[index] = point.x();
+    _y[index] = point.y();
+    _z[index] = point.z();
+}
+
+// load/store an array of size points
+GLvoid DCoordinate3Batch::Load(const DCoordinate3 *points)
+{
+    for (GLuint i = 0; i < _x.size(); ++i)
+    {
+        _x[i] = points[i].x();
+        _y[i] = points[i].y();
+        _z[i] = points[i].z();
+    }
+}
+
+GLvoid DCoordinate3Batch::Store(DCoordinate3 *points) const
+{
+    for (GLuint i = 0; i < _x.size(); ++i)
+    {
+        points[i].x() = _x[i];
+        points[i].y() = _y[i];
+        points[i].z() = _z[i];
+    }
+}
+
+// get component arrays
+GLdouble* DCoordinate3Batch::x()
+{
+    return _x.data();
+}
+
+GLdouble* DCoordinate3Batch::y()
+{
+    return _y.data();
+}
+
+GLdouble* DCoordinate3Batch::z()
+{
+    return _z.data();
+}
+
+const GLdouble* DCoordinate3Batch::x() const
+{
+    return _x.data();
+}
+
+const GLdouble* DCoordinate3Batch::y() const
+{
+    return _y.data();
+}
+
+const GLdouble* DCoordinate3Batch::z() const
+{
+    return _z.data();
+}
+
+// all points are set to the origin
+GLvoid DCoordinate3Batch::LoadNullVectors()
+{
+    fill(_x.begin(), _x.end(), 0.0);
+    fill(_y.begin(), _y.end(), 0.0);
+    fill(_z.begin(), _z.end(), 0.0);
+}
+
+// *this[i] += rhs[i]
+GLboolean DCoordinate3Batch::Add(const DCoordinate3Batch& rhs)
+{
+    if (rhs.GetSize() != GetSize())
+        return GL_FALSE;
+
+    const Kernels &kernels = ActiveKernels();
+    GLuint n = GetSize();
+
+    kernels.add(n, rhs._x.data(), _x.data());
+    kernels.add(n, rhs._y.data(), _y.data());
+    kernels.add(n, rhs._z.data(), _z.data());
+
+    return GL_TRUE;
+}
+
+// *this[i] *= alpha
+GLvoid DCoordinate3Batch::Scale(GLdouble alpha)
+{
+    const Kernels &kernels = ActiveKernels();
+    GLuint n = GetSize();
+
+    kernels.scale(n, alpha, _x.data());
+    kernels.scale(n, alpha, _y.data());
+    kernels.scale(n, alpha, _z.data());
+}
+
+// *this[i] += alpha * rhs[i]
+GLboolean DCoordinate3Batch::MultiplyAdd(GLdouble alpha, const DCoordinate3Batch& rhs)
+{
+    if (rhs.GetSize() != GetSize())
+        return GL_FALSE;
+
+    const Kernels &kernels = ActiveKernels();
+    GLuint n = GetSize();
+
+    kernels.axpy(n, alpha, rhs._x.data(), _x.data());
+    kernels.axpy(n, alpha, rhs._y.data(), _y.data());
+    kernels.axpy(n, alpha, rhs._z.data(), _z.data());
+
+    return GL_TRUE;
+}
+
+// *this[i] += coefficients[i] * point, i.e., the coefficients are scaled by the components of the point
+GLvoid DCoordinate3Batch::MultiplyAdd(const GLdouble *coefficients, const DCoordinate3& point)
+{
+    const Kernels &kernels = ActiveKernels();
+    GLuint n = GetSize();
+
+    kernels.axpy(n, point.x(), coefficients, _x.data());
+    kernels.axpy(n, point.y(), coefficients, _y.data());
+    kernels.axpy(n, point.z(), coefficients, _z.data());
+}
+
+// *this[i] = lhs[i] ^ rhs[i]
+GLboolean DCoordinate3Batch::Cross(const DCoordinate3Batch& lhs, const DCoordinate3Batch& rhs)
+{
+    if (lhs.GetSize() != rhs.GetSize())
+        return GL_FALSE;
+
+    Resize(lhs.GetSize());
+
+    ActiveKernels().cross(GetSize(),
+                          lhs._x.data(), lhs._y.data(), lhs._z.data(),
+                          rhs._x.data(), rhs._y.data(), rhs._z.data(),
+                          _x.data(), _y.data(), _z.data());
+
+    return GL_TRUE;
+}
+
+// result[i] = *this[i] * rhs[i]
+GLboolean DCoordinate3Batch::Dot(const DCoordinate3Batch& rhs, GLdouble *result) const
+{
+    if (rhs.GetSize() != GetSize() || !result)
+        return GL_FALSE;
+
+    ActiveKernels().dot(GetSize(),
+                        _x.data(), _y.data(), _z.data(),
+                        rhs._x.data(), rhs._y.data(), rhs._z.data(),
+                        result);
+
+    return GL_TRUE;
+}
+
+// normalizes all non-null points
+GLvoid DCoordinate3Batch::Normalize()
+{
+    ActiveKernels().normalize(GetSize(), _x.data(), _y.data(), _z.data());
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+#include "DCoordinates3.h"
+
+namespace cagd
+{
+    //------------------------
+    // class DCoordinate3Batch
+    //------------------------
+    // Stores a sequence of Cartesian coordinates as a structure of arrays, i.e., the x, y and z
+    // components of consecutive points are stored in three separate contiguous arrays. Each method
+    // processes the whole batch at once by vectorized kernels. The instruction set of the kernels
+    // (AVX2 with FMA, SSE2 or portable scalar code) is selected at runtime, based on the capabilities
+    // of the processor, the first time it is needed.
+    class DCoordinate3Batch
+    {
+    public:
+        enum InstructionSet {SCALAR = 0, SSE2, AVX2};
+
+    protected:
+        std::vector<GLdouble> _x, _y, _z;
+
+    public:
+        // special/default constructor, all points are initialized to the origin
+        DCoordinate3Batch(GLuint size = 0);
+
+        // conversion from an array of points
+        DCoordinate3Batch(const std::vector<DCoordinate3>& points);
+
+        // get/set the number of points; new points are initialized to the origin
+        GLuint    GetSize() const;
+        GLboolean Resize(GLuint size);
+
+        // get/set a point by value
+        DCoordinate3 operator [](GLuint index) const;
+        GLvoid       Set(GLuint index, const DCoordinate3& point);
+
+        // load/store an array of size points
+        GLvoid Load(const DCoordinate3 *points);
+        GLvoid Store(DCoordinate3 *points) const;
+
+        // get component arrays
+        GLdouble*       x();
+        GLdouble*       y();
+        GLdouble*       z();
+        const GLdouble* x() const;
+        const GLdouble* y() const;
+        const GLdouble* z() const;
+
+        // all points are set to the origin
+        GLvoid LoadNullVectors();
+
+        // *this[i] += rhs[i]
+        GLboolean Add(const DCoordinate3Batch& rhs);
+
+        // *this[i] *= alpha
+        GLvoid Scale(GLdouble alpha);
+
+        // *this[i] += alpha * rhs[i]
+        GLboolean MultiplyAdd(GLdouble alpha, const DCoordinate3Batch& rhs);
+
+        // *this[i] += coefficients[i] * point, e.g., the contribution of a control point weighted by
+        // the values of its blending function at a row of parameters
+        GLvoid MultiplyAdd(const GLdouble *coefficients, const DCoordinate3& point);
+
+        // *this[i] = lhs[i] ^ rhs[i]
+        GLboolean Cross(const DCoordinate3Batch& lhs, const DCoordinate3Batch& rhs);
+
+        // result[i] = *this[i] * rhs[i]
+        GLboolean Dot(const DCoordinate3Batch& rhs, GLdouble *result) const;
+
+        // normalizes all non-null points
+        GLvoid Normalize();
+
+        // get/set the instruction set used by the kernels of all batches; requesting an instruction
+        // set that is not supported by the processor fails
+        static InstructionSet GetInstructionSet();
+        static GLboolean      SetInstructionSet(InstructionSet instruction_set);
+
+        // the widest instruction set supported by the processor
+        static InstructionSet DetectInstructionSet();
+    };
+}
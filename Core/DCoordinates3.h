@@ -6,163 +6,198 @@
 
 namespace cagd
 {
-    //-------------------
-    // class DCoordinate3
-    //-------------------
-    class DCoordinate3
+    //------------------
+    // class Coordinate3
+    //------------------
+    // Cartesian coordinates of scalar type T, e.g., DCoordinate3 (GLdouble) is used by the exact
+    // evaluation of curves and surfaces, while FCoordinate3 (GLfloat) is used by fast previews.
+    template <typename T>
+    class Coordinate3
     {
-        friend const DCoordinate3 operator *(const GLdouble& lhs, const DCoordinate3& rhs);
+        // scale (defined inside the class, thus any argument that is convertible to T is accepted)
+        friend const Coordinate3 operator *(const T& lhs, const Coordinate3& rhs)
+        {
+            return Coordinate3(lhs * rhs._data[0], lhs * rhs._data[1], lhs * rhs._data[2]);
+        }
 
     private:
-        GLdouble _data[3];
+        T _data[3];
 
     public:
 
         // default constructor
-        DCoordinate3();
+        Coordinate3();
 
         // special constructor
-        DCoordinate3(GLdouble x, GLdouble y, GLdouble z = 0.0);
+        Coordinate3(T x, T y, T z = T(0));
+
+        // conversion between scalar types
+        template <typename U>
+        explicit Coordinate3(const Coordinate3<U>& rhs);
 
         // get components by value
-        GLdouble operator [](GLuint index) const;
-        GLdouble x() const;
-        GLdouble y() const;
-        GLdouble z() const;
+        T operator [](GLuint index) const;
+        T x() const;
+        T y() const;
+        T z() const;
 
 
         // get components by reference
-        GLdouble& operator [](GLuint index);
-        GLdouble& x();
-        GLdouble& y();
-        GLdouble& z();
+        T& operator [](GLuint index);
+        T& x();
+        T& y();
+        T& z();
 
         // change sign
-        const DCoordinate3 operator +() const;
-        const DCoordinate3 operator -() const;
+        const Coordinate3 operator +() const;
+        const Coordinate3 operator -() const;
 
         // add
-        const DCoordinate3 operator +(const DCoordinate3& rhs) const;
+        const Coordinate3 operator +(const Coordinate3& rhs) const;
 
         // add to *this
-        DCoordinate3& operator +=(const DCoordinate3& rhs);
+        Coordinate3& operator +=(const Coordinate3& rhs);
 
         // subtract
-        const DCoordinate3 operator -(const DCoordinate3& rhs) const;
+        const Coordinate3 operator -(const Coordinate3& rhs) const;
 
         // subtract from *this
-        DCoordinate3& operator -=(const DCoordinate3& rhs);
+        Coordinate3& operator -=(const Coordinate3& rhs);
 
         // cross product
-        const DCoordinate3 operator ^(const DCoordinate3& rhs) const;
+        const Coordinate3 operator ^(const Coordinate3& rhs) const;
 
         // cross product, result is stored by *this
-        DCoordinate3& operator ^=(const DCoordinate3& rhs);
+        Coordinate3& operator ^=(const Coordinate3& rhs);
 
         // dot product
-        GLdouble operator *(const DCoordinate3& rhs) const;
+        T operator *(const Coordinate3& rhs) const;
 
         // scale
-        const DCoordinate3 operator *(const GLdouble& rhs) const;
-        const DCoordinate3 operator /(const GLdouble& rhs) const;
+        const Coordinate3 operator *(const T& rhs) const;
+        const Coordinate3 operator /(const T& rhs) const;
 
         // scale *this
-        DCoordinate3& operator *=(const GLdouble& rhs);
-        DCoordinate3& operator /=(const GLdouble& rhs);
+        Coordinate3& operator *=(const T& rhs);
+        Coordinate3& operator /=(const T& rhs);
 
         // length
-        GLdouble length() const;
+        T length() const;
 
         // normalize
-        DCoordinate3& normalize();
+        Coordinate3& normalize();
 
         // logical operators
-        GLboolean operator !=(const GLdouble& rhs) const;
+        GLboolean operator !=(const T& rhs) const;
     };
 
-    //-------------------------------------
-    // implementation of class DCoordinate3
-    //-------------------------------------
+    //------------------------------------
+    // implementation of class Coordinate3
+    //------------------------------------
 
     // default constructor
-    inline DCoordinate3::DCoordinate3()
+    template <typename T>
+    inline Coordinate3<T>::Coordinate3()
     {
-        _data[0] = _data[1] = _data[2] = 0.0;
+        _data[0] = _data[1] = _data[2] = T(0);
     }
 
     // special constructor
-    inline DCoordinate3::DCoordinate3(GLdouble x, GLdouble y, GLdouble z)
+    template <typename T>
+    inline Coordinate3<T>::Coordinate3(T x, T y, T z)
     {
         _data[0] = x;
         _data[1] = y;
         _data[2] = z;
     }
 
+    // conversion between scalar types
+    template <typename T>
+    template <typename U>
+    inline Coordinate3<T>::Coordinate3(const Coordinate3<U>& rhs)
+    {
+        _data[0] = static_cast<T>(rhs[0]);
+        _data[1] = static_cast<T>(rhs[1]);
+        _data[2] = static_cast<T>(rhs[2]);
+    }
+
     // get components by value
-    inline GLdouble DCoordinate3::operator [](GLuint index) const
+    template <typename T>
+    inline T Coordinate3<T>::operator [](GLuint index) const
     {
         return _data[index];
     }
 
-    inline GLdouble DCoordinate3::x() const
+    template <typename T>
+    inline T Coordinate3<T>::x() const
     {
         return _data[0];
     }
 
-    inline GLdouble DCoordinate3::y() const
+    template <typename T>
+    inline T Coordinate3<T>::y() const
     {
         // homework
         return _data[1];
     }
 
-    inline GLdouble DCoordinate3::z() const
+    template <typename T>
+    inline T Coordinate3<T>::z() const
     {
         // homework
         return _data[2];
     }
 
     // get components by reference
-    inline GLdouble& DCoordinate3::operator [](GLuint index)
+    template <typename T>
+    inline T& Coordinate3<T>::operator [](GLuint index)
     {
         return _data[index];
     }
 
-    inline GLdouble& DCoordinate3::x()
+    template <typename T>
+    inline T& Coordinate3<T>::x()
     {
         return _data[0];
     }
 
-    inline GLdouble& DCoordinate3::y()
+    template <typename T>
+    inline T& Coordinate3<T>::y()
     {
         // homework
         return _data[1];
     }
 
-    inline GLdouble& DCoordinate3::z()
+    template <typename T>
+    inline T& Coordinate3<T>::z()
     {
         // homework
         return _data[2];
     }
 
     // change sign
-    inline const DCoordinate3 DCoordinate3::operator +() const
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator +() const
     {
-        return DCoordinate3(_data[0], _data[1], _data[2]);
+        return Coordinate3<T>(_data[0], _data[1], _data[2]);
     }
 
-    inline const DCoordinate3 DCoordinate3::operator -() const
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator -() const
     {
-        return DCoordinate3(-_data[0], -_data[1], -_data[2]);
+        return Coordinate3<T>(-_data[0], -_data[1], -_data[2]);
     }
 
     // add
-    inline const DCoordinate3 DCoordinate3::operator +(const DCoordinate3& rhs) const
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator +(const Coordinate3<T>& rhs) const
     {
-        return DCoordinate3(_data[0] + rhs._data[0], _data[1] + rhs._data[1], _data[2] + rhs._data[2]);
+        return Coordinate3<T>(_data[0] + rhs._data[0], _data[1] + rhs._data[1], _data[2] + rhs._data[2]);
     }
 
     // add to *this
-    inline DCoordinate3& DCoordinate3::operator +=(const DCoordinate3& rhs)
+    template <typename T>
+    inline Coordinate3<T>& Coordinate3<T>::operator +=(const Coordinate3<T>& rhs)
     {
         _data[0] += rhs._data[0];
         _data[1] += rhs._data[1];
@@ -171,14 +206,16 @@ namespace cagd
     }
 
     // subtract
-    inline const DCoordinate3 DCoordinate3::operator -(const DCoordinate3& rhs) const
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator -(const Coordinate3<T>& rhs) const
     {
         // homework
-        return DCoordinate3(_data[0] - rhs._data[0], _data[1] - rhs._data[1], _data[2] - rhs._data[2]);
+        return Coordinate3<T>(_data[0] - rhs._data[0], _data[1] - rhs._data[1], _data[2] - rhs._data[2]);
     }
 
     // subtract from *this
-    inline DCoordinate3& DCoordinate3::operator -=(const DCoordinate3& rhs)
+    template <typename T>
+    inline Coordinate3<T>& Coordinate3<T>::operator -=(const Coordinate3<T>& rhs)
     {
         //homework
         _data[0] -= rhs._data[0];
@@ -188,20 +225,22 @@ namespace cagd
     }
 
     // cross product
-    inline const DCoordinate3 DCoordinate3::operator ^(const DCoordinate3& rhs) const
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator ^(const Coordinate3<T>& rhs) const
     {
-        return DCoordinate3(
+        return Coordinate3<T>(
                 _data[1] * rhs._data[2] - _data[2] * rhs._data[1],
                 _data[2] * rhs._data[0] - _data[0] * rhs._data[2],
                 _data[0] * rhs._data[1] - _data[1] * rhs._data[0]);
     }
 
     // cross product, result is stored by *this
-    inline DCoordinate3& DCoordinate3::operator ^=(const DCoordinate3& rhs)
+    template <typename T>
+    inline Coordinate3<T>& Coordinate3<T>::operator ^=(const Coordinate3<T>& rhs)
     {
         // homework
-        GLdouble x = _data[1] * rhs._data[2] - _data[2] * rhs._data[1];
-        GLdouble y = _data[2] * rhs._data[0] - _data[0] * rhs._data[2];
+        T x = _data[1] * rhs._data[2] - _data[2] * rhs._data[1];
+        T y = _data[2] * rhs._data[0] - _data[0] * rhs._data[2];
         _data[2] = _data[0] * rhs._data[1] - _data[1] * rhs._data[0];
         _data[0] = x;
         _data[1] = y;
@@ -209,31 +248,29 @@ namespace cagd
     }
 
     // dot product
-    inline GLdouble DCoordinate3::operator *(const DCoordinate3& rhs) const
+    template <typename T>
+    inline T Coordinate3<T>::operator *(const Coordinate3<T>& rhs) const
     {
         return _data[0] * rhs._data[0] + _data[1] * rhs._data[1] + _data[2] * rhs._data[2];
     }
 
     // scale
-    inline const DCoordinate3 DCoordinate3::operator *(const GLdouble& rhs) const
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator *(const T& rhs) const
     {
-        return DCoordinate3(_data[0] * rhs, _data[1] * rhs, _data[2] * rhs);
+        return Coordinate3<T>(_data[0] * rhs, _data[1] * rhs, _data[2] * rhs);
     }
 
-    inline const DCoordinate3 operator *(const GLdouble& lhs, const DCoordinate3& rhs)
+    template <typename T>
+    inline const Coordinate3<T> Coordinate3<T>::operator /(const T& rhs) const
     {
         // homework
-        return DCoordinate3(lhs * rhs._data[0], lhs * rhs._data[1], lhs * rhs._data[2]);
-    }
-
-    inline const DCoordinate3 DCoordinate3::operator /(const GLdouble& rhs) const
-    {
-        // homework
-        return DCoordinate3(_data[0] / rhs, _data[1] / rhs, _data[2] / rhs);
+        return Coordinate3<T>(_data[0] / rhs, _data[1] / rhs, _data[2] / rhs);
     }
 
     // scale *this
-    inline DCoordinate3& DCoordinate3::operator *=(const GLdouble& rhs)
+    template <typename T>
+    inline Coordinate3<T>& Coordinate3<T>::operator *=(const T& rhs)
     {
         _data[0] *= rhs;
         _data[1] *= rhs;
@@ -242,7 +279,8 @@ namespace cagd
         return *this;
     }
 
-    inline DCoordinate3& DCoordinate3::operator /=(const GLdouble& rhs)
+    template <typename T>
+    inline Coordinate3<T>& Coordinate3<T>::operator /=(const T& rhs)
     {
         // homework
         _data[0] /= rhs;
@@ -253,15 +291,17 @@ namespace cagd
     }
 
     // length
-    inline GLdouble DCoordinate3::length() const
+    template <typename T>
+    inline T Coordinate3<T>::length() const
     {
         return std::sqrt((*this) * (*this));
     }
 
     // normalize
-    inline DCoordinate3& DCoordinate3::normalize()
+    template <typename T>
+    inline Coordinate3<T>& Coordinate3<T>::normalize()
     {
-        GLdouble l = length();
+        T l = length();
 
         if (l && l != 1.0)
             *this /= l;
@@ -270,7 +310,8 @@ namespace cagd
     }
 
     // logical operators
-    inline GLboolean DCoordinate3::operator !=(const GLdouble& rhs) const
+    template <typename T>
+    inline GLboolean Coordinate3<T>::operator !=(const T& rhs) const
     {
         return (_data[0] != rhs || _data[1] != rhs || _data[2] != rhs);
     }
@@ -280,15 +321,21 @@ namespace cagd
     //----------------------------------------------------------------
 
     // output to stream
-    inline std::ostream& operator <<(std::ostream& lhs, const DCoordinate3& rhs)
+    template <typename T>
+    inline std::ostream& operator <<(std::ostream& lhs, const Coordinate3<T>& rhs)
     {
         return lhs << rhs[0] << " " << rhs[1] << " " << rhs[2];
     }
 
     // input from stream
-    inline std::istream& operator >>(std::istream& lhs, DCoordinate3& rhs)
+    template <typename T>
+    inline std::istream& operator >>(std::istream& lhs, Coordinate3<T>& rhs)
     {
         // homework
         return lhs >> rhs[0] >> rhs[1] >> rhs[2];
     }
+
+    // scalar types used by exact evaluations and fast previews, respectively
+    typedef Coordinate3<GLdouble> DCoordinate3;
+    typedef Coordinate3<GLfloat>  FCoordinate3;
 }
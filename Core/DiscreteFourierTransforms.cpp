@@ -0,0 +1,135 @@
+#include "DiscreteFourierTransforms.h"
+#include "Constants.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace cagd;
+using namespace std;
+
+// special/default constructor
+DiscreteFourierTransform::DiscreteFourierTransform(GLuint size):
+    _size(size),
+    _padded_size(1)
+{
+    // powers of two do not need the chirp-z reduction
+    if (!_size || !(_size & (_size - 1)))
+    {
+        _padded_size = _size;
+        return;
+    }
+
+    while (_padded_size < 2 * _size - 1)
+        _padded_size <<= 1;
+
+    // exponents are reduced modulo 2N in order to keep the arguments of sin and cos small
+    _chirp.resize(_size);
+    GLuint64 modulus = 2 * static_cast<GLuint64>(_size);
+    for (GLuint m = 0; m < _size; ++m)
+    {
+        GLuint64 square = (static_cast<GLuint64>(m) * m) % modulus;
+        GLdouble angle = -PI * square / _size;
+        _chirp[m] = Complex(cos(angle), sin(angle));
+    }
+
+    _chirp_spectrum.assign(_padded_size, Complex(0.0, 0.0));
+    _chirp_spectrum[0] = conj(_chirp[0]);
+    for (GLuint m = 1; m < _size; ++m)
+        _chirp_spectrum[m] = _chirp_spectrum[_padded_size - m] = conj(_chirp[m]);
+
+    _RadixTwoTransform(_chirp_spectrum, GL_FALSE);
+}
+
+// in place radix-2 FFT of a power of two long sequence
+GLvoid DiscreteFourierTransform::_RadixTwoTransform(vector<Complex>& values, GLboolean inverse)
+{
+    GLuint n = static_cast<GLuint>(values.size());
+
+    // bit reversal permutation
+    for (GLuint i = 1, j = 0; i < n; ++i)
+    {
+        GLuint bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if (i < j)
+            swap(values[i], values[j]);
+    }
+
+    // butterflies
+    for (GLuint length = 2; length <= n; length <<= 1)
+    {
+        GLdouble angle = (inverse ? TWO_PI : -TWO_PI) / length;
+        Complex  unit_root(cos(angle), sin(angle));
+
+        for (GLuint start = 0; start < n; start += length)
+        {
+            Complex w(1.0, 0.0);
+            for (GLuint k = 0; k < length / 2; ++k)
+            {
+                Complex even = values[start + k];
+                Complex odd  = values[start + k + length / 2] * w;
+
+                values[start + k]              = even + odd;
+                values[start + k + length / 2] = even - odd;
+
+                w *= unit_root;
+            }
+        }
+    }
+}
+
+// get the length of transformed sequences
+GLuint DiscreteFourierTransform::GetSize() const
+{
+    return _size;
+}
+
+// forward transform
+GLboolean DiscreteFourierTransform::Forward(vector<Complex>& values) const
+{
+    if (values.size() != _size)
+        return GL_FALSE;
+
+    if (_padded_size == _size)
+    {
+        _RadixTwoTransform(values, GL_FALSE);
+        return GL_TRUE;
+    }
+
+    // Bluestein: X_k = w_k sum_m (x_m w_m) conj(w_{k-m}), where w_m = e^{-i pi m^2 / N}
+    vector<Complex> a(_padded_size, Complex(0.0, 0.0));
+    for (GLuint m = 0; m < _size; ++m)
+        a[m] = values[m] * _chirp[m];
+
+    _RadixTwoTransform(a, GL_FALSE);
+    for (GLuint k = 0; k < _padded_size; ++k)
+        a[k] *= _chirp_spectrum[k];
+    _RadixTwoTransform(a, GL_TRUE);
+
+    GLdouble scale = 1.0 / _padded_size;
+    for (GLuint k = 0; k < _size; ++k)
+        values[k] = a[k] * _chirp[k] * scale;
+
+    return GL_TRUE;
+}
+
+// inverse transform: x = conj(F(conj(X))) / N
+GLboolean DiscreteFourierTransform::Inverse(vector<Complex>& values) const
+{
+    if (values.size() != _size)
+        return GL_FALSE;
+
+    for (vector<Complex>::iterator it = values.begin(); it != values.end(); ++it)
+        *it = conj(*it);
+
+    if (!Forward(values))
+        return GL_FALSE;
+
+    GLdouble scale = 1.0 / _size;
+    for (vector<Complex>::iterator it = values.begin(); it != values.end(); ++it)
+        *it = conj(*it) * scale;
+
+    return GL_TRUE;
+}
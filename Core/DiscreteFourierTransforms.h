@@ -0,0 +1,45 @@
+#pragma once
+
+#include <complex>
+#include <GL/glew.h>
+#include <vector>
+
+namespace cagd
+{
+    //-------------------------------
+    // class DiscreteFourierTransform
+    //-------------------------------
+    // Evaluates the discrete Fourier transform
+    //
+    // $X_k = \sum_{m=0}^{N-1} x_m e^{-2 \pi i m k / N}, k = 0, 1, ..., N-1$
+    //
+    // and its inverse in O(N log N) operations for an arbitrary size N. Powers of two are handled
+    // by an iterative radix-2 FFT, while other sizes are reduced to a cyclic convolution of
+    // power of two length by means of Bluestein's chirp-z algorithm. Everything that depends only
+    // on N is precomputed by the constructor, thus a single object can be reused for many transforms.
+    class DiscreteFourierTransform
+    {
+    public:
+        typedef std::complex<GLdouble> Complex;
+
+    protected:
+        GLuint               _size;             // N
+        GLuint               _padded_size;      // power of two used by the radix-2 FFT
+        std::vector<Complex> _chirp;            // e^{-i pi m^2 / N}, m = 0, 1, ..., N-1
+        std::vector<Complex> _chirp_spectrum;   // FFT of the zero padded conjugate chirp
+
+        // in place radix-2 FFT of a power of two long sequence
+        static GLvoid _RadixTwoTransform(std::vector<Complex>& values, GLboolean inverse);
+
+    public:
+        // special/default constructor
+        DiscreteFourierTransform(GLuint size = 1);
+
+        // get the length of transformed sequences
+        GLuint GetSize() const;
+
+        // in place transforms, the inverse one includes the normalizing factor 1 / N
+        GLboolean Forward(std::vector<Complex>& values) const;
+        GLboolean Inverse(std::vector<Complex>& values) const;
+    };
+}
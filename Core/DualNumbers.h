@@ -0,0 +1,365 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cmath>
+
+namespace cagd
+{
+    //-----------------
+    // class DualNumber
+    //-----------------
+    // Forward mode automatic differentiation: a dual number stores the value of a function together with its
+    // first order partial derivatives with respect to N independent variables, which are propagated by the
+    // arithmetic operators and elementary functions below according to the chain rule. Thus a function that is
+    // written as a template of its scalar type yields its value and gradient in a single pass.
+    //
+    // The scalar type T may be a dual number itself: DualNumber<DualNumber<GLdouble, 1>, 1> seeded by
+    // Variable(DualNumber<GLdouble, 1>::Variable(u, 0), 0) carries f(u) and f'(u) in its value, as well as
+    // f'(u) and f''(u) in its partial derivative.
+    template <typename T, GLuint N>
+    class DualNumber
+    {
+    private:
+        T _value;
+        T _partial[N];
+
+    public:
+        // special/default constructor, creates a constant (the conversion is implicit, thus GLdouble operands can be
+        // combined with dual numbers)
+        DualNumber(GLdouble value = 0.0);
+
+        // the independent variable of the given index at the given value
+        static DualNumber Variable(const T& value, GLuint variable);
+
+        // the composition g(x), where g_value = g(x.value()) and g_derivative = g'(x.value())
+        static DualNumber Compose(const DualNumber& x, const T& g_value, const T& g_derivative);
+
+        // get value and partial derivatives by value
+        const T& value() const;
+        const T& partial(GLuint variable) const;
+
+        // get value and partial derivatives by reference
+        T& value();
+        T& partial(GLuint variable);
+
+        // change sign
+        const DualNumber operator +() const;
+        const DualNumber operator -() const;
+
+        // arithmetic operations with *this
+        DualNumber& operator +=(const DualNumber& rhs);
+        DualNumber& operator -=(const DualNumber& rhs);
+        DualNumber& operator *=(const DualNumber& rhs);
+        DualNumber& operator /=(const DualNumber& rhs);
+
+        // scale *this, constants do not need the product rule
+        DualNumber& operator *=(GLdouble rhs);
+        DualNumber& operator /=(GLdouble rhs);
+
+        // arithmetic operations, defined inside the class, thus any operand that is convertible to a dual number is
+        // accepted
+        friend const DualNumber operator +(DualNumber lhs, const DualNumber& rhs)
+        {
+            return lhs += rhs;
+        }
+
+        friend const DualNumber operator -(DualNumber lhs, const DualNumber& rhs)
+        {
+            return lhs -= rhs;
+        }
+
+        friend const DualNumber operator *(DualNumber lhs, const DualNumber& rhs)
+        {
+            return lhs *= rhs;
+        }
+
+        friend const DualNumber operator /(DualNumber lhs, const DualNumber& rhs)
+        {
+            return lhs /= rhs;
+        }
+
+        // scale
+        friend const DualNumber operator *(GLdouble lhs, DualNumber rhs)
+        {
+            return rhs *= lhs;
+        }
+
+        friend const DualNumber operator *(DualNumber lhs, GLdouble rhs)
+        {
+            return lhs *= rhs;
+        }
+
+        friend const DualNumber operator /(DualNumber lhs, GLdouble rhs)
+        {
+            return lhs /= rhs;
+        }
+
+        // logical operators compare the values
+        friend GLboolean operator <(const DualNumber& lhs, const DualNumber& rhs)
+        {
+            return lhs._value < rhs._value;
+        }
+
+        friend GLboolean operator >(const DualNumber& lhs, const DualNumber& rhs)
+        {
+            return lhs._value > rhs._value;
+        }
+
+        friend GLboolean operator ==(const DualNumber& lhs, const DualNumber& rhs)
+        {
+            return lhs._value == rhs._value;
+        }
+
+        friend GLboolean operator !=(const DualNumber& lhs, const DualNumber& rhs)
+        {
+            return lhs._value != rhs._value;
+        }
+    };
+
+    //-----------------------------------
+    // implementation of class DualNumber
+    //-----------------------------------
+
+    // special/default constructor
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>::DualNumber(GLdouble value): _value(value)
+    {
+        for (GLuint i = 0; i < N; i++)
+        {
+            _partial[i] = T(0.0);
+        }
+    }
+
+    // the independent variable of the given index at the given value
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> DualNumber<T, N>::Variable(const T& value, GLuint variable)
+    {
+        DualNumber result;
+
+        result._value = value;
+        result._partial[variable] = T(1.0);
+
+        return result;
+    }
+
+    // the composition g(x)
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> DualNumber<T, N>::Compose(const DualNumber& x, const T& g_value, const T& g_derivative)
+    {
+        DualNumber result;
+
+        result._value = g_value;
+
+        for (GLuint i = 0; i < N; i++)
+        {
+            result._partial[i] = g_derivative * x._partial[i];
+        }
+
+        return result;
+    }
+
+    // get value and partial derivatives by value
+    template <typename T, GLuint N>
+    inline const T& DualNumber<T, N>::value() const
+    {
+        return _value;
+    }
+
+    template <typename T, GLuint N>
+    inline const T& DualNumber<T, N>::partial(GLuint variable) const
+    {
+        return _partial[variable];
+    }
+
+    // get value and partial derivatives by reference
+    template <typename T, GLuint N>
+    inline T& DualNumber<T, N>::value()
+    {
+        return _value;
+    }
+
+    template <typename T, GLuint N>
+    inline T& DualNumber<T, N>::partial(GLuint variable)
+    {
+        return _partial[variable];
+    }
+
+    // change sign
+    template <typename T, GLuint N>
+    inline const DualNumber<T, N> DualNumber<T, N>::operator +() const
+    {
+        return *this;
+    }
+
+    template <typename T, GLuint N>
+    inline const DualNumber<T, N> DualNumber<T, N>::operator -() const
+    {
+        DualNumber result;
+
+        result._value = -_value;
+
+        for (GLuint i = 0; i < N; i++)
+        {
+            result._partial[i] = -_partial[i];
+        }
+
+        return result;
+    }
+
+    // arithmetic operations with *this
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>& DualNumber<T, N>::operator +=(const DualNumber& rhs)
+    {
+        _value += rhs._value;
+
+        for (GLuint i = 0; i < N; i++)
+        {
+            _partial[i] += rhs._partial[i];
+        }
+
+        return *this;
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>& DualNumber<T, N>::operator -=(const DualNumber& rhs)
+    {
+        _value -= rhs._value;
+
+        for (GLuint i = 0; i < N; i++)
+        {
+            _partial[i] -= rhs._partial[i];
+        }
+
+        return *this;
+    }
+
+    // product rule
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>& DualNumber<T, N>::operator *=(const DualNumber& rhs)
+    {
+        for (GLuint i = 0; i < N; i++)
+        {
+            _partial[i] = _partial[i] * rhs._value + _value * rhs._partial[i];
+        }
+
+        _value *= rhs._value;
+
+        return *this;
+    }
+
+    // quotient rule: (f / g)' = (f' - (f / g) g') / g
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>& DualNumber<T, N>::operator /=(const DualNumber& rhs)
+    {
+        _value /= rhs._value;
+
+        for (GLuint i = 0; i < N; i++)
+        {
+            _partial[i] = (_partial[i] - _value * rhs._partial[i]) / rhs._value;
+        }
+
+        return *this;
+    }
+
+    // scale *this
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>& DualNumber<T, N>::operator *=(GLdouble rhs)
+    {
+        _value *= rhs;
+
+        for (GLuint i = 0; i < N; i++)
+        {
+            _partial[i] *= rhs;
+        }
+
+        return *this;
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N>& DualNumber<T, N>::operator /=(GLdouble rhs)
+    {
+        return *this *= 1.0 / rhs;
+    }
+
+    //-------------------------------------
+    // elementary functions of dual numbers
+    //-------------------------------------
+
+    // both the sine and the cosine are needed by the derivatives, thus they are evaluated together
+    inline GLvoid SinCos(GLdouble x, GLdouble& s, GLdouble& c)
+    {
+        s = std::sin(x);
+        c = std::cos(x);
+    }
+
+    template <typename T, GLuint N>
+    inline GLvoid SinCos(const DualNumber<T, N>& x, DualNumber<T, N>& s, DualNumber<T, N>& c)
+    {
+        T sv, cv;
+        SinCos(x.value(), sv, cv);
+
+        s = DualNumber<T, N>::Compose(x, sv, cv);
+        c = DualNumber<T, N>::Compose(x, cv, -sv);
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> sin(const DualNumber<T, N>& x)
+    {
+        T sv, cv;
+        SinCos(x.value(), sv, cv);
+
+        return DualNumber<T, N>::Compose(x, sv, cv);
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> cos(const DualNumber<T, N>& x)
+    {
+        T sv, cv;
+        SinCos(x.value(), sv, cv);
+
+        return DualNumber<T, N>::Compose(x, cv, -sv);
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> tan(const DualNumber<T, N>& x)
+    {
+        using std::tan;
+        T t = tan(x.value());
+
+        return DualNumber<T, N>::Compose(x, t, 1.0 + t * t);
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> exp(const DualNumber<T, N>& x)
+    {
+        using std::exp;
+        T e = exp(x.value());
+
+        return DualNumber<T, N>::Compose(x, e, e);
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> log(const DualNumber<T, N>& x)
+    {
+        using std::log;
+
+        return DualNumber<T, N>::Compose(x, log(x.value()), 1.0 / x.value());
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> sqrt(const DualNumber<T, N>& x)
+    {
+        using std::sqrt;
+        T r = sqrt(x.value());
+
+        return DualNumber<T, N>::Compose(x, r, 0.5 / r);
+    }
+
+    template <typename T, GLuint N>
+    inline DualNumber<T, N> pow(const DualNumber<T, N>& x, GLdouble exponent)
+    {
+        using std::pow;
+
+        return DualNumber<T, N>::Compose(x, pow(x.value(), exponent), exponent * pow(x.value(), exponent - 1.0));
+    }
+}
@@ -1,5 +1,7 @@
 #include "GenericCurves3.h"
 
+#include <vector>
+
 using namespace cagd;
 using namespace std;
 
@@ -159,11 +161,14 @@ GLboolean GenericCurve3::UpdateVertexBufferObjects(GLdouble scale, GLenum usage_
         return GL_FALSE;
     }
 
+    // the curve points are stored contiguously in the zeroth row of the matrix _derivative
+    const DCoordinate3 *point = _derivative.Row(0).data();
+
     for (GLuint i = 0; i < curve_point_count; ++i)
     {
         for (GLuint j = 0; j < 3; ++j)
         {
-            *coordinate = (GLfloat)_derivative(0,i)[j];
+            *coordinate = (GLfloat)point[i][j];
             ++coordinate;
         }
     }
@@ -192,14 +197,16 @@ GLboolean GenericCurve3::UpdateVertexBufferObjects(GLdouble scale, GLenum usage_
             return GL_FALSE;
         }
 
+        const DCoordinate3 *derivative = _derivative.Row(d).data();
+
         for (GLuint i = 0; i < curve_point_count; ++i)
         {
-            DCoordinate3 sum = _derivative(0, i);
-            sum += scale * _derivative(d, i);
+            DCoordinate3 sum = point[i];
+            sum += scale * derivative[i];
 
             for (GLint j = 0; j < 3; ++j)
             {
-                *coordinate = (GLfloat)_derivative(0, i)[j];
+                *coordinate = (GLfloat)point[i][j];
                 *(coordinate + 3) = (GLfloat)sum[j];
                 ++coordinate;
             }
@@ -220,6 +227,64 @@ GLboolean GenericCurve3::UpdateVertexBufferObjects(GLdouble scale, GLenum usage_
     return GL_TRUE;
 }
 
+GLboolean GenericCurve3::UpdateVertexBufferObjectsInPlace(GLdouble scale)
+{
+    GLuint order_count = _derivative.GetRowCount();
+
+    for (GLuint d = 0; d < order_count; ++d)
+    {
+        if (!_vbo_derivative(d))
+            return UpdateVertexBufferObjects(scale, _usage_flag);
+    }
+
+    GLuint curve_point_count = _derivative.GetColumnCount();
+
+    if (!curve_point_count)
+        return GL_TRUE;
+
+    // the staging array is large enough for the line segments of higher order derivatives
+    vector<GLfloat> coordinates(6 * curve_point_count);
+
+    // curve points
+    const DCoordinate3 *point = _derivative.Row(0).data();
+
+    for (GLuint i = 0; i < curve_point_count; ++i)
+    {
+        for (GLuint j = 0; j < 3; ++j)
+        {
+            coordinates[3 * i + j] = (GLfloat)point[i][j];
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_derivative(0));
+    glBufferSubData(GL_ARRAY_BUFFER, 0, 3 * curve_point_count * sizeof(GLfloat), &coordinates[0]);
+
+    // higher order derivatives
+    for (GLuint d = 1; d < order_count; ++d)
+    {
+        const DCoordinate3 *derivative = _derivative.Row(d).data();
+
+        for (GLuint i = 0; i < curve_point_count; ++i)
+        {
+            DCoordinate3 sum = point[i];
+            sum += scale * derivative[i];
+
+            for (GLuint j = 0; j < 3; ++j)
+            {
+                coordinates[6 * i + j]     = (GLfloat)point[i][j];
+                coordinates[6 * i + 3 + j] = (GLfloat)sum[j];
+            }
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo_derivative(d));
+        glBufferSubData(GL_ARRAY_BUFFER, 0, 6 * curve_point_count * sizeof(GLfloat), &coordinates[0]);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return GL_TRUE;
+}
+
 GLfloat* GenericCurve3::MapDerivatives(GLuint order, GLenum access_mode) const
 {
     if (order >= _derivative.GetRowCount())
@@ -315,6 +380,25 @@ GLenum GenericCurve3::GetUsageFlag() const
     return _usage_flag;
 }
 
+GLboolean GenericCurve3::Transform(const HomogeneousTransformation3& transformation)
+{
+    if (!transformation.IsAffine())
+        return GL_FALSE;
+
+    GLuint point_count = _derivative.GetColumnCount();
+
+    if (!point_count)
+        return GL_TRUE;
+
+    // the rows of the derivative matrix are stored contiguously
+    transformation.TransformPoints(point_count, _derivative.data());
+
+    for (GLuint order = 1; order < _derivative.GetRowCount(); order++)
+        transformation.TransformDirections(point_count, _derivative.data() + order * point_count);
+
+    return GL_TRUE;
+}
+
 // destructor
 GenericCurve3::~GenericCurve3()
 {
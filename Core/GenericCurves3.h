@@ -2,6 +2,7 @@
 
 #include "DCoordinates3.h"
 #include <GL/glew.h>
+#include "HomogeneousTransformations3.h"
 #include "Matrices.h"
 #include <iostream>
 
@@ -46,6 +47,11 @@ namespace cagd
         GLboolean RenderDerivatives(GLuint order, GLenum render_mode) const;
         GLboolean UpdateVertexBufferObjects(GLdouble scale = 0.2, GLenum usage_flag = GL_STATIC_DRAW);
 
+        // overwrites the contents of the existing vertex buffer objects by means of glBufferSubData,
+        // i.e., without reallocating them (e.g., after incremental updates of the derivatives); if the
+        // buffers do not exist yet, they are created with the current usage flag
+        GLboolean UpdateVertexBufferObjectsInPlace(GLdouble scale = 0.2);
+
         GLfloat* MapDerivatives(GLuint order, GLenum access_mode = GL_READ_ONLY) const;
         GLboolean UnmapDerivatives(GLuint order) const;
 
@@ -65,6 +71,11 @@ namespace cagd
         GLuint GetPointCount() const;
         GLenum GetUsageFlag() const;
 
+        // transforms the points (row 0) and all derivatives (rows 1, 2, ...) of the curve, the latter
+        // by the linear part of the transformation; fails for projective transformations, since these
+        // do not map derivatives linearly; vertex buffer objects have to be updated by the caller
+        GLboolean Transform(const HomogeneousTransformation3& transformation);
+
         // destructor
         virtual ~GenericCurve3();
     };
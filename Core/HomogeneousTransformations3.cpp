@@ -0,0 +1,305 @@
+#include "HomogeneousTransformations3.h"
+
+#include <cmath>
+
+using namespace cagd;
+using namespace std;
+
+// default constructor, generates the identity transformation
+HomogeneousTransformation3::HomogeneousTransformation3()
+{
+    for (GLuint i = 0; i < 4; i++)
+        _matrix(i, i) = 1.0;
+}
+
+// special transformations
+HomogeneousTransformation3 HomogeneousTransformation3::Translation(GLdouble dx, GLdouble dy, GLdouble dz)
+{
+    HomogeneousTransformation3 result;
+
+    result._matrix(0, 3) = dx;
+    result._matrix(1, 3) = dy;
+    result._matrix(2, 3) = dz;
+
+    return result;
+}
+
+HomogeneousTransformation3 HomogeneousTransformation3::Scaling(GLdouble sx, GLdouble sy, GLdouble sz)
+{
+    HomogeneousTransformation3 result;
+
+    result._matrix(0, 0) = sx;
+    result._matrix(1, 1) = sy;
+    result._matrix(2, 2) = sz;
+
+    return result;
+}
+
+// rotation by angle (in radians) about the given axis that passes through the origin (Rodrigues' formula)
+HomogeneousTransformation3 HomogeneousTransformation3::Rotation(const DCoordinate3& axis, GLdouble angle)
+{
+    HomogeneousTransformation3 result;
+
+    GLdouble length = axis.length();
+
+    if (length == 0.0)
+        return result;
+
+    DCoordinate3 k = axis / length;
+
+    GLdouble c = cos(angle), s = sin(angle), t = 1.0 - c;
+
+    result._matrix(0, 0) = t * k[0] * k[0] + c;
+    result._matrix(0, 1) = t * k[0] * k[1] - s * k[2];
+    result._matrix(0, 2) = t * k[0] * k[2] + s * k[1];
+
+    result._matrix(1, 0) = t * k[1] * k[0] + s * k[2];
+    result._matrix(1, 1) = t * k[1] * k[1] + c;
+    result._matrix(1, 2) = t * k[1] * k[2] - s * k[0];
+
+    result._matrix(2, 0) = t * k[2] * k[0] - s * k[1];
+    result._matrix(2, 1) = t * k[2] * k[1] + s * k[0];
+    result._matrix(2, 2) = t * k[2] * k[2] + c;
+
+    return result;
+}
+
+// get elements by value/reference
+GLdouble HomogeneousTransformation3::operator ()(GLuint row, GLuint column) const
+{
+    return _matrix(row, column);
+}
+
+GLdouble& HomogeneousTransformation3::operator ()(GLuint row, GLuint column)
+{
+    return _matrix(row, column);
+}
+
+// composition
+const HomogeneousTransformation3 HomogeneousTransformation3::operator *(const HomogeneousTransformation3& rhs) const
+{
+    HomogeneousTransformation3 result;
+
+    for (GLuint i = 0; i < 4; i++)
+    {
+        for (GLuint j = 0; j < 4; j++)
+        {
+            GLdouble sum = 0.0;
+            for (GLuint k = 0; k < 4; k++)
+                sum += _matrix(i, k) * rhs._matrix(k, j);
+            result._matrix(i, j) = sum;
+        }
+    }
+
+    return result;
+}
+
+// is the last row (0, 0, 0, 1)?
+GLboolean HomogeneousTransformation3::IsAffine() const
+{
+    return _matrix(3, 0) == 0.0 && _matrix(3, 1) == 0.0 && _matrix(3, 2) == 0.0 && _matrix(3, 3) == 1.0;
+}
+
+// the inverse transpose of the upper left 3x3 block equals its cofactor matrix divided by its determinant
+GLboolean HomogeneousTransformation3::InverseTransposeOfLinearPart(Matrix<GLdouble, 3, 3>& result) const
+{
+    const Matrix<GLdouble, 4, 4>& m = _matrix;
+
+    for (GLuint i = 0; i < 3; i++)
+    {
+        GLuint i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+
+        for (GLuint j = 0; j < 3; j++)
+        {
+            GLuint j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+
+            // cyclic index shifts give the signs of the cofactors automatically
+            result(i, j) = m(i1, j1) * m(i2, j2) - m(i1, j2) * m(i2, j1);
+        }
+    }
+
+    GLdouble determinant = m(0, 0) * result(0, 0) + m(0, 1) * result(0, 1) + m(0, 2) * result(0, 2);
+
+    if (determinant == 0.0)
+        return GL_FALSE;
+
+    for (GLuint i = 0; i < 3; i++)
+        for (GLuint j = 0; j < 3; j++)
+            result(i, j) /= determinant;
+
+    return GL_TRUE;
+}
+
+// transformation of single coordinates
+HCoordinate3 HomogeneousTransformation3::operator *(const HCoordinate3& rhs) const
+{
+    HCoordinate3 result;
+
+    for (GLuint i = 0; i < 4; i++)
+    {
+        GLdouble sum = 0.0;
+        for (GLuint j = 0; j < 4; j++)
+            sum += _matrix(i, j) * rhs[j];
+        result[i] = static_cast<GLfloat>(sum);
+    }
+
+    return result;
+}
+
+DCoordinate3 HomogeneousTransformation3::operator *(const DCoordinate3& rhs) const
+{
+    DCoordinate3 result(rhs);
+    TransformPoints(1, &result);
+    return result;
+}
+
+// batched kernels
+GLvoid HomogeneousTransformation3::TransformHomogeneousCoordinates(GLuint count, HCoordinate3 *coordinates) const
+{
+    GLfloat m[16];
+    for (GLuint i = 0; i < 16; i++)
+        m[i] = static_cast<GLfloat>(_matrix.data()[i]);
+
+    GLint block_count = static_cast<GLint>((count + _block_size - 1) / _block_size);
+
+    #pragma omp parallel for schedule(static) if(count >= _parallel_threshold)
+    for (GLint b = 0; b < block_count; b++)
+    {
+        GLuint first = b * _block_size, last = min(count, first + _block_size);
+
+        #pragma omp simd
+        for (GLuint i = first; i < last; i++)
+        {
+            HCoordinate3 &h = coordinates[i];
+
+            GLfloat x = h[0], y = h[1], z = h[2], w = h[3];
+
+            h[0] = m[ 0] * x + m[ 1] * y + m[ 2] * z + m[ 3] * w;
+            h[1] = m[ 4] * x + m[ 5] * y + m[ 6] * z + m[ 7] * w;
+            h[2] = m[ 8] * x + m[ 9] * y + m[10] * z + m[11] * w;
+            h[3] = m[12] * x + m[13] * y + m[14] * z + m[15] * w;
+        }
+    }
+}
+
+GLvoid HomogeneousTransformation3::TransformPoints(GLuint count, DCoordinate3 *points) const
+{
+    const GLdouble *m = _matrix.data();
+
+    GLboolean affine = IsAffine();
+    GLint     block_count = static_cast<GLint>((count + _block_size - 1) / _block_size);
+
+    #pragma omp parallel for schedule(static) if(count >= _parallel_threshold)
+    for (GLint b = 0; b < block_count; b++)
+    {
+        GLuint first = b * _block_size, last = min(count, first + _block_size);
+
+        if (affine)
+        {
+            #pragma omp simd
+            for (GLuint i = first; i < last; i++)
+            {
+                DCoordinate3 &p = points[i];
+
+                GLdouble x = p[0], y = p[1], z = p[2];
+
+                p[0] = m[0] * x + m[1] * y + m[ 2] * z + m[ 3];
+                p[1] = m[4] * x + m[5] * y + m[ 6] * z + m[ 7];
+                p[2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+            }
+        }
+        else
+        {
+            #pragma omp simd
+            for (GLuint i = first; i < last; i++)
+            {
+                DCoordinate3 &p = points[i];
+
+                GLdouble x = p[0], y = p[1], z = p[2];
+                GLdouble w = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+                p[0] = (m[0] * x + m[1] * y + m[ 2] * z + m[ 3]) / w;
+                p[1] = (m[4] * x + m[5] * y + m[ 6] * z + m[ 7]) / w;
+                p[2] = (m[8] * x + m[9] * y + m[10] * z + m[11]) / w;
+            }
+        }
+    }
+}
+
+GLboolean HomogeneousTransformation3::TransformDirections(GLuint count, DCoordinate3 *directions) const
+{
+    if (!IsAffine())
+        return GL_FALSE;
+
+    const GLdouble *m = _matrix.data();
+
+    GLint block_count = static_cast<GLint>((count + _block_size - 1) / _block_size);
+
+    #pragma omp parallel for schedule(static) if(count >= _parallel_threshold)
+    for (GLint b = 0; b < block_count; b++)
+    {
+        GLuint first = b * _block_size, last = min(count, first + _block_size);
+
+        #pragma omp simd
+        for (GLuint i = first; i < last; i++)
+        {
+            DCoordinate3 &d = directions[i];
+
+            GLdouble x = d[0], y = d[1], z = d[2];
+
+            d[0] = m[0] * x + m[1] * y + m[ 2] * z;
+            d[1] = m[4] * x + m[5] * y + m[ 6] * z;
+            d[2] = m[8] * x + m[9] * y + m[10] * z;
+        }
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean HomogeneousTransformation3::TransformNormals(GLuint count, DCoordinate3 *normals) const
+{
+    Matrix<GLdouble, 3, 3> inverse_transpose;
+
+    if (!IsAffine() || !InverseTransposeOfLinearPart(inverse_transpose))
+        return GL_FALSE;
+
+    const GLdouble *n = inverse_transpose.data();
+
+    // the cross product of the transformed partial derivatives of a surface is det(L) * L^{-T} (s_u x s_v),
+    // where L denotes the linear part, thus reflections (det(L) < 0, i.e., det(L^{-T}) < 0) also reverse the
+    // orientation of the normals, like a new tessellation of the transformed surface would do
+    GLdouble determinant = n[0] * (n[4] * n[8] - n[5] * n[7]) -
+                           n[1] * (n[3] * n[8] - n[5] * n[6]) +
+                           n[2] * (n[3] * n[7] - n[4] * n[6]);
+
+    GLdouble orientation = (determinant < 0.0) ? -1.0 : 1.0;
+
+    GLint block_count = static_cast<GLint>((count + _block_size - 1) / _block_size);
+
+    #pragma omp parallel for schedule(static) if(count >= _parallel_threshold)
+    for (GLint b = 0; b < block_count; b++)
+    {
+        GLuint first = b * _block_size, last = min(count, first + _block_size);
+
+        #pragma omp simd
+        for (GLuint i = first; i < last; i++)
+        {
+            DCoordinate3 &normal = normals[i];
+
+            GLdouble x = normal[0], y = normal[1], z = normal[2];
+
+            GLdouble nx = n[0] * x + n[1] * y + n[2] * z;
+            GLdouble ny = n[3] * x + n[4] * y + n[5] * z;
+            GLdouble nz = n[6] * x + n[7] * y + n[8] * z;
+
+            GLdouble length = sqrt(nx * nx + ny * ny + nz * nz);
+            GLdouble scale  = (length != 0.0) ? orientation / length : 0.0;
+
+            normal[0] = nx * scale;
+            normal[1] = ny * scale;
+            normal[2] = nz * scale;
+        }
+    }
+
+    return GL_TRUE;
+}
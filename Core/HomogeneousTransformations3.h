@@ -0,0 +1,68 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "DCoordinates3.h"
+#include "HCoordinates3.h"
+#include "Matrices.h"
+
+namespace cagd
+{
+    //---------------------------------
+    // class HomogeneousTransformation3
+    //---------------------------------
+    // 4x4 matrices of homogeneous transformations. Apart from single coordinates, whole arrays of
+    // points, directions (e.g., derivatives of curves) and unit normal vectors can be transformed
+    // in one pass. The kernels traverse the arrays in blocks: the points of a block are processed
+    // by vectorizable loops, while the blocks of large arrays are distributed among OpenMP threads.
+    class HomogeneousTransformation3
+    {
+    protected:
+        Matrix<GLdouble, 4, 4> _matrix;
+
+        static const GLuint _block_size = 1024;            // points per block
+        static const GLuint _parallel_threshold = 16384;   // minimal point count for threading
+
+    public:
+        // default constructor, generates the identity transformation
+        HomogeneousTransformation3();
+
+        // special transformations
+        static HomogeneousTransformation3 Translation(GLdouble dx, GLdouble dy, GLdouble dz);
+        static HomogeneousTransformation3 Scaling(GLdouble sx, GLdouble sy, GLdouble sz);
+
+        // rotation by angle (in radians) about the given axis that passes through the origin
+        static HomogeneousTransformation3 Rotation(const DCoordinate3& axis, GLdouble angle);
+
+        // get elements by value/reference
+        GLdouble  operator ()(GLuint row, GLuint column) const;
+        GLdouble& operator ()(GLuint row, GLuint column);
+
+        // composition, i.e., (lhs * rhs)(p) = lhs(rhs(p))
+        const HomogeneousTransformation3 operator *(const HomogeneousTransformation3& rhs) const;
+
+        // is the last row (0, 0, 0, 1)?
+        GLboolean IsAffine() const;
+
+        // the inverse transpose of the upper left 3x3 block (i.e., the transformation of normal
+        // vectors), fails if the block is singular
+        GLboolean InverseTransposeOfLinearPart(Matrix<GLdouble, 3, 3>& result) const;
+
+        // transformation of single coordinates, points are divided by their homogeneous coordinate
+        HCoordinate3 operator *(const HCoordinate3& rhs) const;
+        DCoordinate3 operator *(const DCoordinate3& rhs) const;
+
+        // batched kernels:
+        // - homogeneous coordinates are transformed in single precision;
+        // - points are considered with homogeneous coordinate 1 and divided by their transformed
+        //   homogeneous coordinate, unless the transformation is affine;
+        // - directions (e.g., tangents or higher order derivatives) are transformed by the upper left
+        //   3x3 block, thus projective transformations are not allowed;
+        // - normal vectors are transformed by the inverse transpose of the upper left 3x3 block and
+        //   renormalized, which fails for projective transformations and singular blocks; they are
+        //   reversed by reflections, i.e., if the determinant of the block is negative.
+        GLvoid    TransformHomogeneousCoordinates(GLuint count, HCoordinate3 *coordinates) const;
+        GLvoid    TransformPoints(GLuint count, DCoordinate3 *points) const;
+        GLboolean TransformDirections(GLuint count, DCoordinate3 *directions) const;
+        GLboolean TransformNormals(GLuint count, DCoordinate3 *normals) const;
+    };
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <list>
+#include <mutex>
+#include <utility>
+
+namespace cagd
+{
+    //------------------------
+    // template class LRUCache
+    //------------------------
+    // Stores the values of the most recently used keys. Keys have to be comparable by the operator ==, values are
+    // usually shared pointers, since the default constructed value (e.g., a null pointer) is returned if a key is
+    // not found. The caches are small, therefore the keys are searched linearly, which is cheaper than maintaining
+    // a hash table. If the cache is full, the value of the least recently used key is discarded. Every method is
+    // thread-safe.
+    template <typename Key, typename Value>
+    class LRUCache
+    {
+    protected:
+        typedef std::pair<Key, Value> Entry;
+
+        GLuint              _capacity;
+        std::list<Entry>    _entries;           // ordered from the most to the least recently used one
+        GLuint64            _hit_count, _miss_count;
+        mutable std::mutex  _mutex;
+
+    public:
+        // special/default constructor
+        LRUCache(GLuint capacity = 16);
+
+        // returns the cached value that belongs to the given key or a default constructed one;
+        // updates the hit/miss counters
+        Value Find(const Key& key);
+
+        // stores a value, default constructed (e.g., null) values are ignored
+        GLvoid Insert(const Key& key, const Value& value);
+
+        // set/get the maximal number of stored values
+        GLvoid SetCapacity(GLuint capacity);
+        GLuint GetCapacity() const;
+
+        // get the number of stored values
+        GLuint GetSize() const;
+
+        // statistics
+        GLuint64 GetHitCount() const;
+        GLuint64 GetMissCount() const;
+        GLvoid   ResetCounters();
+
+        // removes all stored values
+        GLvoid Clear();
+    };
+
+    //------------------------------------------
+    // implementation of template class LRUCache
+    //------------------------------------------
+
+    // special/default constructor
+    template <typename Key, typename Value>
+    LRUCache<Key, Value>::LRUCache(GLuint capacity):
+        _capacity(capacity),
+        _hit_count(0),
+        _miss_count(0)
+    {
+    }
+
+    // returns the cached value that belongs to the given key or a default constructed one
+    template <typename Key, typename Value>
+    Value LRUCache<Key, Value>::Find(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (typename std::list<Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            if (it->first == key)
+            {
+                // the found entry becomes the most recently used one
+                _entries.splice(_entries.begin(), _entries, it);
+                ++_hit_count;
+                return _entries.front().second;
+            }
+        }
+
+        ++_miss_count;
+        return Value();
+    }
+
+    // stores a value
+    template <typename Key, typename Value>
+    GLvoid LRUCache<Key, Value>::Insert(const Key& key, const Value& value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!_capacity || !value)
+            return;
+
+        for (typename std::list<Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            if (it->first == key)
+            {
+                _entries.erase(it);
+                break;
+            }
+        }
+
+        _entries.push_front(Entry(key, value));
+
+        while (_entries.size() > _capacity)
+            _entries.pop_back();
+    }
+
+    // set/get the maximal number of stored values
+    template <typename Key, typename Value>
+    GLvoid LRUCache<Key, Value>::SetCapacity(GLuint capacity)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _capacity = capacity;
+
+        while (_entries.size() > _capacity)
+            _entries.pop_back();
+    }
+
+    template <typename Key, typename Value>
+    GLuint LRUCache<Key, Value>::GetCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+    // get the number of stored values
+    template <typename Key, typename Value>
+    GLuint LRUCache<Key, Value>::GetSize() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return static_cast<GLuint>(_entries.size());
+    }
+
+    // statistics
+    template <typename Key, typename Value>
+    GLuint64 LRUCache<Key, Value>::GetHitCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _hit_count;
+    }
+
+    template <typename Key, typename Value>
+    GLuint64 LRUCache<Key, Value>::GetMissCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _miss_count;
+    }
+
+    template <typename Key, typename Value>
+    GLvoid LRUCache<Key, Value>::ResetCounters()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _hit_count = _miss_count = 0;
+    }
+
+    // removes all stored values
+    template <typename Key, typename Value>
+    GLvoid LRUCache<Key, Value>::Clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+    }
+}
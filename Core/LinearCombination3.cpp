@@ -1,5 +1,8 @@
 #include "LinearCombination3.h"
 #include "RealSquareMatrices.h"
+#include <algorithm>
+#include <memory>
+#include <typeinfo>
 
 namespace cagd {
     // special/default constructor
@@ -28,7 +31,7 @@ namespace cagd {
         for (GLuint i = 0; i < _data.size(); ++i)
         {
             for (GLuint j = 0; j < 3; ++j)
-                _data[i][0][j] = 0.0;
+                _data[i][j] = 0.0;
         }
     }
 
@@ -37,7 +40,8 @@ namespace cagd {
             _vbo_data(0),
             _data_usage_flag(data_usage_flag),
             _u_min(u_min), _u_max(u_max),
-            _data(data_count)
+            _data(data_count),
+            _data_version(0)
     {
     }
 
@@ -46,7 +50,8 @@ namespace cagd {
             _vbo_data(0),
             _data_usage_flag(lc._data_usage_flag),
             _u_min(lc._u_min), _u_max(lc._u_max),
-            _data(lc._data)
+            _data(lc._data),
+            _data_version(0)
     {
         if (lc._vbo_data)
             UpdateVertexBufferObjectsOfData(_data_usage_flag);
@@ -63,6 +68,7 @@ namespace cagd {
             _u_min = rhs._u_min;
             _u_max = rhs._u_max;
             _data = rhs._data;
+            ++_data_version;
 
             if (rhs._vbo_data)
                 UpdateVertexBufferObjectsOfData(_data_usage_flag);
@@ -160,6 +166,7 @@ namespace cagd {
     // get data by reference
     DCoordinate3& LinearCombination3::operator [](GLuint index)
     {
+        ++_data_version;
         return _data[index];
     }
 
@@ -174,18 +181,165 @@ namespace cagd {
             data_count != data_points_to_interpolate.GetRowCount())
             return GL_FALSE;
 
-        RealSquareMatrix collocation_matrix(data_count);
+        std::vector<GLdouble> shape_parameters;
+        shape_parameters.push_back(_u_min);
+        shape_parameters.push_back(_u_max);
+        _AppendShapeParameters(shape_parameters);
 
-        RowMatrix<GLdouble> current_blending_function_values(data_count);
-        for (GLuint r = 0; r < knot_vector.GetRowCount(); ++r)
+        CollocationKey key(typeid(*this), 0, shape_parameters, knot_vector);
+
+        std::shared_ptr<RealSquareMatrix> collocation_matrix = _collocation_cache.Find(key);
+
+        if (!collocation_matrix)
         {
-            if (!BlendingFunctionValues(knot_vector(r), current_blending_function_values))
+            collocation_matrix = std::make_shared<RealSquareMatrix>(data_count);
+
+            RowMatrix<GLdouble> current_blending_function_values(data_count);
+            for (GLuint r = 0; r < knot_vector.GetRowCount(); ++r)
+            {
+                if (!BlendingFunctionValues(knot_vector(r), current_blending_function_values))
+                    return GL_FALSE;
+                else
+                    collocation_matrix->SetRow(r, current_blending_function_values);
+            }
+
+            if (!collocation_matrix->PerformLUDecomposition())
                 return GL_FALSE;
-            else
-                collocation_matrix.SetRow(r, current_blending_function_values);
+
+            _collocation_cache.Insert(key, collocation_matrix);
+        }
+
+        ++_data_version;
+        return collocation_matrix->SolveLinearSystem(data_points_to_interpolate, _data);
+    }
+
+    // the default basis has no shape parameters besides its definition domain
+    GLvoid LinearCombination3::_AppendShapeParameters(std::vector<GLdouble>&) const
+    {
+    }
+
+    // the cache of collocation matrices
+    CollocationFactorizationCache LinearCombination3::_collocation_cache;
+
+    CollocationFactorizationCache& LinearCombination3::GetCollocationCache()
+    {
+        return _collocation_cache;
+    }
+
+    // the cache of blending function tables
+    BlendingFunctionTableCache LinearCombination3::_blending_function_table_cache;
+
+    BlendingFunctionTableCache& LinearCombination3::GetBlendingFunctionTableCache()
+    {
+        return _blending_function_table_cache;
+    }
+
+    // by default, tables of blending function derivatives are not available
+    GLboolean LinearCombination3::BlendingFunctionDerivatives(GLuint, GLdouble, Matrix<GLdouble>&) const
+    {
+        return GL_FALSE;
+    }
+
+    // the table of blending function derivatives at the given parameter values
+    std::shared_ptr<const Matrix<GLdouble> > LinearCombination3::GetBlendingFunctionTable(
+            GLuint max_order_of_derivatives, const ColumnMatrix<GLdouble>& parameters) const
+    {
+        GLuint data_count = _data.GetRowCount();
+        GLuint parameter_count = parameters.GetRowCount();
+        GLuint order_count = max_order_of_derivatives + 1;
+
+        if (!parameter_count)
+            return std::shared_ptr<const Matrix<GLdouble> >();
+
+        std::vector<GLdouble> shape_parameters;
+        shape_parameters.push_back(_u_min);
+        shape_parameters.push_back(_u_max);
+        _AppendShapeParameters(shape_parameters);
+        shape_parameters.push_back(data_count);
+        shape_parameters.push_back(max_order_of_derivatives);
+
+        CollocationKey key(typeid(*this), 0, shape_parameters, parameters);
+
+        std::shared_ptr<const Matrix<GLdouble> > table = _blending_function_table_cache.Find(key);
+
+        if (table)
+            return table;
+
+        Matrix<GLdouble> derivatives;
+
+        // bases that do not provide tables are recognized before allocating the table
+        if (!BlendingFunctionDerivatives(max_order_of_derivatives, parameters(0), derivatives))
+            return std::shared_ptr<const Matrix<GLdouble> >();
+
+        std::shared_ptr<Matrix<GLdouble> > new_table = std::make_shared<Matrix<GLdouble> >(parameter_count * order_count, data_count);
+
+        for (GLuint k = 0; k < parameter_count; ++k)
+        {
+            if ((k && !BlendingFunctionDerivatives(max_order_of_derivatives, parameters(k), derivatives)) ||
+                derivatives.GetRowCount() != order_count || derivatives.GetColumnCount() != data_count)
+                return std::shared_ptr<const Matrix<GLdouble> >();
+
+            std::copy(derivatives.data(), derivatives.data() + order_count * data_count,
+                      new_table->data() + k * order_count * data_count);
+        }
+
+        _blending_function_table_cache.Insert(key, new_table);
+
+        return new_table;
+    }
+
+    // evaluates the points and the higher order derivatives at all given parameter values
+    GLboolean LinearCombination3::EvaluateMany(
+            const ColumnMatrix<GLdouble>& parameters, GLuint max_order_of_derivatives,
+            Matrix<DCoordinate3>& derivatives) const
+    {
+        GLuint data_count = _data.GetRowCount();
+        GLuint parameter_count = parameters.GetRowCount();
+        GLuint order_count = max_order_of_derivatives + 1;
+
+        if (!derivatives.ResizeRows(order_count) || !derivatives.ResizeColumns(parameter_count))
+            return GL_FALSE;
+
+        std::shared_ptr<const Matrix<GLdouble> > table = GetBlendingFunctionTable(max_order_of_derivatives, parameters);
+
+        if (!table)
+        {
+            Derivatives d(max_order_of_derivatives);
+
+            for (GLuint k = 0; k < parameter_count; ++k)
+            {
+                if (!CalculateDerivatives(max_order_of_derivatives, parameters(k), d))
+                    return GL_FALSE;
+
+                derivatives.SetColumn(k, d);
+            }
+
+            return GL_TRUE;
+        }
+
+        // (parameter_count * order_count) x data_count times data_count x 3 matrix product
+        const GLdouble *blending_values = table->data();
+
+        for (GLuint k = 0; k < parameter_count; ++k)
+        {
+            for (GLuint r = 0; r < order_count; ++r, blending_values += data_count)
+            {
+                GLdouble x = 0.0, y = 0.0, z = 0.0;
+
+                for (GLuint i = 0; i < data_count; ++i)
+                {
+                    const DCoordinate3 &d = _data[i];
+
+                    x += blending_values[i] * d[0];
+                    y += blending_values[i] * d[1];
+                    z += blending_values[i] * d[2];
+                }
+
+                derivatives(r, k) = DCoordinate3(x, y, z);
+            }
         }
 
-        return collocation_matrix.SolveLinearSystem(data_points_to_interpolate, _data);
+        return GL_TRUE;
     }
 
 
@@ -202,6 +356,18 @@ namespace cagd {
         u_max = _u_max;
     }
 
+    // transforms the data points
+    GLboolean LinearCombination3::TransformData(const HomogeneousTransformation3& transformation)
+    {
+        if (!transformation.IsAffine())
+            return GL_FALSE;
+
+        transformation.TransformPoints(_data.GetRowCount(), _data.data());
+        ++_data_version;
+
+        return GL_TRUE;
+    }
+
     // generate image/arc
     GenericCurve3* LinearCombination3::GenerateImage(GLuint max_order_of_derivatives, GLuint div_point_count, GLenum usage_flag) const
     {
@@ -214,31 +380,229 @@ namespace cagd {
             return nullptr;
         }
 
-        GLdouble u_step = (_u_max - _u_min) / (div_point_count - 1);
-        GLdouble u = _u_min;
+        if (_EvaluateUniformly(max_order_of_derivatives, div_point_count, result->_derivative))
+        {
+            return result;
+        }
 
-        Derivatives d(max_order_of_derivatives);
+        ColumnMatrix<GLdouble> parameters;
+        _GenerateUniformParameters(div_point_count, parameters);
 
-        for (GLuint i = 0; i < div_point_count - 1; i++)
+        if (!EvaluateMany(parameters, max_order_of_derivatives, result->_derivative))
+        {
+            delete result;
+            result = nullptr;
+        }
+
+        return result;
+    }
+
+    namespace
+    {
+        // evaluates the point and the derivatives of a linear combination for the adaptive sampler
+        class LinearCombinationEvaluator
+        {
+        protected:
+            const LinearCombination3&               _lc;
+            GLuint                                  _max_order_of_derivatives;
+            mutable LinearCombination3::Derivatives _d;
+
+        public:
+            LinearCombinationEvaluator(const LinearCombination3& lc, GLuint max_order_of_derivatives):
+                _lc(lc), _max_order_of_derivatives(max_order_of_derivatives), _d(max_order_of_derivatives)
+            {
+            }
+
+            GLboolean operator ()(GLdouble u, DCoordinate3 *d) const
+            {
+                if (!_lc.CalculateDerivatives(_max_order_of_derivatives, u, _d))
+                    return GL_FALSE;
+
+                for (GLuint r = 0; r <= _max_order_of_derivatives; ++r)
+                    d[r] = _d[r];
+
+                return GL_TRUE;
+            }
+        };
+    }
+
+    // generates an image with a variable number of points
+    GenericCurve3* LinearCombination3::GenerateAdaptiveImage(
+            GLuint max_order_of_derivatives, GLdouble chord_tolerance, GLdouble angular_tolerance,
+            GLenum usage_flag) const
+    {
+        GLuint evaluated_order = std::max(max_order_of_derivatives, 1u);
+
+        AdaptiveCurveSampler sampler(chord_tolerance, angular_tolerance);
+
+        return sampler.GenerateImage(
+                LinearCombinationEvaluator(*this, evaluated_order), _u_min, _u_max,
+                evaluated_order + 1, max_order_of_derivatives, usage_flag);
+    }
+
+    namespace
+    {
+        // the length of the first order derivative of a linear combination
+        class LinearCombinationSpeed
+        {
+        protected:
+            const LinearCombination3&               _lc;
+            mutable LinearCombination3::Derivatives _d;
+
+        public:
+            LinearCombinationSpeed(const LinearCombination3& lc): _lc(lc), _d(1)
+            {
+            }
+
+            GLdouble operator ()(GLdouble u) const
+            {
+                return _lc.CalculateDerivatives(1, u, _d) ? _d[1].length() : 0.0;
+            }
+        };
+    }
+
+    // returns the arc length parametrization, rebuilds it if the data or the definition domain has changed
+    std::shared_ptr<const LinearCombination3::ArcLengthParametrization> LinearCombination3::_GetArcLengthParametrization() const
+    {
+        std::lock_guard<std::mutex> lock(_arc_length_mutex);
+
+        if (_arc_length && _arc_length->u_min == _u_min && _arc_length->u_max == _u_max &&
+            _arc_length->data_version == _data_version)
+        {
+            return _arc_length;
+        }
+
+        std::shared_ptr<ArcLengthParametrization> arc_length = std::make_shared<ArcLengthParametrization>();
+
+        arc_length->u_min = _u_min;
+        arc_length->u_max = _u_max;
+        arc_length->data_version = _data_version;
+
+        if (!arc_length->table.Build(LinearCombinationSpeed(*this), _u_min, _u_max))
+        {
+            return std::shared_ptr<const ArcLengthParametrization>();
+        }
+
+        _arc_length = arc_length;
+
+        return _arc_length;
+    }
+
+    // total length of the linear combination
+    GLdouble LinearCombination3::GetArcLength() const
+    {
+        std::shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+        return arc_length ? arc_length->table.GetLength() : 0.0;
+    }
+
+    // arc length s(u)
+    GLdouble LinearCombination3::ArcLength(GLdouble u) const
+    {
+        std::shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+        return arc_length ? arc_length->table.ArcLength(LinearCombinationSpeed(*this), u) : 0.0;
+    }
+
+    // parameter value u(s)
+    GLdouble LinearCombination3::ParameterAtArcLength(GLdouble s) const
+    {
+        std::shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+        return arc_length ? arc_length->table.Parameter(LinearCombinationSpeed(*this), s) : _u_min;
+    }
+
+    // generates an image whose points are distributed uniformly with respect to the arc length
+    GenericCurve3* LinearCombination3::GenerateArcLengthImage(GLuint max_order_of_derivatives, GLuint div_point_count, GLenum usage_flag) const
+    {
+        if (div_point_count < 2)
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+        if (!arc_length)
+        {
+            return nullptr;
+        }
+
+        GenericCurve3* result = new (std::nothrow) GenericCurve3(max_order_of_derivatives, div_point_count, usage_flag);
+
+        if (!result)
+        {
+            return nullptr;
+        }
+
+        LinearCombinationSpeed speed(*this);
+        GLdouble               s_step = arc_length->table.GetLength() / (div_point_count - 1);
+        Derivatives            d(max_order_of_derivatives);
+
+        for (GLuint i = 0; i < div_point_count; ++i)
         {
+            GLdouble u = (i == div_point_count - 1) ? _u_max : arc_length->table.Parameter(speed, i * s_step);
+
             if (!CalculateDerivatives(max_order_of_derivatives, u, d))
             {
                 delete result;
-                result = nullptr;
-                return result;
+                return nullptr;
             }
+
             result->_derivative.SetColumn(i, d);
-            u += u_step;
         }
-        if (!CalculateDerivatives(max_order_of_derivatives, _u_max, d))
+
+        return result;
+    }
+
+    // the uniform subdivision of the definition domain used by the method GenerateImage
+    GLvoid LinearCombination3::_GenerateUniformParameters(GLuint div_point_count, ColumnMatrix<GLdouble>& parameters) const
+    {
+        parameters.ResizeRows(div_point_count);
+
+        GLdouble u_step = (_u_max - _u_min) / (div_point_count - 1);
+
+        for (GLuint i = 0; i < div_point_count - 1; i++)
         {
-            delete result;
-            result = nullptr;
-            return result;
+            parameters(i) = _u_min + i * u_step;
         }
-        result->_derivative.SetColumn(div_point_count - 1, d);
+        parameters(div_point_count - 1) = _u_max;
+    }
 
-        return result;
+    // there is no specialized evaluation along the uniform subdivision by default
+    GLboolean LinearCombination3::_EvaluateUniformly(GLuint, GLuint, Matrix<DCoordinate3>&) const
+    {
+        return GL_FALSE;
+    }
+
+    // updates an image generated by the method GenerateImage after a data point has been changed
+    GLboolean LinearCombination3::UpdateImageForDataChange(GLuint index, const DCoordinate3& delta, GenericCurve3& image) const
+    {
+        GLuint data_count = _data.GetRowCount();
+        GLuint div_point_count = image._derivative.GetColumnCount();
+        GLuint order_count = image._derivative.GetRowCount();
+
+        if (index >= data_count || div_point_count < 2 || !order_count)
+            return GL_FALSE;
+
+        ColumnMatrix<GLdouble> parameters;
+        _GenerateUniformParameters(div_point_count, parameters);
+
+        std::shared_ptr<const Matrix<GLdouble> > table = GetBlendingFunctionTable(order_count - 1, parameters);
+
+        if (!table)
+            return GL_FALSE;
+
+        const GLdouble *blending_values = table->data() + index;
+
+        for (GLuint k = 0; k < div_point_count; ++k)
+        {
+            for (GLuint r = 0; r < order_count; ++r, blending_values += data_count)
+            {
+                image._derivative(r, k) += *blending_values * delta;
+            }
+        }
+
+        return GL_TRUE;
     }
 
     // destructor
@@ -259,6 +623,7 @@ namespace cagd {
     {
         lhs >> rhs._u_min >> rhs._u_max;
         lhs >> rhs._data;
+        ++rhs._data_version;
 
         return lhs;
     }
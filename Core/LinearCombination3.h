@@ -1,8 +1,16 @@
 #pragma once
 
+#include "AdaptiveCurveSamplers.h"
+#include "ArcLengthTables.h"
+#include "BlendingFunctionTableCaches.h"
+#include "CollocationFactorizationCaches.h"
 #include "DCoordinates3.h"
 #include "GenericCurves3.h"
+#include "HomogeneousTransformations3.h"
 #include "Matrices.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace cagd
 {
@@ -36,12 +44,51 @@ namespace cagd
             GLvoid LoadNullVectors();
         };
 
+        // the arc length table together with the definition domain and the version of the data it was built from
+        class ArcLengthParametrization
+        {
+        public:
+            GLdouble                    u_min, u_max;
+            GLuint                      data_version;
+            ArcLengthTable              table;
+        };
+
     protected:
         GLuint                      _vbo_data;
         GLenum                      _data_usage_flag;
         GLdouble                    _u_min, _u_max;
         ColumnMatrix<DCoordinate3>  _data;
 
+        // incremented whenever the data may have changed, i.e., by every non-const access to the data points,
+        // thus derived classes that modify _data directly have to increment it, too
+        GLuint                      _data_version;
+
+        // LU decompositions of recently used collocation matrices, shared by all linear combinations
+        static CollocationFactorizationCache _collocation_cache;
+
+        // Besides the definition domain, the blending functions may depend on further shape parameters,
+        // which are part of the keys of cached collocation matrices. Derived classes that have such
+        // parameters (other than the number of blending functions) have to append them to the vector.
+        virtual GLvoid _AppendShapeParameters(std::vector<GLdouble>& shape_parameters) const;
+
+        // tables of blending function values and derivatives, shared by all linear combinations
+        static BlendingFunctionTableCache _blending_function_table_cache;
+
+        // arc length parametrization, rebuilt at the first query after the data or the domain has changed
+        mutable std::shared_ptr<const ArcLengthParametrization> _arc_length;
+        mutable std::mutex                                      _arc_length_mutex;
+
+        std::shared_ptr<const ArcLengthParametrization> _GetArcLengthParametrization() const;
+
+        // the uniform subdivision of the definition domain used by the method GenerateImage
+        GLvoid _GenerateUniformParameters(GLuint div_point_count, ColumnMatrix<GLdouble>& parameters) const;
+
+        // derived classes that can evaluate themselves faster along the uniform subdivision above (e.g., by
+        // forward differencing) may override this method, it is tried first by GenerateImage; the rows of the
+        // matrix have to be filled like the ones of EvaluateMany; the default implementation returns GL_FALSE
+        virtual GLboolean _EvaluateUniformly(
+                GLuint max_order_of_derivatives, GLuint div_point_count, Matrix<DCoordinate3>& derivatives) const;
+
     public:
         // special constructor
         LinearCombination3(
@@ -63,13 +110,18 @@ namespace cagd
         // get data by value
         DCoordinate3 operator [](GLuint index) const;
 
-        // get data by reference
+        // get data by reference (it counts as a change of the data, therefore references should not be kept
+        // across queries of the arc length)
         DCoordinate3& operator [](GLuint index);
 
         // set/get definition domain
         GLvoid SetDefinitionDomain(GLdouble u_min, GLdouble u_max);
         GLvoid GetDefinitionDomain(GLdouble& u_min, GLdouble& u_max) const;
 
+        // transforms the data points; due to the affine invariance of the basis, the image of the
+        // combination is transformed accordingly, thus projective transformations are rejected
+        GLboolean TransformData(const HomogeneousTransformation3& transformation);
+
         //----------------
         // abstract method
         //----------------
@@ -83,12 +135,64 @@ namespace cagd
         // combination sum_{i=0}^{data_count -1} _data[i] F_i(u) at the parameter value u
         virtual GLboolean CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u, Derivatives& d) const = 0;
 
+        // the r-th row of the matrix stores the r-th order derivatives of all blending functions at the
+        // parameter value u; the default implementation reports that such tables are not available, in
+        // which case curve points are evaluated one by one by means of the method CalculateDerivatives
+        virtual GLboolean BlendingFunctionDerivatives(GLuint max_order_of_derivatives, GLdouble u, Matrix<GLdouble>& derivatives) const;
+
+        // the table of blending function derivatives at the given parameter values, its row
+        // k * (max_order_of_derivatives + 1) + r stores the r-th order derivatives of all blending functions
+        // at parameters[k]; tables are cached, thus curves of the same type, shape parameters and resolution
+        // share them; returns a null pointer if the method BlendingFunctionDerivatives is not supported
+        std::shared_ptr<const Matrix<GLdouble> > GetBlendingFunctionTable(
+                GLuint max_order_of_derivatives, const ColumnMatrix<GLdouble>& parameters) const;
+
+        // evaluates the points (row 0) and the higher order derivatives (rows 1, 2, ...) of the linear
+        // combination at all given parameter values (columns), which is a small dense matrix product if a
+        // table of blending functions is available
+        virtual GLboolean EvaluateMany(
+                const ColumnMatrix<GLdouble>& parameters, GLuint max_order_of_derivatives,
+                Matrix<DCoordinate3>& derivatives) const;
+
         // generate image/arc
         virtual GenericCurve3* GenerateImage(GLuint max_order_of_derivatives, GLuint div_point_count, GLenum usage_flag = GL_STATIC_DRAW) const;
 
-        // assure interpolation
+        // generates an image with a variable number of points: the uniform subdivision is refined until the
+        // chord and angular tolerances (in radians) are met, see the class AdaptiveCurveSampler; tangents are
+        // evaluated even if max_order_of_derivatives = 0, since the refinement criteria depend on them
+        GenericCurve3* GenerateAdaptiveImage(
+                GLuint max_order_of_derivatives, GLdouble chord_tolerance, GLdouble angular_tolerance,
+                GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // arc length s(u) = int_{u_min}^{u} |c'(t)| dt, its inverse and the total length of the combination;
+        // the table of the arc length function is built on demand from first order derivatives, and rebuilt
+        // lazily, i.e., at the first query after the data or the definition domain has changed
+        GLdouble GetArcLength() const;
+        GLdouble ArcLength(GLdouble u) const;
+        GLdouble ParameterAtArcLength(GLdouble s) const;
+
+        // generates an image whose points are distributed uniformly with respect to the arc length
+        GenericCurve3* GenerateArcLengthImage(
+                GLuint max_order_of_derivatives, GLuint div_point_count,
+                GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // updates an image generated by the method GenerateImage after the data point with the given index
+        // has been changed by delta; since the image depends linearly on the data, each point and derivative
+        // moves by delta times the corresponding derivative of the index-th blending function, which costs
+        // O(div_point_count * (max_order_of_derivatives + 1)) operations; fails if blending function tables
+        // are not available, in which case the image has to be regenerated
+        GLboolean UpdateImageForDataChange(GLuint index, const DCoordinate3& delta, GenericCurve3& image) const;
+
+        // assure interpolation (the LU decomposition of the collocation matrix is reused as long as the
+        // basis and the knot vector do not change)
         virtual GLboolean UpdateDataForInterpolation(const ColumnMatrix<GLdouble>& knot_vector, const ColumnMatrix<DCoordinate3>& data_points_to_interpolate);
 
+        // the cache of collocation matrices, e.g., its hit/miss counters can be queried
+        static CollocationFactorizationCache& GetCollocationCache();
+
+        // the cache of blending function tables
+        static BlendingFunctionTableCache& GetBlendingFunctionTableCache();
+
         // destructor
         virtual ~LinearCombination3();
     };
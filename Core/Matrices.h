@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <GL/glew.h>
@@ -7,8 +8,14 @@
 
 namespace cagd
 {
-    // forward declaration of template class Matrix
+    // forward declaration of template class StridedView
     template <typename T>
+    class StridedView;
+
+    // forward declaration of template class Matrix
+    // (zero dimensions select the dynamically sized, heap-backed variant,
+    // while positive ones select a fixed-size variant that lives on the stack)
+    template <typename T, GLuint row_count = 0, GLuint column_count = 0>
     class Matrix;
 
     // forward declaration of template class RowMatrix
@@ -20,7 +27,8 @@ namespace cagd
     class ColumnMatrix;
 
 	// forward declaration of template class TriangularMatrix
-    template <typename T>
+    // (similarly, a zero row count selects the dynamically sized variant)
+    template <typename T, GLuint row_count = 0>
     class TriangularMatrix;
 
     // forward declarations of overloaded and templated input/output from/to stream operators
@@ -36,19 +44,50 @@ namespace cagd
     template <typename T>
     std::ostream& operator << (std::ostream& lhs, const TriangularMatrix<T>& rhs);
 
+    //---------------------------
+    // template class StridedView
+    //---------------------------
+    // a non-owning view of count elements that are stride elements apart from each other,
+    // used to access a row (stride = 1) or a column (stride = column count) of a matrix
+    // without copying; the view is invalidated by any resize of the underlying matrix
+    template <typename T>
+    class StridedView
+    {
+    protected:
+        T      *_first;
+        GLuint _count;
+        GLuint _stride;
+
+    public:
+        // special constructor
+        StridedView(T *first, GLuint count, GLuint stride = 1);
+
+        // get element by reference
+        T& operator ()(GLuint index) const;
+        T& operator [](GLuint index) const;
+
+        // get dimension and distance between consecutive elements
+        GLuint GetCount() const;
+        GLuint GetStride() const;
+
+        // raw pointer to the first element
+        T* data() const;
+    };
+
     //----------------------
     // template class Matrix
     //----------------------
+    // elements are stored in a single contiguous row-major buffer
     template <typename T>
-    class Matrix
+    class Matrix<T, 0, 0>
     {
         friend std::ostream& operator << <T>(std::ostream&, const Matrix<T>& rhs);
         friend std::istream& operator >> <T>(std::istream&, Matrix<T>& rhs);
 
     protected:
-        GLuint                          _row_count;
-        GLuint                          _column_count;
-        std::vector< std::vector<T> >   _data;
+        GLuint          _row_count;
+        GLuint          _column_count;
+        std::vector<T>  _data;
     public:
         // special constructor (can also be used as a default constructor)
         Matrix(GLuint row_count = 1, GLuint column_count = 1);
@@ -77,6 +116,16 @@ namespace cagd
         GLboolean SetRow(GLuint index, const RowMatrix<T>& row);
         GLboolean SetColumn(GLuint index, const ColumnMatrix<T>& column);
 
+        // strided views of a row or a column
+        StridedView<T>       Row(GLuint index);
+        StridedView<const T> Row(GLuint index) const;
+        StridedView<T>       Column(GLuint index);
+        StridedView<const T> Column(GLuint index) const;
+
+        // raw pointer to the row-major buffer
+        T*       data();
+        const T* data() const;
+
         // destructor
         virtual ~Matrix();
     };
@@ -129,14 +178,14 @@ namespace cagd
     // template class TriangularMatrix
     //--------------------------------
     template <typename T>
-    class TriangularMatrix
+    class TriangularMatrix<T, 0>
     {
         friend std::istream& operator >> <T>(std::istream&, TriangularMatrix<T>& rhs);
         friend std::ostream& operator << <T>(std::ostream&, const TriangularMatrix<T>& rhs);
 
     protected:
-        GLuint                        _row_count;
-        std::vector< std::vector<T> > _data;
+        GLuint          _row_count;
+        std::vector<T>  _data;      // packed rows, row r starts at offset r * (r + 1) / 2
 
     public:
         // special constructor (can also be used as a default constructor)
@@ -153,8 +202,132 @@ namespace cagd
 
         // set dimension
         GLboolean ResizeRows(GLuint row_count);
+
+        // view of the row-th row that consists of row + 1 elements
+        StridedView<T>       Row(GLuint row);
+        StridedView<const T> Row(GLuint row) const;
+
+        // raw pointer to the packed buffer
+        T*       data();
+        const T* data() const;
+    };
+
+    //------------------------------------------
+    // fixed-size template class Matrix<T, R, C>
+    //------------------------------------------
+    // the dimensions are compile-time constants and the elements are stored in an array member,
+    // therefore the matrix can be placed on the stack and loops over its elements can be fully
+    // unrolled by the compiler; it is meant for small blending tables and control nets
+    template <typename T, GLuint row_count, GLuint column_count>
+    class Matrix
+    {
+    protected:
+        T _data[row_count * column_count];
+
+    public:
+        // default constructor, every element is value-initialized
+        Matrix();
+
+        // get element by reference
+        T& operator ()(GLuint row, GLuint column);
+
+        // get copy of an element
+        T operator ()(GLuint row, GLuint column) const;
+
+        // get dimensions
+        static GLuint GetRowCount();
+        static GLuint GetColumnCount();
+
+        // strided views of a row or a column
+        StridedView<T>       Row(GLuint index);
+        StridedView<const T> Row(GLuint index) const;
+        StridedView<T>       Column(GLuint index);
+        StridedView<const T> Column(GLuint index) const;
+
+        // raw pointer to the row-major array
+        T*       data();
+        const T* data() const;
+    };
+
+    //-------------------------------------------------
+    // fixed-size template class TriangularMatrix<T, N>
+    //-------------------------------------------------
+    template <typename T, GLuint row_count>
+    class TriangularMatrix
+    {
+    protected:
+        T _data[row_count * (row_count + 1) / 2];
+
+    public:
+        // default constructor, every element is value-initialized
+        TriangularMatrix();
+
+        // get element by reference
+        T& operator ()(GLuint row, GLuint column);
+
+        // get copy of an element
+        T operator ()(GLuint row, GLuint column) const;
+
+        // get dimension
+        static GLuint GetRowCount();
+
+        // view of the row-th row that consists of row + 1 elements
+        StridedView<T>       Row(GLuint row);
+        StridedView<const T> Row(GLuint row) const;
+
+        // raw pointer to the packed array
+        T*       data();
+        const T* data() const;
     };
 
+    //---------------------------------------------
+    // implementation of template class StridedView
+    //---------------------------------------------
+
+    // special constructor
+    template <typename T>
+    StridedView<T>::StridedView(T *first, GLuint count, GLuint stride):
+        _first(first),
+        _count(count),
+        _stride(stride)
+    {
+    }
+
+    // get element by reference
+    template <typename T>
+    T& StridedView<T>::operator ()(GLuint index) const
+    {
+        assert(index < _count);
+        return _first[index * _stride];
+    }
+
+    template <typename T>
+    T& StridedView<T>::operator [](GLuint index) const
+    {
+        assert(index < _count);
+        return _first[index * _stride];
+    }
+
+    // get dimension and distance between consecutive elements
+    template <typename T>
+    GLuint StridedView<T>::GetCount() const
+    {
+        return _count;
+    }
+
+    template <typename T>
+    GLuint StridedView<T>::GetStride() const
+    {
+        return _stride;
+    }
+
+    // raw pointer to the first element
+    template <typename T>
+    T* StridedView<T>::data() const
+    {
+        return _first;
+    }
+
     //--------------------------------------------------
     // homework: implementation of template class Matrix
     //--------------------------------------------------
@@ -164,7 +337,7 @@ namespace cagd
     Matrix<T>::Matrix(GLuint row_count, GLuint column_count):
         _row_count(row_count),
         _column_count(column_count),
-        _data(row_count, std::vector<T>(column_count))
+        _data(row_count * column_count)
     {
     }
 
@@ -195,7 +368,7 @@ namespace cagd
     T& Matrix<T>::operator ()(GLuint row, GLuint column)
     {
         assert(row < _row_count && column < _column_count);
-        return _data[row][column];
+        return _data[row * _column_count + column];
     }
 
     // get element by reference
@@ -203,7 +376,7 @@ namespace cagd
     T Matrix<T>::operator ()(GLuint row, GLuint column) const
     {
         assert(row < _row_count && column < _column_count);
-        return _data[row][column];
+        return _data[row * _column_count + column];
     }
 
     // get dimensions
@@ -224,17 +397,27 @@ namespace cagd
     template <typename T>
     GLboolean Matrix<T>::ResizeRows(GLuint row_count)
     {
+        // rows are stored one after the other, so existing rows keep their positions
         _row_count = row_count;
-        _data.resize(row_count, std::vector<T>(_column_count));
+        _data.resize(row_count * _column_count);
         return GL_TRUE;
     }
     template <typename T>
     GLboolean Matrix<T>::ResizeColumns(GLuint column_count)
     {
+        if (column_count == _column_count)
+            return GL_TRUE;
+
+        // the row length changes, therefore the common prefix of each row has to be relocated
+        std::vector<T> data(_row_count * column_count);
+        GLuint common_column_count = std::min(_column_count, column_count);
+        for (GLuint row = 0; row < _row_count; ++row)
+            std::copy(_data.begin() + row * _column_count,
+                      _data.begin() + row * _column_count + common_column_count,
+                      data.begin() + row * column_count);
+
+        _data.swap(data);
         _column_count = column_count;
-        for (typename std::vector< std::vector<T> >::iterator row = _data.begin();
-             row != _data.end(); ++row)
-            row->resize(column_count);
         return GL_TRUE;
     }
 
@@ -245,7 +428,7 @@ namespace cagd
         if(index >= _row_count || _column_count != row._column_count)
             return GL_FALSE;
 
-        _data[index] = row._data[0];
+        std::copy(row._data.begin(), row._data.end(), _data.begin() + index * _column_count);
 
         return GL_TRUE;
     }
@@ -256,10 +439,48 @@ namespace cagd
             return GL_FALSE;
 
         for(GLuint row = 0; row < _row_count; ++row)
-            _data[row][index] = column._data[row][0];
+            _data[row * _column_count + index] = column._data[row];
         return GL_TRUE;
     }
 
+    // strided views of a row or a column
+    template <typename T>
+    StridedView<T> Matrix<T>::Row(GLuint index)
+    {
+        assert(index < _row_count);
+        return StridedView<T>(_data.data() + index * _column_count, _column_count);
+    }
+    template <typename T>
+    StridedView<const T> Matrix<T>::Row(GLuint index) const
+    {
+        assert(index < _row_count);
+        return StridedView<const T>(_data.data() + index * _column_count, _column_count);
+    }
+    template <typename T>
+    StridedView<T> Matrix<T>::Column(GLuint index)
+    {
+        assert(index < _column_count);
+        return StridedView<T>(_data.data() + index, _row_count, _column_count);
+    }
+    template <typename T>
+    StridedView<const T> Matrix<T>::Column(GLuint index) const
+    {
+        assert(index < _column_count);
+        return StridedView<const T>(_data.data() + index, _row_count, _column_count);
+    }
+
+    // raw pointer to the row-major buffer
+    template <typename T>
+    T* Matrix<T>::data()
+    {
+        return _data.data();
+    }
+    template <typename T>
+    const T* Matrix<T>::data() const
+    {
+        return _data.data();
+    }
+
     // destructor
     template <typename T>
     Matrix<T>::~Matrix()
@@ -284,25 +505,25 @@ namespace cagd
     T& RowMatrix<T>::operator ()(GLuint column)
     {
         assert(column < Matrix<T>::_column_count);
-        return this->_data[0][column];
+        return this->_data[column];
     }
     template <typename T>
     T& RowMatrix<T>::operator [](GLuint column)
     {
         assert(column < Matrix<T>::_column_count);
-        return this->_data[0][column];
+        return this->_data[column];
     }
 
     // get copy of an element
     template <typename T>
     T RowMatrix<T>::operator ()(GLuint column) const
     {
-        return this->_data[0][column];
+        return this->_data[column];
     }
     template <typename T>
     T RowMatrix<T>::operator [](GLuint column) const
     {
-        return this->_data[0][column];
+        return this->_data[column];
     }
 
     // a row matrix consists of a single row
@@ -328,25 +549,25 @@ namespace cagd
     T& ColumnMatrix<T>::operator ()(GLuint row)
     {
         assert(row < Matrix<T>::_row_count);
-        return this->_data[row][0];
+        return this->_data[row];
     }
     template <typename T>
     T& ColumnMatrix<T>::operator [](GLuint row)
     {
         assert(row < Matrix<T>::_row_count);
-        return this->_data[row][0];
+        return this->_data[row];
     }
 
     // get copy of an element
     template <typename T>
     T ColumnMatrix<T>::operator ()(GLuint row) const
     {
-        return this->_data[row][0];
+        return this->_data[row];
     }
     template <typename T>
     T ColumnMatrix<T>::operator [](GLuint row) const
     {
-        return this->_data[row][0];
+        return this->_data[row];
     }
 
     // a row matrix consists of a single row
@@ -364,10 +585,8 @@ namespace cagd
     template <typename T>
     TriangularMatrix<T>::TriangularMatrix(GLuint row_count):
         _row_count(row_count),
-        _data(_row_count)
+        _data(row_count * (row_count + 1) / 2)
     {
-        for(GLuint row = 0; row < row_count; ++row)
-            _data[row].resize(row + 1);
     }
 
     // get element by reference
@@ -375,7 +594,7 @@ namespace cagd
     T& TriangularMatrix<T>::operator ()(GLuint row, GLuint column)
     {
         assert(row < _row_count && column <= row);
-        return _data[row][column];
+        return _data[row * (row + 1) / 2 + column];
     }
 
     // get copy of an element
@@ -383,7 +602,7 @@ namespace cagd
     T TriangularMatrix<T>::operator ()(GLuint row, GLuint column) const
     {
         assert(row < _row_count && column <= row);
-        return _data[row][column];
+        return _data[row * (row + 1) / 2 + column];
     }
 
     // get dimension
@@ -395,16 +614,178 @@ namespace cagd
 
     // set dimension
     template <typename T>
-     GLboolean TriangularMatrix<T>::ResizeRows(GLuint row_count)
+    GLboolean TriangularMatrix<T>::ResizeRows(GLuint row_count)
     {
-        _data.resize(row_count);
-        for(GLuint row = _row_count; row < row_count; ++row)
-            _data[row].resize(row + 1);
+        // packed rows keep their offsets, thus existing elements are preserved
+        _data.resize(row_count * (row_count + 1) / 2);
         _row_count = row_count;
 
         return GL_TRUE;
     }
 
+    // view of the row-th row
+    template <typename T>
+    StridedView<T> TriangularMatrix<T>::Row(GLuint row)
+    {
+        assert(row < _row_count);
+        return StridedView<T>(_data.data() + row * (row + 1) / 2, row + 1);
+    }
+    template <typename T>
+    StridedView<const T> TriangularMatrix<T>::Row(GLuint row) const
+    {
+        assert(row < _row_count);
+        return StridedView<const T>(_data.data() + row * (row + 1) / 2, row + 1);
+    }
+
+    // raw pointer to the packed buffer
+    template <typename T>
+    T* TriangularMatrix<T>::data()
+    {
+        return _data.data();
+    }
+    template <typename T>
+    const T* TriangularMatrix<T>::data() const
+    {
+        return _data.data();
+    }
+
+    //------------------------------------------------------------
+    // implementation of fixed-size template class Matrix<T, R, C>
+    //------------------------------------------------------------
+
+    // default constructor
+    template <typename T, GLuint row_count, GLuint column_count>
+    Matrix<T, row_count, column_count>::Matrix():
+        _data()
+    {
+    }
+
+    // get element by reference
+    template <typename T, GLuint row_count, GLuint column_count>
+    T& Matrix<T, row_count, column_count>::operator ()(GLuint row, GLuint column)
+    {
+        assert(row < row_count && column < column_count);
+        return _data[row * column_count + column];
+    }
+
+    // get copy of an element
+    template <typename T, GLuint row_count, GLuint column_count>
+    T Matrix<T, row_count, column_count>::operator ()(GLuint row, GLuint column) const
+    {
+        assert(row < row_count && column < column_count);
+        return _data[row * column_count + column];
+    }
+
+    // get dimensions
+    template <typename T, GLuint row_count, GLuint column_count>
+    GLuint Matrix<T, row_count, column_count>::GetRowCount()
+    {
+        return row_count;
+    }
+    template <typename T, GLuint row_count, GLuint column_count>
+    GLuint Matrix<T, row_count, column_count>::GetColumnCount()
+    {
+        return column_count;
+    }
+
+    // strided views of a row or a column
+    template <typename T, GLuint row_count, GLuint column_count>
+    StridedView<T> Matrix<T, row_count, column_count>::Row(GLuint index)
+    {
+        assert(index < row_count);
+        return StridedView<T>(_data + index * column_count, column_count);
+    }
+    template <typename T, GLuint row_count, GLuint column_count>
+    StridedView<const T> Matrix<T, row_count, column_count>::Row(GLuint index) const
+    {
+        assert(index < row_count);
+        return StridedView<const T>(_data + index * column_count, column_count);
+    }
+    template <typename T, GLuint row_count, GLuint column_count>
+    StridedView<T> Matrix<T, row_count, column_count>::Column(GLuint index)
+    {
+        assert(index < column_count);
+        return StridedView<T>(_data + index, row_count, column_count);
+    }
+    template <typename T, GLuint row_count, GLuint column_count>
+    StridedView<const T> Matrix<T, row_count, column_count>::Column(GLuint index) const
+    {
+        assert(index < column_count);
+        return StridedView<const T>(_data + index, row_count, column_count);
+    }
+
+    // raw pointer to the row-major array
+    template <typename T, GLuint row_count, GLuint column_count>
+    T* Matrix<T, row_count, column_count>::data()
+    {
+        return _data;
+    }
+    template <typename T, GLuint row_count, GLuint column_count>
+    const T* Matrix<T, row_count, column_count>::data() const
+    {
+        return _data;
+    }
+
+    //-------------------------------------------------------------------
+    // implementation of fixed-size template class TriangularMatrix<T, N>
+    //-------------------------------------------------------------------
+
+    // default constructor
+    template <typename T, GLuint row_count>
+    TriangularMatrix<T, row_count>::TriangularMatrix():
+        _data()
+    {
+    }
+
+    // get element by reference
+    template <typename T, GLuint row_count>
+    T& TriangularMatrix<T, row_count>::operator ()(GLuint row, GLuint column)
+    {
+        assert(row < row_count && column <= row);
+        return _data[row * (row + 1) / 2 + column];
+    }
+
+    // get copy of an element
+    template <typename T, GLuint row_count>
+    T TriangularMatrix<T, row_count>::operator ()(GLuint row, GLuint column) const
+    {
+        assert(row < row_count && column <= row);
+        return _data[row * (row + 1) / 2 + column];
+    }
+
+    // get dimension
+    template <typename T, GLuint row_count>
+    GLuint TriangularMatrix<T, row_count>::GetRowCount()
+    {
+        return row_count;
+    }
+
+    // view of the row-th row
+    template <typename T, GLuint row_count>
+    StridedView<T> TriangularMatrix<T, row_count>::Row(GLuint row)
+    {
+        assert(row < row_count);
+        return StridedView<T>(_data + row * (row + 1) / 2, row + 1);
+    }
+    template <typename T, GLuint row_count>
+    StridedView<const T> TriangularMatrix<T, row_count>::Row(GLuint row) const
+    {
+        assert(row < row_count);
+        return StridedView<const T>(_data + row * (row + 1) / 2, row + 1);
+    }
+
+    // raw pointer to the packed array
+    template <typename T, GLuint row_count>
+    T* TriangularMatrix<T, row_count>::data()
+    {
+        return _data;
+    }
+    template <typename T, GLuint row_count>
+    const T* TriangularMatrix<T, row_count>::data() const
+    {
+        return _data;
+    }
+
     //---------------------------------------------------------------------------------------------
     // definitions of Matrix-related overloaded and templated input/output from/to stream operators
     //---------------------------------------------------------------------------------------------
@@ -414,12 +795,11 @@ namespace cagd
     std::ostream& operator <<(std::ostream& lhs, const Matrix<T>& rhs)
     {
         lhs << rhs._row_count << " " << rhs._column_count << std::endl;
-        for (typename std::vector< std::vector<T> >::const_iterator row = rhs._data.begin();
-             row != rhs._data.end(); ++row)
+        typename std::vector<T>::const_iterator element = rhs._data.begin();
+        for (GLuint row = 0; row < rhs._row_count; ++row)
         {
-            for (typename std::vector<T>::const_iterator column = row->begin();
-                 column != row->end(); ++column)
-                    lhs << *column << " ";
+            for (GLuint column = 0; column < rhs._column_count; ++column, ++element)
+                    lhs << *element << " ";
             lhs << std::endl;
         }
         return lhs;
@@ -431,15 +811,10 @@ namespace cagd
     {
         // homework
         lhs >> rhs._row_count >> rhs._column_count;
-        rhs._data.resize(rhs._row_count);
-        for (typename std::vector< std::vector<T> >::iterator row = rhs._data.begin();
-             row != rhs._data.end(); ++row)
-        {
-            row->resize(rhs._column_count);
-            for (typename std::vector<T>::iterator column = row->begin();
-                 column != row->end(); ++column)
-                    lhs >> *column;
-        }
+        rhs._data.resize(rhs._row_count * rhs._column_count);
+        for (typename std::vector<T>::iterator element = rhs._data.begin();
+             element != rhs._data.end(); ++element)
+                lhs >> *element;
         return lhs;
     }
 
@@ -453,12 +828,11 @@ namespace cagd
     std::ostream& operator <<(std::ostream& lhs, const TriangularMatrix<T>& rhs)
     {
         lhs << rhs._row_count << " " << rhs._row_count << std::endl;
-        for (typename std::vector< std::vector<T> >::const_iterator row = rhs._data.begin();
-             row != rhs._data.end(); ++row)
+        typename std::vector<T>::const_iterator element = rhs._data.begin();
+        for (GLuint row = 0; row < rhs._row_count; ++row)
         {
-            for (typename std::vector<T>::const_iterator column = row->begin();
-                 column != row->end(); ++column)
-                    lhs << *column << " ";
+            for (GLuint column = 0; column <= row; ++column, ++element)
+                    lhs << *element << " ";
             lhs << std::endl;
         }
         return lhs;
@@ -470,17 +844,10 @@ namespace cagd
     {
         // homework
         lhs >> rhs._row_count;
-        rhs._data.resize(rhs._row_count);
-        GLuint column_count = 1;
-        for (typename std::vector< std::vector<T> >::iterator row = rhs._data.begin();
-             row != rhs._data.end(); ++row)
-        {
-            row->resize(column_count);
-            for (typename std::vector<T>::iterator column = row->begin();
-                 column != row->end(); ++column)
-                    lhs >> *column;
-            column_count++;
-        }
+        rhs._data.resize(rhs._row_count * (rhs._row_count + 1) / 2);
+        for (typename std::vector<T>::iterator element = rhs._data.begin();
+             element != rhs._data.end(); ++element)
+                lhs >> *element;
         return lhs;
     }
 }
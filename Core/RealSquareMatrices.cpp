@@ -1,11 +1,14 @@
 #include "RealSquareMatrices.h"
+#include <algorithm>
 
 using namespace cagd;
 using namespace std;
 
 RealSquareMatrix::RealSquareMatrix(GLuint size):
         Matrix<GLdouble>(size, size),
-        _lu_decomposition_is_done(GL_FALSE)
+        _lu_decomposition_is_done(GL_FALSE),
+        _precision_mode(DOUBLE_PRECISION),
+        _single_precision_lu_decomposition_is_done(GL_FALSE)
 {
 }
 
@@ -13,7 +16,12 @@ RealSquareMatrix::RealSquareMatrix(GLuint size):
 RealSquareMatrix::RealSquareMatrix(const RealSquareMatrix& m):
     Matrix<GLdouble>(m),
     _lu_decomposition_is_done(m._lu_decomposition_is_done),
-    _row_permutation(m._row_permutation)
+    _row_permutation(m._row_permutation),
+    _precision_mode(m._precision_mode),
+    _single_precision_lu_decomposition_is_done(m._single_precision_lu_decomposition_is_done),
+    _single_precision_lu(m._single_precision_lu),
+    _single_precision_row_permutation(m._single_precision_row_permutation),
+    _refinement_statistics(m._refinement_statistics)
 {
 }
 
@@ -25,6 +33,11 @@ RealSquareMatrix& RealSquareMatrix::operator =(const RealSquareMatrix& rhs)
         Matrix<GLdouble>::operator=(rhs);
         _lu_decomposition_is_done = rhs._lu_decomposition_is_done;
         _row_permutation = rhs._row_permutation;
+        _precision_mode = rhs._precision_mode;
+        _single_precision_lu_decomposition_is_done = rhs._single_precision_lu_decomposition_is_done;
+        _single_precision_lu = rhs._single_precision_lu;
+        _single_precision_row_permutation = rhs._single_precision_row_permutation;
+        _refinement_statistics = rhs._refinement_statistics;
     }
     return *this;
 }
@@ -39,6 +52,20 @@ GLboolean RealSquareMatrix::ResizeColumns(GLuint column_count)
     return Matrix<GLdouble>::ResizeRows(column_count) && Matrix<GLdouble>::ResizeColumns(column_count);
 }
 
+// y[0:count] += alpha * x[0:count], the innermost kernel of the factorization
+// (unit stride access, so it is vectorized by the compiler; in single precision twice as many
+// elements fit into a vector register)
+template <class Real>
+inline GLvoid RealSquareMatrix::_Axpy(GLuint count, Real alpha, const Real *x, Real *y)
+{
+    if (alpha == 0.0)
+        return;
+
+    #pragma omp simd
+    for (GLuint j = 0; j < count; ++j)
+        y[j] += alpha * x[j];
+}
+
 GLboolean RealSquareMatrix::PerformLUDecomposition()
 {
     if (_lu_decomposition_is_done)
@@ -47,25 +74,69 @@ GLboolean RealSquareMatrix::PerformLUDecomposition()
     if (_row_count <= 1)
         return GL_FALSE;
 
-    const GLdouble tiny = numeric_limits<GLdouble>::min();
+    if (!_Factorize(_row_count, _data.data(), _row_permutation))
+        return GL_FALSE;
 
-    GLuint size = static_cast<GLuint>(_data.size());
-    vector<GLdouble> implicit_scaling_of_each_row(size);
+    _lu_decomposition_is_done = GL_TRUE;
 
-    _row_permutation.resize(size);
+    return GL_TRUE;
+}
 
-    GLdouble row_interchanges = 1.0;
+// scaled partial pivoting in column k: the row of the largest scaled element of A[k:size, k] is
+// interchanged with the k-th row
+template <class Real>
+inline GLvoid RealSquareMatrix::_Pivot(GLuint size, GLuint k, Real *a, vector<Real>& implicit_scaling_of_each_row,
+                                       vector<GLuint>& row_permutation)
+{
+    // search for the largest pivot element
+    GLuint imax = k;
+    Real big = 0.0;
+    for (GLuint i = k; i < size; ++i)
+    {
+        Real temp = implicit_scaling_of_each_row[i] * abs(a[i * size + k]);
+        if (temp > big)
+        {
+            big = temp;
+            imax = i;
+        }
+    }
+
+    Real *row_k = a + k * size;
+
+    // do we need to interchange rows?
+    if (k != imax)
+    {
+        swap_ranges(row_k, row_k + size, a + imax * size);
+        // also interchange the scale factor
+        implicit_scaling_of_each_row[imax] = implicit_scaling_of_each_row[k];
+    }
+
+    row_permutation[k] = imax;
+    if (row_k[k] == 0.0)
+        row_k[k] = numeric_limits<Real>::min();
+}
+
+// blocked LU decomposition of the row-major size x size array a in the precision of Real
+template <class Real>
+GLboolean RealSquareMatrix::_Factorize(GLuint size, Real *a, vector<GLuint>& row_permutation)
+{
+    vector<Real> implicit_scaling_of_each_row(size);
+
+    row_permutation.resize(size);
+
+    // the rows of the matrix are stored contiguously one after the other
 
     //-------------------------------------------------------
     // loop over rows to get the implicit scaling information
     //-------------------------------------------------------
-    vector<GLdouble>::iterator its = implicit_scaling_of_each_row.begin();
-    for (vector<vector<GLdouble> >::const_iterator itr = _data.begin(); itr < _data.end(); ++itr)
+    for (GLuint i = 0; i < size; ++i)
     {
-        GLdouble big = 0.0;
-        for (vector<GLdouble>::const_iterator itc = itr->begin(); itc < itr->end(); ++itc)
+        const Real *row_i = a + i * size;
+
+        Real big = 0.0;
+        for (GLuint j = 0; j < size; ++j)
         {
-            GLdouble temp = abs(*itc);
+            Real temp = abs(row_i[j]);
             if (temp > big)
                     big = temp;
         }
@@ -75,58 +146,379 @@ GLboolean RealSquareMatrix::PerformLUDecomposition()
             // the matrix is singular
             return GL_FALSE;
         }
-        *its = 1.0 / big;
-        ++its;
+        implicit_scaling_of_each_row[i] = Real(1) / big;
     }
 
-    //-----------------------------------
-    // search for the largest pivot element
-    //-----------------------------------
-    for (GLuint k = 0; k < size; ++k)
+    //-------------------------------------------------------------------------------
+    // matrices that fit into a single panel are factored by the classical unblocked
+    // loop, since the bookkeeping of the panels would only slow them down
+    //-------------------------------------------------------------------------------
+    if (size <= _lu_block_size)
     {
-        GLuint imax = k;
-        GLdouble big = 0.0;
-        for (GLuint i = k; i < size; ++i)
+        for (GLuint k = 0; k < size; ++k)
         {
-            GLdouble temp = implicit_scaling_of_each_row[i] * abs(_data[i][k]);
-            if (temp > big)
+            _Pivot(size, k, a, implicit_scaling_of_each_row, row_permutation);
+
+            const Real *row_k = a + k * size;
+
+            for (GLuint i = k + 1; i < size; ++i)
             {
-                big = temp;
-                imax = i;
+                Real *row_i = a + i * size;
+
+                // divide by pivot element
+                Real temp = row_i[k] /= row_k[k];
+
+                // reduce remaining submatrix
+                for (GLuint j = k + 1; j < size; ++j)
+                    row_i[j] -= temp * row_k[j];
             }
         }
 
-        // do we need to interchange rows?
-        if (k != imax)
+        return GL_TRUE;
+    }
+
+    //-------------------------------------------------------------------------
+    // right-looking blocked elimination: the columns are processed in panels of
+    // width _lu_block_size
+    //-------------------------------------------------------------------------
+    for (GLuint k0 = 0; k0 < size; k0 += _lu_block_size)
+    {
+        GLuint k1 = min(k0 + _lu_block_size, size);
+
+        //--------------------------------------------------------------------
+        // factorize the panel A[k0:size, k0:k1] with scaled partial pivoting
+        //--------------------------------------------------------------------
+        for (GLuint k = k0; k < k1; ++k)
         {
-            for (GLuint j = 0; j < size; ++j)
+            _Pivot(size, k, a, implicit_scaling_of_each_row, row_permutation);
+
+            const Real *row_k = a + k * size;
+
+            for (GLuint i = k + 1; i < size; ++i)
             {
-                GLdouble temp = _data[imax][j];
-                _data[imax][j] = _data[k][j];
-                _data[k][j] = temp;
+                Real *row_i = a + i * size;
+
+                // divide by pivot element
+                Real temp = row_i[k] /= row_k[k];
+
+                // reduce the remaining columns of the panel
+                _Axpy(k1 - k - 1, -temp, row_k + k + 1, row_i + k + 1);
             }
-            // change the parity of row_interchanges
-            row_interchanges = -row_interchanges;
-            // also interchange the scale factor
-            implicit_scaling_of_each_row[imax] = implicit_scaling_of_each_row[k];
         }
 
-        _row_permutation[k] = imax;
-        if (_data[k][k] == 0.0)
-            _data[k][k] = tiny;
+        if (k1 == size)
+            break;
 
-        for (GLuint i = k + 1; i < size; ++i)
+        //-----------------------------------------------------------------------
+        // block row of U: A[k0:k1, k1:size] = L[k0:k1, k0:k1]^{-1} A[k0:k1, k1:size]
+        //-----------------------------------------------------------------------
+        for (GLuint k = k0; k < k1; ++k)
         {
-            // divide by pivot element
-            GLdouble temp = _data[i][k] /= _data[k][k];
+            const Real *row_k = a + k * size;
 
-            // reduce remaining submatrix
-            for (GLuint j = k + 1; j < size; ++j)
-                _data[i][j] -= temp * _data[k][j];
+            for (GLuint i = k + 1; i < k1; ++i)
+            {
+                Real *row_i = a + i * size;
+                _Axpy(size - k1, -row_i[k], row_k + k1, row_i + k1);
+            }
+        }
+
+        //-----------------------------------------------------------------------------
+        // trailing update: A[k1:size, k1:size] -= L[k1:size, k0:k1] * U[k0:k1, k1:size]
+        // rows are independent of each other, thus they are distributed among threads,
+        // while columns are traversed in tiles that keep the used part of the block row
+        // of U in cache
+        //-----------------------------------------------------------------------------
+        GLint first_row = static_cast<GLint>(k1), last_row = static_cast<GLint>(size);
+
+        #pragma omp parallel for schedule(static) if((size - k1) * (size - k1) >= _lu_parallel_threshold)
+        for (GLint i = first_row; i < last_row; ++i)
+        {
+            Real *row_i = a + i * size;
+
+            for (GLuint j0 = k1; j0 < size; j0 += _lu_column_tile_size)
+            {
+                GLuint j1 = min(j0 + _lu_column_tile_size, size);
+
+                for (GLuint k = k0; k < k1; ++k)
+                    _Axpy(j1 - j0, -row_i[k], a + k * size + j0, row_i + j0);
+            }
         }
     }
 
-    _lu_decomposition_is_done = GL_TRUE;
+    return GL_TRUE;
+}
+
+// forward and back substitution for real right-hand sides: the columns of x are processed in tiles
+// of _rhs_tile_size, within a tile every update is a unit-stride axpy over the right-hand sides
+// and the independent tiles are distributed among OpenMP threads
+template <class Real>
+GLvoid RealSquareMatrix::_Substitute(GLuint size, const Real *lu, const vector<GLuint>& row_permutation,
+                                     GLdouble *x, GLuint rhs_count)
+{
+    // row interchanges of the decomposition
+    for (GLuint i = 0; i < size; ++i)
+        if (row_permutation[i] != i)
+            swap_ranges(x + i * rhs_count, x + (i + 1) * rhs_count, x + row_permutation[i] * rhs_count);
+
+    GLint tile_count = static_cast<GLint>((rhs_count + _rhs_tile_size - 1) / _rhs_tile_size);
+
+    #pragma omp parallel for schedule(static) if(tile_count > 1 && size >= 64)
+    for (GLint tile = 0; tile < tile_count; ++tile)
+    {
+        GLuint k0 = tile * _rhs_tile_size;
+        GLuint width = min(k0 + _rhs_tile_size, rhs_count) - k0;
+
+        // forward substitution with the unit lower triangular factor
+        for (GLuint i = 1; i < size; ++i)
+        {
+            GLdouble *x_i = x + i * rhs_count + k0;
+            for (GLuint j = 0; j < i; ++j)
+                _Axpy<GLdouble>(width, -lu[i * size + j], x + j * rhs_count + k0, x_i);
+        }
+
+        // back substitution with the upper triangular factor
+        for (GLint i = static_cast<GLint>(size) - 1; i >= 0; --i)
+        {
+            GLdouble *x_i = x + i * rhs_count + k0;
+            for (GLuint j = i + 1; j < size; ++j)
+                _Axpy<GLdouble>(width, -lu[i * size + j], x + j * rhs_count + k0, x_i);
+
+            GLdouble pivot = lu[i * size + i];
+
+            #pragma omp simd
+            for (GLuint k = 0; k < width; ++k)
+                x_i[k] /= pivot;
+        }
+    }
+}
+
+GLvoid RealSquareMatrix::_SubstituteInPlace(GLdouble *x, GLuint rhs_count) const
+{
+    _Substitute(_row_count, _data.data(), _row_permutation, x, rhs_count);
+}
+
+// A = P^T L U implies A^T = U^T L^T P, thus the transposed factors are solved in reverse order and
+// the row interchanges are undone in reverse order, too
+template <class Real>
+GLvoid RealSquareMatrix::_SubstituteTransposed(GLuint size, const Real *lu, const vector<GLuint>& row_permutation,
+                                               GLdouble *y)
+{
+    // U^T w = c
+    for (GLuint i = 0; i < size; ++i)
+    {
+        GLdouble sum = y[i];
+        for (GLuint j = 0; j < i; ++j)
+            sum -= lu[j * size + i] * y[j];
+        y[i] = sum / lu[i * size + i];
+    }
+
+    // L^T v = w
+    for (GLint i = static_cast<GLint>(size) - 1; i >= 0; --i)
+    {
+        GLdouble sum = y[i];
+        for (GLuint j = i + 1; j < size; ++j)
+            sum -= lu[j * size + i] * y[j];
+        y[i] = sum;
+    }
+
+    // y = P^T v
+    for (GLint i = static_cast<GLint>(size) - 1; i >= 0; --i)
+        if (row_permutation[i] != static_cast<GLuint>(i))
+            swap(y[i], y[row_permutation[i]]);
+}
+
+// set/get the precision mode
+GLboolean RealSquareMatrix::SetPrecisionMode(PrecisionMode mode)
+{
+    // the original matrix is needed by the residuals of the iterative refinement
+    if (mode == MIXED_PRECISION && _lu_decomposition_is_done)
+        return GL_FALSE;
+
+    _precision_mode = mode;
 
     return GL_TRUE;
 }
+
+RealSquareMatrix::PrecisionMode RealSquareMatrix::GetPrecisionMode() const
+{
+    return _precision_mode;
+}
+
+// results of the last mixed precision solution
+const RealSquareMatrix::RefinementStatistics& RealSquareMatrix::GetRefinementStatistics() const
+{
+    return _refinement_statistics;
+}
+
+// Hager's method: the convex function ||A^{-1} x||_1 is maximized over the unit ball of the 1-norm
+// by a gradient-like iteration that visits its vertices; it rarely needs more than 2-3 steps
+GLdouble RealSquareMatrix::_EstimateNormOfInverse() const
+{
+    GLuint size = _row_count;
+
+    vector<GLdouble> x(size, 1.0 / size), y(size), z(size);
+
+    GLdouble estimate = 0.0;
+
+    for (GLuint iteration = 0; iteration < 5; ++iteration)
+    {
+        // y = A^{-1} x
+        y = x;
+        _Substitute(size, _single_precision_lu.data(), _single_precision_row_permutation, y.data(), 1);
+
+        estimate = 0.0;
+        for (GLuint i = 0; i < size; ++i)
+        {
+            estimate += abs(y[i]);
+            z[i] = (y[i] >= 0.0 ? 1.0 : -1.0);
+        }
+
+        // z = A^{-T} sign(y)
+        _SubstituteTransposed(size, _single_precision_lu.data(), _single_precision_row_permutation, z.data());
+
+        GLuint   j = 0;
+        GLdouble z_max = 0.0, z_dot_x = 0.0;
+        for (GLuint i = 0; i < size; ++i)
+        {
+            if (abs(z[i]) > z_max)
+            {
+                z_max = abs(z[i]);
+                j = i;
+            }
+            z_dot_x += z[i] * x[i];
+        }
+
+        if (iteration && z_max <= z_dot_x)
+            break;
+
+        fill(x.begin(), x.end(), 0.0);
+        x[j] = 1.0;
+    }
+
+    return estimate;
+}
+
+// determines the single precision LU decomposition of a copy of this matrix and estimates
+// the condition number of the matrix
+GLboolean RealSquareMatrix::PerformSinglePrecisionLUDecomposition()
+{
+    if (_single_precision_lu_decomposition_is_done)
+        return GL_TRUE;
+
+    if (_row_count <= 1 || _lu_decomposition_is_done)
+        return GL_FALSE;
+
+    _single_precision_lu.assign(_data.begin(), _data.end());
+
+    if (!_Factorize(_row_count, _single_precision_lu.data(), _single_precision_row_permutation))
+        return GL_FALSE;
+
+    _single_precision_lu_decomposition_is_done = GL_TRUE;
+
+    // ||A||_1 is the maximal absolute column sum
+    vector<GLdouble> column_sums(_column_count, 0.0);
+    for (GLuint i = 0; i < _row_count; ++i)
+        for (GLuint j = 0; j < _column_count; ++j)
+            column_sums[j] += abs(_data[i * _column_count + j]);
+
+    _refinement_statistics = RefinementStatistics();
+    _refinement_statistics.condition_number_estimate =
+            *max_element(column_sums.begin(), column_sums.end()) * _EstimateNormOfInverse();
+
+    return GL_TRUE;
+}
+
+// Mixed precision solution: x_0 = (LU)^{-1} b, then x_{k+1} = x_k + (LU)^{-1} (b - A x_k), where LU is
+// the single precision decomposition and the residuals are calculated in double precision. The
+// iteration converges to the double precision solution if cond(A) * u_single < 1, otherwise it
+// fails and the caller falls back to the double precision decomposition.
+GLboolean RealSquareMatrix::_RefineInPlace(GLdouble *x, GLuint rhs_count)
+{
+    if (!PerformSinglePrecisionLUDecomposition())
+        return GL_FALSE;
+
+    _refinement_statistics.refinement_step_count = 0;
+    _refinement_statistics.relative_residual = 0.0;
+    _refinement_statistics.converged = GL_FALSE;
+
+    // accuracy is at risk: the refinement could not converge
+    if (_refinement_statistics.condition_number_estimate * numeric_limits<GLfloat>::epsilon() >= 1.0)
+        return GL_FALSE;
+
+    GLuint size = _row_count;
+    GLuint count = size * rhs_count;
+    const GLdouble *a = _data.data();
+
+    // ||A||_inf
+    GLdouble norm_of_a = 0.0;
+    for (GLuint i = 0; i < size; ++i)
+    {
+        GLdouble row_sum = 0.0;
+        for (GLuint j = 0; j < size; ++j)
+            row_sum += abs(a[i * size + j]);
+        norm_of_a = max(norm_of_a, row_sum);
+    }
+
+    // stopping criterion of the iteration (the same as the one of LAPACK's dsgesv)
+    GLdouble tolerance = norm_of_a * numeric_limits<GLdouble>::epsilon() * sqrt(static_cast<GLdouble>(size));
+
+    vector<GLdouble> b(x, x + count), r(count);
+
+    _Substitute(size, _single_precision_lu.data(), _single_precision_row_permutation, x, rhs_count);
+
+    GLint first_row = 0, last_row = static_cast<GLint>(size);
+
+    GLdouble previous_norm_of_r = numeric_limits<GLdouble>::max();
+
+    // a residual costs size^2 * rhs_count operations, which may exceed the range of GLuint
+    GLboolean residual_is_parallel = static_cast<size_t>(count) * size >= static_cast<size_t>(_lu_parallel_threshold) * 64;
+
+    for (GLuint step = 0; ; ++step)
+    {
+        // r = b - A x, the rows are independent of each other
+        #pragma omp parallel for schedule(static) if(residual_is_parallel)
+        for (GLint i = first_row; i < last_row; ++i)
+        {
+            GLdouble *r_i = r.data() + i * rhs_count;
+            copy(b.begin() + i * rhs_count, b.begin() + (i + 1) * rhs_count, r_i);
+
+            for (GLuint j = 0; j < size; ++j)
+                _Axpy<GLdouble>(rhs_count, -a[i * size + j], x + j * rhs_count, r_i);
+        }
+
+        GLdouble norm_of_r = 0.0, norm_of_x = 0.0;
+        for (GLuint i = 0; i < count; ++i)
+        {
+            norm_of_r = max(norm_of_r, abs(r[i]));
+            norm_of_x = max(norm_of_x, abs(x[i]));
+        }
+
+        _refinement_statistics.refinement_step_count = step;
+        _refinement_statistics.relative_residual = (norm_of_x > 0.0 ? norm_of_r / (norm_of_a * norm_of_x) : norm_of_r);
+
+        if (norm_of_r <= tolerance * norm_of_x)
+        {
+            _refinement_statistics.converged = GL_TRUE;
+            return GL_TRUE;
+        }
+
+        // the iteration stagnates or diverges
+        if (step == _max_refinement_step_count || norm_of_r > 0.5 * previous_norm_of_r)
+            break;
+
+        previous_norm_of_r = norm_of_r;
+
+        // x += (LU)^{-1} r
+        _Substitute(size, _single_precision_lu.data(), _single_precision_row_permutation, r.data(), rhs_count);
+
+        #pragma omp simd
+        for (GLuint i = 0; i < count; ++i)
+            x[i] += r[i];
+    }
+
+    // restore the right-hand sides for the fallback
+    copy(b.begin(), b.end(), x);
+
+    return GL_FALSE;
+}
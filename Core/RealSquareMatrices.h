@@ -3,16 +3,113 @@
 #include <GL/glew.h>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include "DCoordinates3.h"
 #include "Matrices.h"
 
 namespace cagd
 {
     class RealSquareMatrix: public Matrix<GLdouble>
     {
+    public:
+        // precision of the LU decomposition used by the method SolveLinearSystem:
+        // - DOUBLE_PRECISION: the matrix is factored in place in double precision;
+        // - MIXED_PRECISION:  the matrix is preserved and a copy of it is factored in single precision,
+        //                     then the solutions are refined iteratively by means of residuals
+        //                     calculated in double precision; if the refinement does not converge,
+        //                     the double precision decomposition is used instead.
+        enum PrecisionMode {DOUBLE_PRECISION = 0, MIXED_PRECISION};
+
+        // information about the last mixed precision solution
+        class RefinementStatistics
+        {
+        public:
+            GLdouble  condition_number_estimate;    // estimate of the condition number in the 1-norm
+            GLuint    refinement_step_count;        // number of performed corrections
+            GLdouble  relative_residual;            // ||b - A x|| / (||A|| ||x||) in the infinity norm
+            GLboolean converged;                    // false, if the double precision fallback was used
+
+            RefinementStatistics():
+                condition_number_estimate(0.0),
+                refinement_step_count(0),
+                relative_residual(0.0),
+                converged(GL_FALSE)
+            {
+            }
+        };
+
     private:
         GLboolean           _lu_decomposition_is_done;
         std::vector<GLuint> _row_permutation;
 
+        PrecisionMode        _precision_mode;
+        GLboolean            _single_precision_lu_decomposition_is_done;
+        std::vector<GLfloat> _single_precision_lu;
+        std::vector<GLuint>  _single_precision_row_permutation;
+        RefinementStatistics _refinement_statistics;
+
+        // tuning parameters of the blocked LU decomposition
+        static const GLuint _lu_block_size = 64;            // width of a column panel
+        static const GLuint _lu_column_tile_size = 512;     // column tile of the trailing update
+        static const GLuint _lu_parallel_threshold = 16384; // minimal trailing element count for threading
+
+        static const GLuint _rhs_tile_size = 256;           // column tile of the triangular solves
+
+        static const GLuint _max_refinement_step_count = 30;
+
+        // y[0:count] += alpha * x[0:count]
+        template <class Real>
+        static GLvoid _Axpy(GLuint count, Real alpha, const Real *x, Real *y);
+
+        // scaled partial pivoting in column k: the row of the largest scaled element of A[k:size, k] is
+        // interchanged with the k-th row
+        template <class Real>
+        static GLvoid _Pivot(GLuint size, GLuint k, Real *a, std::vector<Real>& implicit_scaling_of_each_row,
+                             std::vector<GLuint>& row_permutation);
+
+        // blocked LU decomposition of the row-major size x size array a in the precision of Real
+        template <class Real>
+        static GLboolean _Factorize(GLuint size, Real *a, std::vector<GLuint>& row_permutation);
+
+        // forward and back substitution with the factors of a decomposition of precision Real,
+        // performed in double precision on all columns of the row-major array x
+        template <class Real>
+        static GLvoid _Substitute(GLuint size, const Real *lu, const std::vector<GLuint>& row_permutation,
+                                  GLdouble *x, GLuint rhs_count);
+
+        // solves the transposed system A^T y = c for a single right-hand side with the factors of a
+        // decomposition of precision Real
+        template <class Real>
+        static GLvoid _SubstituteTransposed(GLuint size, const Real *lu, const std::vector<GLuint>& row_permutation,
+                                            GLdouble *y);
+
+        // Hager's estimate of ||A^{-1}||_1 by means of the single precision factors
+        GLdouble _EstimateNormOfInverse() const;
+
+        // Solves the factored system for all right-hand sides stored in the row-major array x of
+        // size x rhs_count elements, i.e., the k-th right-hand side is the k-th column of x.
+        // The permuted forward and back substitutions are performed in place.
+        template <class T>
+        GLvoid _SubstituteInPlace(T *x, GLuint rhs_count) const;
+
+        // specialized versions: real right-hand sides are processed in column tiles by vectorized
+        // kernels, while the coordinates of points are processed as three real lanes
+        GLvoid _SubstituteInPlace(GLdouble *x, GLuint rhs_count) const;
+        GLvoid _SubstituteInPlace(DCoordinate3 *x, GLuint rhs_count) const;
+
+        // Mixed precision solution of the system with right-hand sides stored like above. On failure,
+        // x is left unchanged. Only real numbers and points are supported, the generic version fails,
+        // i.e., other types of right-hand sides are solved in double precision.
+        template <class T>
+        GLboolean _RefineInPlace(T *x, GLuint rhs_count);
+
+        GLboolean _RefineInPlace(GLdouble *x, GLuint rhs_count);
+        GLboolean _RefineInPlace(DCoordinate3 *x, GLuint rhs_count);
+
+        // solves the system in the current precision mode
+        template <class T>
+        GLboolean _SolveInPlace(T *x, GLuint rhs_count);
+
     public:
         // special/default constructor
         RealSquareMatrix(GLuint size = 1);
@@ -28,8 +125,23 @@ namespace cagd
         GLboolean ResizeColumns(GLuint column_count);
 
         // tries to determine the LU decomposition of this square matrix
+        // (blocked, right-looking elimination with scaled partial pivoting; the trailing updates
+        // of large matrices are distributed among OpenMP threads, while matrices that fit into a
+        // single panel are factored by the classical unblocked loop)
         GLboolean PerformLUDecomposition();
 
+        // set/get the precision mode; the mixed precision mode cannot be selected once the matrix
+        // has been overwritten by its double precision LU decomposition
+        GLboolean     SetPrecisionMode(PrecisionMode mode);
+        PrecisionMode GetPrecisionMode() const;
+
+        // determines the single precision LU decomposition of a copy of this matrix and estimates
+        // the condition number of the matrix
+        GLboolean PerformSinglePrecisionLUDecomposition();
+
+        // results of the last mixed precision solution
+        const RefinementStatistics& GetRefinementStatistics() const;
+
         // Solves linear systems of type A * x = b, where A is a regular square matrix,
         // while b and x are row or column matrices with elements of type T.
         // Here matrix A corresponds to *this.
@@ -42,80 +154,129 @@ namespace cagd
     template <class T>
     inline GLboolean RealSquareMatrix::SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns)
     {
-        if (!_lu_decomposition_is_done)
-            if (!PerformLUDecomposition())
-                return GL_FALSE;
+        GLuint size = GetRowCount();
 
         if (represent_solutions_as_columns)
         {
-            GLint size = static_cast<GLint>(GetColumnCount());
-            if (static_cast<GLint>(b.GetRowCount()) != size)
-                    return GL_FALSE;
+            if (b.GetRowCount() != size)
+                return GL_FALSE;
 
+            // the k-th solution is stored in the k-th column, i.e., the i-th components of all
+            // solutions are stored contiguously in the i-th row, thus all right-hand sides are
+            // processed together
             x = b;
-
-            for (GLuint k = 0; k < b.GetColumnCount(); ++k)
-            {
-                GLint ii = 0;
-                for (GLint i = 0; i < size; ++i)
-                {
-                    GLuint ip = _row_permutation[i];
-                    T sum = x(ip, k);
-                    x(ip, k) = x(i, k);
-                    if (ii != 0)
-                        for (GLint j = ii - 1; j < i; ++j)
-                            sum -= _data[i][j] * x(j, k);
-                    else
-                        if (sum != 0.0)
-                            ii = i + 1;
-                    x(i, k) = sum;
-                }
-
-                for (GLint i = size - 1; i >= 0; --i)
-                {
-                    T sum = x(i, k);
-                    for (GLint j = i + 1; j < size; ++j)
-                        sum -= _data[i][j] * x(j, k);
-                    x(i, k) = sum /= _data[i][i];
-                }
-            }
+            return _SolveInPlace(x.data(), x.GetColumnCount());
         }
         else
         {
-            GLint size = static_cast<GLint>(GetRowCount());
-            if (static_cast<GLint>(b.GetColumnCount()) != size)
+            if (b.GetColumnCount() != size)
+                return GL_FALSE;
+
+            // solutions are represented as rows, therefore they are transposed into columns,
+            // solved together and transposed back
+            GLuint rhs_count = b.GetRowCount();
+
+            Matrix<T> columns(size, rhs_count);
+            for (GLuint k = 0; k < rhs_count; ++k)
+                for (GLuint i = 0; i < size; ++i)
+                    columns(i, k) = b(k, i);
+
+            if (!_SolveInPlace(columns.data(), rhs_count))
                 return GL_FALSE;
 
             x = b;
+            for (GLuint k = 0; k < rhs_count; ++k)
+                for (GLuint i = 0; i < size; ++i)
+                    x(k, i) = columns(i, k);
+        }
+
+        return GL_TRUE;
+    }
+
+    // solves the system in the current precision mode
+    template <class T>
+    inline GLboolean RealSquareMatrix::_SolveInPlace(T *x, GLuint rhs_count)
+    {
+        // the mixed precision mode is in effect until the matrix is overwritten by its double
+        // precision decomposition, e.g., as a fallback of a failed refinement
+        if (_precision_mode == MIXED_PRECISION && !_lu_decomposition_is_done)
+            if (_RefineInPlace(x, rhs_count))
+                return GL_TRUE;
+
+        if (!_lu_decomposition_is_done)
+            if (!PerformLUDecomposition())
+                return GL_FALSE;
+
+        _SubstituteInPlace(x, rhs_count);
+
+        return GL_TRUE;
+    }
+
+    // generic types of right-hand sides are solved in double precision
+    template <class T>
+    inline GLboolean RealSquareMatrix::_RefineInPlace(T *, GLuint)
+    {
+        return GL_FALSE;
+    }
+
+    inline GLboolean RealSquareMatrix::_RefineInPlace(DCoordinate3 *x, GLuint rhs_count)
+    {
+        return _RefineInPlace(reinterpret_cast<GLdouble*>(x), 3 * rhs_count);
+    }
 
-            for (GLuint k = 0; k < b.GetRowCount(); ++k)
+    // generic forward and back substitution for element types that provide the operators -=, *
+    // and / with GLdouble coefficients
+    template <class T>
+    GLvoid RealSquareMatrix::_SubstituteInPlace(T *x, GLuint rhs_count) const
+    {
+        GLuint size = _row_count;
+        const GLdouble *lu = _data.data();
+
+        for (GLuint i = 0; i < size; ++i)
+            if (_row_permutation[i] != i)
+                std::swap_ranges(x + i * rhs_count, x + (i + 1) * rhs_count, x + _row_permutation[i] * rhs_count);
+
+        for (GLuint i = 1; i < size; ++i)
+        {
+            T *x_i = x + i * rhs_count;
+            for (GLuint j = 0; j < i; ++j)
             {
-                GLint ii = 0;
-                for (GLint i = 0; i < size; ++i)
+                GLdouble l = lu[i * size + j];
+                if (l != 0.0)
                 {
-                    GLuint ip = _row_permutation[i];
-                    T sum = x(k, ip);
-                    x(k, ip) = x(k, i);
-                    if (ii != 0)
-                        for (GLint j = ii - 1; j < i; ++j)
-                            sum -= _data[i][j] * x(k, j);
-                    else
-                        if (sum != 0.0)
-                            ii = i + 1;
-                    x(k, i) = sum;
+                    const T *x_j = x + j * rhs_count;
+                    for (GLuint k = 0; k < rhs_count; ++k)
+                        x_i[k] -= x_j[k] * l;
                 }
+            }
+        }
 
-                for (GLint i = size - 1; i >= 0; --i)
+        for (GLint i = static_cast<GLint>(size) - 1; i >= 0; --i)
+        {
+            T *x_i = x + i * rhs_count;
+            for (GLuint j = i + 1; j < size; ++j)
+            {
+                GLdouble u = lu[i * size + j];
+                if (u != 0.0)
                 {
-                    T sum = x(k, i);
-                    for (GLint j = i + 1; j < size; ++j)
-                        sum -= _data[i][j] * x(k, j);
-                    x(k, i) = sum /= _data[i][i];
+                    const T *x_j = x + j * rhs_count;
+                    for (GLuint k = 0; k < rhs_count; ++k)
+                        x_i[k] -= x_j[k] * u;
                 }
             }
-        }
 
-        return GL_TRUE;
+            GLdouble pivot = lu[i * size + i];
+            for (GLuint k = 0; k < rhs_count; ++k)
+                x_i[k] = x_i[k] / pivot;
+        }
     }
 
+    // the Cartesian coordinates x, y and z of consecutive points are consecutive GLdouble values,
+    // i.e., a row of points can be handled as a row of three times as many real numbers
+    inline GLvoid RealSquareMatrix::_SubstituteInPlace(DCoordinate3 *x, GLuint rhs_count) const
+    {
+        static_assert(sizeof(DCoordinate3) == 3 * sizeof(GLdouble), "DCoordinate3 must consist of 3 packed GLdouble values");
+
+        _SubstituteInPlace(reinterpret_cast<GLdouble*>(x), 3 * rhs_count);
+    }
 }
@@ -0,0 +1,357 @@
+#include "RestrictedQuadtrees.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // assigns consecutive indices to the vertices of a triangulation, vertices that are shared by several
+    // leaves are stored only once
+    class VertexIndexer
+    {
+    private:
+        GLuint                         _resolution;
+        vector<GLuint>                &_u_positions, &_v_positions;
+        unordered_map<GLuint, GLuint>  _indices;
+
+    public:
+        VertexIndexer(GLuint resolution, GLuint expected_vertex_count,
+                      vector<GLuint>& u_positions, vector<GLuint>& v_positions):
+            _resolution(resolution), _u_positions(u_positions), _v_positions(v_positions)
+        {
+            _indices.reserve(expected_vertex_count);
+            _u_positions.reserve(expected_vertex_count);
+            _v_positions.reserve(expected_vertex_count);
+        }
+
+        GLuint operator ()(GLuint u, GLuint v)
+        {
+            GLuint key = u * (_resolution + 1) + v;
+
+            unordered_map<GLuint, GLuint>::const_iterator it = _indices.find(key);
+
+            if (it != _indices.end())
+            {
+                return it->second;
+            }
+
+            GLuint index = static_cast<GLuint>(_u_positions.size());
+
+            _indices[key] = index;
+            _u_positions.push_back(u);
+            _v_positions.push_back(v);
+
+            return index;
+        }
+    };
+}
+
+// special/default constructor
+RestrictedQuadtree::Cell::Cell(GLuint level, GLuint i, GLuint j): level(level), i(i), j(j)
+{
+}
+
+GLboolean RestrictedQuadtree::Cell::operator <(const Cell& rhs) const
+{
+    if (level != rhs.level)
+    {
+        return level < rhs.level;
+    }
+
+    return i < rhs.i || (i == rhs.i && j < rhs.j);
+}
+
+GLboolean RestrictedQuadtree::Cell::operator ==(const Cell& rhs) const
+{
+    return level == rhs.level && i == rhs.i && j == rhs.j;
+}
+
+// the tree consists of a single leaf until it is built
+RestrictedQuadtree::RestrictedQuadtree(GLuint maximum_level): _maximum_level(min(maximum_level, 15u))
+{
+    _leaves.insert(Cell());
+}
+
+// replaces the leaf by its four children
+GLvoid RestrictedQuadtree::_Split(const Cell& leaf, vector<Cell>& pending)
+{
+    _leaves.erase(leaf);
+
+    for (GLuint a = 0; a < 2; a++)
+    {
+        for (GLuint b = 0; b < 2; b++)
+        {
+            Cell child(leaf.level + 1, 2 * leaf.i + a, 2 * leaf.j + b);
+
+            _leaves.insert(child);
+            pending.push_back(child);
+        }
+    }
+}
+
+// the leaf that contains the cell is either the cell itself or one of its ancestors
+GLboolean RestrictedQuadtree::_FindLeaf(const Cell& cell, Cell& leaf) const
+{
+    for (GLint level = cell.level; level >= 0; level--)
+    {
+        GLuint shift = cell.level - level;
+        Cell   ancestor(level, cell.i >> shift, cell.j >> shift);
+
+        if (_leaves.find(ancestor) != _leaves.end())
+        {
+            leaf = ancestor;
+            return GL_TRUE;
+        }
+    }
+
+    return GL_FALSE;
+}
+
+// the same-sized neighbour of the cell across the given side
+GLboolean RestrictedQuadtree::_Neighbour(const Cell& cell, Side side, Cell& neighbour) const
+{
+    GLuint last = (1u << cell.level) - 1;
+
+    switch (side)
+    {
+    case U_MIN:
+        if (cell.i == 0)
+        {
+            return GL_FALSE;
+        }
+        neighbour = Cell(cell.level, cell.i - 1, cell.j);
+        return GL_TRUE;
+
+    case U_MAX:
+        if (cell.i == last)
+        {
+            return GL_FALSE;
+        }
+        neighbour = Cell(cell.level, cell.i + 1, cell.j);
+        return GL_TRUE;
+
+    case V_MIN:
+        if (cell.j == 0)
+        {
+            return GL_FALSE;
+        }
+        neighbour = Cell(cell.level, cell.i, cell.j - 1);
+        return GL_TRUE;
+
+    case V_MAX:
+        if (cell.j == last)
+        {
+            return GL_FALSE;
+        }
+        neighbour = Cell(cell.level, cell.i, cell.j + 1);
+        return GL_TRUE;
+    }
+
+    return GL_FALSE;
+}
+
+// splits leaves until the pending cells are not coarser than their neighbours by more than one level
+GLvoid RestrictedQuadtree::_Balance(vector<Cell>& pending)
+{
+    static const Side sides[4] = {U_MIN, U_MAX, V_MIN, V_MAX};
+
+    while (!pending.empty())
+    {
+        Cell cell = pending.back();
+        pending.pop_back();
+
+        // the cell may have been split since it was pushed
+        if (_leaves.find(cell) == _leaves.end())
+        {
+            continue;
+        }
+
+        for (GLuint k = 0; k < 4; k++)
+        {
+            Cell neighbour, leaf;
+
+            if (!_Neighbour(cell, sides[k], neighbour) || !_FindLeaf(neighbour, leaf) || leaf.level + 1 >= cell.level)
+            {
+                continue;
+            }
+
+            // the children may be too fine for their other neighbours, while the cell has to be checked
+            // again, since the children may still be too coarse for it
+            _Split(leaf, pending);
+            pending.push_back(cell);
+
+            break;
+        }
+    }
+}
+
+// splits leaves until the levels of adjacent leaves differ by at most one
+GLvoid RestrictedQuadtree::Balance()
+{
+    vector<Cell> pending(_leaves.begin(), _leaves.end());
+
+    _Balance(pending);
+}
+
+// corners of the leaves along the given side in increasing order
+GLvoid RestrictedQuadtree::GetBoundaryBreakpoints(Side side, vector<GLuint>& positions) const
+{
+    positions.clear();
+
+    for (set<Cell>::const_iterator it = _leaves.begin(); it != _leaves.end(); it++)
+    {
+        GLuint last = (1u << it->level) - 1;
+        GLuint size = 1u << (_maximum_level - it->level);
+
+        if ((side == U_MIN && it->i == 0) || (side == U_MAX && it->i == last))
+        {
+            positions.push_back(it->j * size);
+        }
+        else if ((side == V_MIN && it->j == 0) || (side == V_MAX && it->j == last))
+        {
+            positions.push_back(it->i * size);
+        }
+    }
+
+    positions.push_back(GetResolution());
+
+    sort(positions.begin(), positions.end());
+}
+
+// splits the leaves along the given side until the position becomes one of their corners
+GLboolean RestrictedQuadtree::InsertBoundaryBreakpoint(Side side, GLuint position)
+{
+    GLuint resolution = GetResolution();
+
+    if (position == 0 || position >= resolution)
+    {
+        return GL_FALSE;
+    }
+
+    // the finest cell along the side that starts at the given position
+    Cell cell;
+
+    switch (side)
+    {
+    case U_MIN: cell = Cell(_maximum_level, 0, position);              break;
+    case U_MAX: cell = Cell(_maximum_level, resolution - 1, position); break;
+    case V_MIN: cell = Cell(_maximum_level, position, 0);              break;
+    case V_MAX: cell = Cell(_maximum_level, position, resolution - 1); break;
+    }
+
+    // only the new leaves can violate the restriction
+    vector<Cell> pending;
+    Cell         leaf;
+
+    while (_FindLeaf(cell, leaf))
+    {
+        GLuint start = ((side == U_MIN || side == U_MAX) ? leaf.j : leaf.i) << (_maximum_level - leaf.level);
+
+        if (start == position)
+        {
+            break;
+        }
+
+        _Split(leaf, pending);
+    }
+
+    if (pending.empty())
+    {
+        return GL_FALSE;
+    }
+
+    _Balance(pending);
+
+    return GL_TRUE;
+}
+
+// triangulates the leaves
+GLvoid RestrictedQuadtree::Triangulate(
+        vector<GLuint>& u_positions, vector<GLuint>& v_positions, vector<TriangularFace>& faces) const
+{
+    static const Side sides[4] = {U_MIN, V_MAX, U_MAX, V_MIN};
+
+    u_positions.clear();
+    v_positions.clear();
+    faces.clear();
+
+    // most corners are shared by four leaves, thus the vertex count is close to the leaf count
+    VertexIndexer index(GetResolution(), 2 * GetLeafCount() + 1, u_positions, v_positions);
+    faces.reserve(2 * GetLeafCount());
+
+    for (set<Cell>::const_iterator it = _leaves.begin(); it != _leaves.end(); it++)
+    {
+        GLuint size = 1u << (_maximum_level - it->level), half = size / 2;
+        GLuint u_0 = it->i * size, u_1 = u_0 + size;
+        GLuint v_0 = it->j * size, v_1 = v_0 + size;
+
+        // the boundary of the leaf is traversed in the order of the grid faces, the k-th side connects
+        // corner[k] and corner[k + 1] and it may be halved by middle[k]
+        GLuint corner[5] = {index(u_0, v_0), index(u_0, v_1), index(u_1, v_1), index(u_1, v_0), 0};
+        corner[4] = corner[0];
+
+        GLuint    middle[4];
+        GLboolean halved[4];
+        GLboolean is_halved = GL_FALSE;
+
+        for (GLuint k = 0; k < 4; k++)
+        {
+            Cell neighbour, leaf;
+
+            halved[k] = _Neighbour(*it, sides[k], neighbour) && !_FindLeaf(neighbour, leaf);
+            is_halved = is_halved || halved[k];
+        }
+
+        if (!is_halved)
+        {
+            TriangularFace face;
+
+            face[0] = corner[0]; face[1] = corner[1]; face[2] = corner[2];
+            faces.push_back(face);
+
+            face[0] = corner[0]; face[1] = corner[2]; face[2] = corner[3];
+            faces.push_back(face);
+
+            continue;
+        }
+
+        if (halved[0]) middle[0] = index(u_0, v_0 + half);
+        if (halved[1]) middle[1] = index(u_0 + half, v_1);
+        if (halved[2]) middle[2] = index(u_1, v_0 + half);
+        if (halved[3]) middle[3] = index(u_0 + half, v_0);
+
+        // fan around the center
+        GLuint center = index(u_0 + half, v_0 + half);
+
+        for (GLuint k = 0; k < 4; k++)
+        {
+            TriangularFace face;
+            face[0] = center;
+            face[1] = corner[k];
+
+            if (halved[k])
+            {
+                face[2] = middle[k];
+                faces.push_back(face);
+
+                face[1] = middle[k];
+            }
+
+            face[2] = corner[k + 1];
+            faces.push_back(face);
+        }
+    }
+}
+
+GLboolean RestrictedQuadtree::operator ==(const RestrictedQuadtree& rhs) const
+{
+    return _maximum_level == rhs._maximum_level && _leaves == rhs._leaves;
+}
+
+GLboolean RestrictedQuadtree::operator !=(const RestrictedQuadtree& rhs) const
+{
+    return !(*this == rhs);
+}
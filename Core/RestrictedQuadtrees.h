@@ -0,0 +1,145 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <set>
+#include <vector>
+#include "TriangularFaces.h"
+
+namespace cagd
+{
+    //-------------------------
+    // class RestrictedQuadtree
+    //-------------------------
+    // Adaptive subdivision of the unit square into square cells. A cell of level l is identified by its integer
+    // coordinates (i, j), it covers [i, i + 1] x [j, j + 1] scaled by 2^{-l}, where the first coordinate
+    // corresponds to the parameter u. The leaves are refined top-down by a function object with a method
+    //
+    //      GLboolean operator ()(GLdouble u_0, GLdouble u_1, GLdouble v_0, GLdouble v_1) const
+    //
+    // that returns GL_TRUE if the cell [u_0, u_1] x [v_0, v_1] has to be split, until the maximal level is
+    // reached. Afterwards the tree is restricted (i.e., balanced): the levels of leaves that share an edge
+    // differ by at most one, thus the triangulation of the leaves needs at most one extra vertex per edge.
+    //
+    // Positions along the boundary of the unit square are measured in units of 2^{-maximum_level}, i.e., they
+    // are integers in [0, GetResolution()]. Trees that cover adjacent domains can be matched by inserting the
+    // boundary breakpoints of each one into the other, then their triangulations share the vertices along the
+    // common edge.
+    class RestrictedQuadtree
+    {
+    public:
+        // sides of the unit square
+        enum Side{U_MIN, U_MAX, V_MIN, V_MAX};
+
+        class Cell
+        {
+        public:
+            GLuint level, i, j;
+
+            Cell(GLuint level = 0, GLuint i = 0, GLuint j = 0);
+
+            GLboolean operator <(const Cell& rhs) const;
+            GLboolean operator ==(const Cell& rhs) const;
+        };
+
+    protected:
+        GLuint         _maximum_level;
+        std::set<Cell> _leaves;
+
+        // replaces the leaf by its four children, which are appended to the vector of pending cells
+        GLvoid _Split(const Cell& leaf, std::vector<Cell>& pending);
+
+        // splits leaves until the pending cells and the ones that are split meanwhile are not coarser than their
+        // neighbours by more than one level
+        GLvoid _Balance(std::vector<Cell>& pending);
+
+        // the leaf that contains the cell, fails if the cell is subdivided
+        GLboolean _FindLeaf(const Cell& cell, Cell& leaf) const;
+
+        // the same-sized neighbour of the cell across the given side, fails at the boundary of the unit square
+        GLboolean _Neighbour(const Cell& cell, Side side, Cell& neighbour) const;
+
+    public:
+        // the tree consists of a single leaf until it is built, the maximum level is clamped to 15
+        RestrictedQuadtree(GLuint maximum_level = 6);
+
+        GLuint GetMaximumLevel() const;
+        GLuint GetResolution() const;
+        GLuint GetLeafCount() const;
+
+        // refines the tree uniformly up to the minimum level, then adaptively by the criterion, and balances it
+        template <class Criterion>
+        GLvoid Build(const Criterion& split, GLuint minimum_level = 1);
+
+        // splits leaves until the levels of adjacent leaves differ by at most one
+        GLvoid Balance();
+
+        // corners of the leaves along the given side in increasing order (including 0 and GetResolution())
+        GLvoid GetBoundaryBreakpoints(Side side, std::vector<GLuint>& positions) const;
+
+        // splits the leaves along the given side, until the position becomes one of their corners, and balances
+        // the tree; returns GL_TRUE if the tree changed
+        GLboolean InsertBoundaryBreakpoint(Side side, GLuint position);
+
+        // triangulates the leaves: the vertices are stored as position pairs (u_positions[k], v_positions[k]) in
+        // units of 2^{-maximum_level}; leaves whose edges are not halved by neighbours are split along a diagonal,
+        // the rest of them are triangulated by fans around their centers; the faces are ordered as the ones of
+        // uniform grid images, i.e., the corners (u_0, v_0), (u_0, v_1), (u_1, v_1) form a face
+        GLvoid Triangulate(
+                std::vector<GLuint>& u_positions, std::vector<GLuint>& v_positions,
+                std::vector<TriangularFace>& faces) const;
+
+        GLboolean operator ==(const RestrictedQuadtree& rhs) const;
+        GLboolean operator !=(const RestrictedQuadtree& rhs) const;
+    };
+
+    inline GLuint RestrictedQuadtree::GetMaximumLevel() const
+    {
+        return _maximum_level;
+    }
+
+    inline GLuint RestrictedQuadtree::GetResolution() const
+    {
+        return 1u << _maximum_level;
+    }
+
+    inline GLuint RestrictedQuadtree::GetLeafCount() const
+    {
+        return static_cast<GLuint>(_leaves.size());
+    }
+
+    template <class Criterion>
+    GLvoid RestrictedQuadtree::Build(const Criterion& split, GLuint minimum_level)
+    {
+        _leaves.clear();
+
+        // cells that still have to be processed
+        std::vector<Cell> pending(1, Cell());
+
+        while (!pending.empty())
+        {
+            Cell cell = pending.back();
+            pending.pop_back();
+
+            GLdouble size = 1.0 / (1u << cell.level);
+
+            if (cell.level < _maximum_level &&
+                (cell.level < minimum_level ||
+                 split(cell.i * size, (cell.i + 1) * size, cell.j * size, (cell.j + 1) * size)))
+            {
+                for (GLuint a = 0; a < 2; a++)
+                {
+                    for (GLuint b = 0; b < 2; b++)
+                    {
+                        pending.push_back(Cell(cell.level + 1, 2 * cell.i + a, 2 * cell.j + b));
+                    }
+                }
+            }
+            else
+            {
+                _leaves.insert(cell);
+            }
+        }
+
+        Balance();
+    }
+}
@@ -1,6 +1,11 @@
 #include "TensorProductSurfaces3.h"
+#include "DCoordinate3Batches.h"
 #include "RealSquareMatrices.h"
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
 
 using namespace std;
 
@@ -14,11 +19,25 @@ namespace cagd {
     // homework: initializes all partial derivatives to the origin
     GLvoid TensorProductSurface3::PartialDerivatives::LoadNullVectors()
     {
-        for (GLuint row = 0; row < _row_count; row++)
-        {
-            for (GLuint col = 0; col <= row; col++)
-                _data[row][col] = DCoordinate3();
-        }
+        fill(_data.begin(), _data.end(), DCoordinate3());
+    }
+
+    // default constructor
+    TensorProductSurface3::ImagePartialDerivatives::ImagePartialDerivatives():
+            u_div_point_count(0), v_div_point_count(0)
+    {
+    }
+
+    GLboolean TensorProductSurface3::ImagePartialDerivatives::IsEmpty() const
+    {
+        return u_derivative.empty();
+    }
+
+    GLvoid TensorProductSurface3::ImagePartialDerivatives::Clear()
+    {
+        u_div_point_count = v_div_point_count = 0;
+        u_derivative.clear();
+        v_derivative.clear();
     }
 
     // homework: special constructor
@@ -27,7 +46,7 @@ namespace cagd {
             GLdouble v_min, GLdouble v_max,
             GLuint row_count, GLuint column_count,
             GLboolean u_closed, GLboolean v_closed):
-        _u_closed(u_closed), _v_closed(v_closed),
+        _u_closed(u_closed), _v_closed(v_closed), _vbo_data(0),
         _u_min(u_min), _u_max(u_max), _v_min(v_min), _v_max(v_max),
         _data(row_count, column_count)
     {
@@ -35,7 +54,7 @@ namespace cagd {
 
     // homework: copy constructor
     TensorProductSurface3::TensorProductSurface3(const TensorProductSurface3& surface):
-        _u_closed(surface._u_closed), _v_closed(surface._v_closed),
+        _u_closed(surface._u_closed), _v_closed(surface._v_closed), _vbo_data(0),
         _u_min(surface._u_min), _u_max(surface._u_max), _v_min(surface._v_min), _v_max(surface._v_max),
         _data(surface._data)
     {
@@ -137,6 +156,17 @@ namespace cagd {
         return GL_TRUE;
     }
 
+    // transforms the control net
+    GLboolean TensorProductSurface3::TransformData(const HomogeneousTransformation3& transformation)
+    {
+        if (!transformation.IsAffine())
+            return GL_FALSE;
+
+        transformation.TransformPoints(_data.GetRowCount() * _data.GetColumnCount(), _data.data());
+
+        return GL_TRUE;
+    }
+
 
     // homework: get data by value
     DCoordinate3 TensorProductSurface3::operator ()(GLuint row, GLuint column) const
@@ -151,11 +181,27 @@ namespace cagd {
     }
 
 
-    // generates the image (i.e., the approximating triangulated mesh) of the tensor product surface
-    TriangulatedMesh3* TensorProductSurface3::GenerateImage(GLuint u_div_point_count, GLuint v_div_point_count, GLenum usage_flag) const
+    // blending function derivatives are not available by default
+    GLboolean TensorProductSurface3::UBlendingFunctionDerivatives(GLuint, GLdouble, Matrix<GLdouble>&) const
+    {
+        return GL_FALSE;
+    }
+
+    GLboolean TensorProductSurface3::VBlendingFunctionDerivatives(GLuint, GLdouble, Matrix<GLdouble>&) const
     {
+        return GL_FALSE;
+    }
+
+    // generates an image in the precision of the scalar type T
+    template <typename T>
+    TriangulatedMesh3* TensorProductSurface3::_GenerateImage(GLuint u_div_point_count, GLuint v_div_point_count, GLenum usage_flag,
+                                                             ImagePartialDerivatives *partials) const
+    {
+        if (partials)
+            partials->Clear();
+
         if (u_div_point_count <= 1 || v_div_point_count <= 1)
-            return GL_FALSE;
+            return nullptr;
 
         // calculating number of vertices, unit normal vectors and texture coordinates
         GLuint vertex_count = u_div_point_count * v_div_point_count;
@@ -177,60 +223,226 @@ namespace cagd {
         GLfloat sdu = 1.0f / (u_div_point_count - 1);
         GLfloat tdv = 1.0f / (v_div_point_count - 1);
 
-        // for face indexing
-        GLuint current_face = 0;
+        // zeroth and first order derivatives of the blending functions along the grid lines: the i-th
+        // row of u_table stores {F_r(u_i)} followed by {F'_r(u_i)}, similarly for v_table
+        GLuint row_count = _data.GetRowCount(), column_count = _data.GetColumnCount();
 
-        // partial derivatives of order 0, 1, 2, and 3
-        PartialDerivatives pd;
+        Matrix<T> u_table(u_div_point_count, 2 * row_count);
+        Matrix<T> v_table(v_div_point_count, 2 * column_count);
 
-        for (GLuint i = 0; i < u_div_point_count; ++i)
+        // derived classes may evaluate the whole grid at once in double precision (unless the partial derivatives are
+        // needed as well), single precision images are always evaluated in T
+        GLboolean grid_is_evaluated = !partials && is_same<T, GLdouble>::value &&
+                                      _EvaluateOnUniformGrid(u_div_point_count, v_div_point_count, result->_vertex, result->_normal);
+
+        if (partials)
+        {
+            partials->u_div_point_count = u_div_point_count;
+            partials->v_div_point_count = v_div_point_count;
+            partials->u_derivative.resize(vertex_count);
+            partials->v_derivative.resize(vertex_count);
+        }
+
+        shared_ptr<const Matrix<GLdouble> > u_derivatives, v_derivatives;
+
+        if (!grid_is_evaluated)
         {
-            GLdouble u = min(_u_min + i * du, _u_max);
-            GLfloat  s = min(i * sdu, 1.0f);
+            u_derivatives = _UniformBlendingFunctionTable(0, u_div_point_count);
+
+            if (u_derivatives)
+                v_derivatives = _UniformBlendingFunctionTable(1, v_div_point_count);
+        }
+
+        GLboolean tables_are_available = u_derivatives && v_derivatives;
+
+        // in double precision the first stage of the evaluation (see below) is performed for all u_i at once by
+        // the vectorized kernels of DCoordinate3Batch, i.e., the i-th points of the c-th batches are a_c(u_i) and
+        // b_c(u_i), and each control point contributes to them by weighting the values of its blending functions
+        GLboolean first_stage_is_batched = tables_are_available && is_same<T, GLdouble>::value;
+
+        vector<DCoordinate3Batch> a_batches, b_batches;
+
+        if (first_stage_is_batched)
+        {
+            a_batches.assign(column_count, DCoordinate3Batch(u_div_point_count));
+            b_batches.assign(column_count, DCoordinate3Batch(u_div_point_count));
+
+            // F_r(u_i) and F'_r(u_i) for i = 0, ..., u_div_point_count - 1
+            vector<GLdouble> F(u_div_point_count), dF(u_div_point_count);
+
+            for (GLuint r = 0; r < row_count; ++r)
+            {
+                for (GLuint i = 0; i < u_div_point_count; ++i)
+                {
+                    F[i]  = (*u_derivatives)(2 * i, r);
+                    dF[i] = (*u_derivatives)(2 * i + 1, r);
+                }
+
+                for (GLuint c = 0; c < column_count; ++c)
+                {
+                    a_batches[c].MultiplyAdd(F.data(), _data(r, c));
+                    b_batches[c].MultiplyAdd(dF.data(), _data(r, c));
+                }
+            }
+        }
+
+        if (tables_are_available)
+        {
+            if (!first_stage_is_batched)
+            {
+                for (GLuint i = 0; i < u_div_point_count; ++i)
+                {
+                    for (GLuint r = 0; r < row_count; ++r)
+                    {
+                        u_table(i, r)             = static_cast<T>((*u_derivatives)(2 * i, r));
+                        u_table(i, row_count + r) = static_cast<T>((*u_derivatives)(2 * i + 1, r));
+                    }
+                }
+            }
+
             for (GLuint j = 0; j < v_div_point_count; ++j)
             {
-                GLdouble v = min(_v_min + j * dv, _v_max);
-                GLfloat  t = min(j * tdv, 1.0f);
+                for (GLuint c = 0; c < column_count; ++c)
+                {
+                    v_table(j, c)                = static_cast<T>((*v_derivatives)(2 * j, c));
+                    v_table(j, column_count + c) = static_cast<T>((*v_derivatives)(2 * j + 1, c));
+                }
+            }
+        }
 
-                /*
-                    3-2
-                    |/|
-                    0-1
-                */
-                GLuint index[4];
+        // the control net in the precision of T
+        Matrix<Coordinate3<T> > net(row_count, column_count);
+        for (GLuint r = 0; r < row_count; ++r)
+            for (GLuint c = 0; c < column_count; ++c)
+                net(r, c) = Coordinate3<T>(_data(r, c));
 
-                index[0] = i * v_div_point_count + j;
-                index[1] = index[0] + 1;
-                index[2] = index[1] + v_div_point_count;
-                index[3] = index[2] - 1;
+        // the rows of the grid are distributed among the threads in contiguous blocks, each row writes only its
+        // own vertices and faces, thus the mesh does not depend on the number of threads
+        #pragma omp parallel if(vertex_count >= _parallel_threshold)
+        {
+            // the first stage combines the rows of the control net at u_i, i.e., a_c(u_i) = sum_r p_{r,c} F_r(u_i)
+            // and b_c(u_i) = sum_r p_{r,c} F'_r(u_i), thus the second stage evaluates s(u_i, v_j) = sum_c a_c(u_i) G_c(v_j)
+            // and its partial derivatives by 3 * column_count operations per grid point
+            vector<Coordinate3<T> > a(tables_are_available ? column_count : 0), b(a.size());
 
-                // calculating all needed surface data
-                CalculatePartialDerivatives(1, u, v, pd);
+            // partial derivatives of order 0 and 1
+            PartialDerivatives pd;
 
-                // surface point
-                (*result)._vertex[index[0]] = pd(0, 0);
+            #pragma omp for schedule(static)
+            for (GLint row = 0; row < static_cast<GLint>(u_div_point_count); ++row)
+            {
+                GLuint   i = static_cast<GLuint>(row);
+                GLdouble u = min(_u_min + i * du, _u_max);
+                GLfloat  s = min(i * sdu, 1.0f);
 
-                // unit surface normal
-                (*result)._normal[index[0]] = pd(1, 0);
-                (*result)._normal[index[0]] ^= pd(1, 1);
-                (*result)._normal[index[0]].normalize();
+                // the faces of the row follow the ones of the previous rows
+                GLuint current_face = 2 * i * (v_div_point_count - 1);
 
-                // texture coordinates
-                (*result)._tex[index[0]].s() = s;
-                (*result)._tex[index[0]].t() = t;
+                if (first_stage_is_batched)
+                {
+                    for (GLuint c = 0; c < column_count; ++c)
+                    {
+                        a[c] = Coordinate3<T>(a_batches[c][i]);
+                        b[c] = Coordinate3<T>(b_batches[c][i]);
+                    }
+                }
+                else if (tables_are_available)
+                {
+                    const T *F = &u_table(i, 0), *dF = F + row_count;
+
+                    for (GLuint c = 0; c < column_count; ++c)
+                    {
+                        a[c] = b[c] = Coordinate3<T>();
 
-                // faces
-                if (i < u_div_point_count - 1 && j < v_div_point_count - 1)
+                        for (GLuint r = 0; r < row_count; ++r)
+                        {
+                            a[c] += net(r, c) * F[r];
+                            b[c] += net(r, c) * dF[r];
+                        }
+                    }
+                }
+
+                for (GLuint j = 0; j < v_div_point_count; ++j)
                 {
-                    (*result)._face[current_face][0] = index[0];
-                    (*result)._face[current_face][1] = index[1];
-                    (*result)._face[current_face][2] = index[2];
-                    ++current_face;
-
-                    (*result)._face[current_face][0] = index[0];
-                    (*result)._face[current_face][1] = index[2];
-                    (*result)._face[current_face][2] = index[3];
-                    ++current_face;
+                    GLdouble v = min(_v_min + j * dv, _v_max);
+                    GLfloat  t = min(j * tdv, 1.0f);
+
+                    /*
+                        3-2
+                        |/|
+                        0-1
+                    */
+                    GLuint index[4];
+
+                    index[0] = i * v_div_point_count + j;
+                    index[1] = index[0] + 1;
+                    index[2] = index[1] + v_div_point_count;
+                    index[3] = index[2] - 1;
+
+                    if (tables_are_available)
+                    {
+                        const T *G = &v_table(j, 0), *dG = G + column_count;
+
+                        Coordinate3<T> point, d_u, d_v;
+
+                        for (GLuint c = 0; c < column_count; ++c)
+                        {
+                            point += a[c] * G[c];
+                            d_u   += b[c] * G[c];
+                            d_v   += a[c] * dG[c];
+                        }
+
+                        // surface point
+                        (*result)._vertex[index[0]] = DCoordinate3(point);
+
+                        if (partials)
+                        {
+                            partials->u_derivative[index[0]] = DCoordinate3(d_u);
+                            partials->v_derivative[index[0]] = DCoordinate3(d_v);
+                        }
+
+                        // unit surface normal
+                        d_u ^= d_v;
+                        d_u.normalize();
+                        (*result)._normal[index[0]] = DCoordinate3(d_u);
+                    }
+                    else if (!grid_is_evaluated)
+                    {
+                        // calculating all needed surface data
+                        CalculatePartialDerivatives(1, u, v, pd);
+
+                        // surface point
+                        (*result)._vertex[index[0]] = pd(0, 0);
+
+                        if (partials)
+                        {
+                            partials->u_derivative[index[0]] = pd(1, 0);
+                            partials->v_derivative[index[0]] = pd(1, 1);
+                        }
+
+                        // unit surface normal
+                        (*result)._normal[index[0]] = pd(1, 0);
+                        (*result)._normal[index[0]] ^= pd(1, 1);
+                        (*result)._normal[index[0]].normalize();
+                    }
+
+                    // texture coordinates
+                    (*result)._tex[index[0]].s() = s;
+                    (*result)._tex[index[0]].t() = t;
+
+                    // faces
+                    if (i < u_div_point_count - 1 && j < v_div_point_count - 1)
+                    {
+                        (*result)._face[current_face][0] = index[0];
+                        (*result)._face[current_face][1] = index[1];
+                        (*result)._face[current_face][2] = index[2];
+                        ++current_face;
+
+                        (*result)._face[current_face][0] = index[0];
+                        (*result)._face[current_face][1] = index[2];
+                        (*result)._face[current_face][2] = index[3];
+                        ++current_face;
+                    }
                 }
             }
         }
@@ -238,6 +450,276 @@ namespace cagd {
         return result;
     }
 
+    // generates the image (i.e., the approximating triangulated mesh) of the tensor product surface
+    TriangulatedMesh3* TensorProductSurface3::GenerateImage(GLuint u_div_point_count, GLuint v_div_point_count, GLenum usage_flag) const
+    {
+        return _GenerateImage<GLdouble>(u_div_point_count, v_div_point_count, usage_flag);
+    }
+
+    // generates a single precision preview of the image
+    TriangulatedMesh3* TensorProductSurface3::GeneratePreviewImage(GLuint u_div_point_count, GLuint v_div_point_count, GLenum usage_flag) const
+    {
+        return _GenerateImage<GLfloat>(u_div_point_count, v_div_point_count, usage_flag);
+    }
+
+    // generates the image together with the partial derivatives at its vertices
+    TriangulatedMesh3* TensorProductSurface3::GenerateImageWithPartialDerivatives(
+            GLuint u_div_point_count, GLuint v_div_point_count, ImagePartialDerivatives& partials, GLenum usage_flag) const
+    {
+        return _GenerateImage<GLdouble>(u_div_point_count, v_div_point_count, usage_flag, &partials);
+    }
+
+    // bounds of the second order partial derivatives are not available by default
+    GLboolean TensorProductSurface3::SecondOrderPartialDerivativeBounds(GLdouble& uu, GLdouble& uv, GLdouble& vv) const
+    {
+        uu = uv = vv = 0.0;
+
+        return GL_FALSE;
+    }
+
+    // the smallest uniform grid that guarantees the given chordal error
+    GLboolean TensorProductSurface3::UniformResolutionForChordalError(
+            GLdouble epsilon, GLuint& u_div_point_count, GLuint& v_div_point_count, GLuint maximum_div_point_count) const
+    {
+        GLdouble uu, uv, vv;
+
+        if (epsilon <= 0.0 || maximum_div_point_count < 2 || !SecondOrderPartialDerivativeBounds(uu, uv, vv))
+            return GL_FALSE;
+
+        GLdouble u_length = _u_max - _u_min, v_length = _v_max - _v_min;
+        GLdouble bound = 8.0 * epsilon;
+
+        GLboolean found = GL_FALSE;
+        GLuint    best_u = 0, best_v = 0;
+
+        // for each u-directional count, the longest step h_v that satisfies
+        // vv h_v^2 + 2 uv h_u h_v + uu h_u^2 <= 8 epsilon determines the v-directional count
+        for (GLuint n = 2; n <= maximum_div_point_count; n++)
+        {
+            GLdouble h_u = u_length / (n - 1);
+            GLdouble rest = bound - uu * h_u * h_u;
+
+            if (rest <= 0.0)
+                continue;
+
+            GLdouble h_v;
+
+            if (vv > 0.0)
+                h_v = (sqrt(uv * uv * h_u * h_u + vv * rest) - uv * h_u) / vv;
+            else if (uv > 0.0)
+                h_v = rest / (2.0 * uv * h_u);
+            else
+                h_v = v_length;
+
+            GLdouble segments = ceil(v_length / h_v);
+
+            if (segments + 1.0 > maximum_div_point_count)
+                continue;
+
+            GLuint m = max(static_cast<GLuint>(segments) + 1, 2u);
+
+            if (!found || n * m < best_u * best_v)
+            {
+                found = GL_TRUE;
+                best_u = n;
+                best_v = m;
+            }
+
+            // further u-directional points cannot decrease the v-directional count below 2
+            if (m == 2)
+                break;
+        }
+
+        if (!found)
+            return GL_FALSE;
+
+        u_div_point_count = best_u;
+        v_div_point_count = best_v;
+
+        return GL_TRUE;
+    }
+
+    // generates the image over the leaves of a restricted quadtree
+    TriangulatedMesh3* TensorProductSurface3::GenerateAdaptiveImage(const RestrictedQuadtree& tree, GLenum usage_flag) const
+    {
+        vector<GLuint>         u_positions, v_positions;
+        vector<TriangularFace> faces;
+
+        tree.Triangulate(u_positions, v_positions, faces);
+
+        GLuint vertex_count = static_cast<GLuint>(u_positions.size());
+
+        TriangulatedMesh3 *result = new TriangulatedMesh3(vertex_count, 0, usage_flag);
+
+        if (!result)
+            return nullptr;
+
+        result->_face.swap(faces);
+
+        GLdouble resolution = tree.GetResolution();
+
+        #pragma omp parallel if(vertex_count >= _parallel_threshold)
+        {
+            PartialDerivatives pd;
+
+            #pragma omp for schedule(static)
+            for (GLint k = 0; k < static_cast<GLint>(vertex_count); k++)
+            {
+                // the positions are dyadic, thus s and t are exact, while u and v are clamped to the domain
+                GLdouble s = u_positions[k] / resolution, t = v_positions[k] / resolution;
+                GLdouble u = min(_u_min + s * (_u_max - _u_min), _u_max);
+                GLdouble v = min(_v_min + t * (_v_max - _v_min), _v_max);
+
+                CalculatePartialDerivatives(1, u, v, pd);
+
+                result->_vertex[k] = pd(0, 0);
+
+                result->_normal[k] = pd(1, 0);
+                result->_normal[k] ^= pd(1, 1);
+                result->_normal[k].normalize();
+
+                result->_tex[k].s() = static_cast<GLfloat>(s);
+                result->_tex[k].t() = static_cast<GLfloat>(t);
+            }
+        }
+
+        return result;
+    }
+
+    // rank-one update of the image after a single control point has been moved
+    GLboolean TensorProductSurface3::UpdateImageForDataChange(
+            GLuint row, GLuint column, const DCoordinate3& delta,
+            TriangulatedMesh3& image, ImagePartialDerivatives& partials,
+            GLuint& first_vertex, GLuint& vertex_count) const
+    {
+        GLuint row_count = _data.GetRowCount(), column_count = _data.GetColumnCount();
+        GLuint u_div_point_count = partials.u_div_point_count, v_div_point_count = partials.v_div_point_count;
+
+        first_vertex = vertex_count = 0;
+
+        if (row >= row_count || column >= column_count || partials.IsEmpty() ||
+            image._vertex.size() != u_div_point_count * v_div_point_count ||
+            partials.u_derivative.size() != image._vertex.size() || partials.v_derivative.size() != image._vertex.size())
+            return GL_FALSE;
+
+        shared_ptr<const Matrix<GLdouble> > u_derivatives = _UniformBlendingFunctionTable(0, u_div_point_count);
+        shared_ptr<const Matrix<GLdouble> > v_derivatives = _UniformBlendingFunctionTable(1, v_div_point_count);
+
+        if (!u_derivatives || !v_derivatives)
+            return GL_FALSE;
+
+        // the support of the moved control point is bounded by the grid lines, at which the corresponding
+        // blending function or its derivative does not vanish
+        GLuint first_i = u_div_point_count, last_i = 0;
+
+        for (GLuint i = 0; i < u_div_point_count; ++i)
+        {
+            if ((*u_derivatives)(2 * i, row) != 0.0 || (*u_derivatives)(2 * i + 1, row) != 0.0)
+            {
+                first_i = min(first_i, i);
+                last_i = i;
+            }
+        }
+
+        GLuint first_j = v_div_point_count, last_j = 0;
+
+        for (GLuint j = 0; j < v_div_point_count; ++j)
+        {
+            if ((*v_derivatives)(2 * j, column) != 0.0 || (*v_derivatives)(2 * j + 1, column) != 0.0)
+            {
+                first_j = min(first_j, j);
+                last_j = j;
+            }
+        }
+
+        if (first_i > last_i || first_j > last_j)
+            return GL_TRUE;
+
+        for (GLuint i = first_i; i <= last_i; ++i)
+        {
+            DCoordinate3 F  = delta * (*u_derivatives)(2 * i, row);
+            DCoordinate3 dF = delta * (*u_derivatives)(2 * i + 1, row);
+
+            for (GLuint j = first_j; j <= last_j; ++j)
+            {
+                GLdouble G = (*v_derivatives)(2 * j, column), dG = (*v_derivatives)(2 * j + 1, column);
+                GLuint   index = i * v_div_point_count + j;
+
+                image._vertex[index] += F * G;
+
+                DCoordinate3 &d_u = partials.u_derivative[index];
+                DCoordinate3 &d_v = partials.v_derivative[index];
+
+                d_u += dF * G;
+                d_v += F * dG;
+
+                DCoordinate3 &normal = image._normal[index];
+
+                normal = d_u;
+                normal ^= d_v;
+                normal.normalize();
+            }
+        }
+
+        first_vertex = first_i * v_div_point_count + first_j;
+        vertex_count = last_i * v_div_point_count + last_j + 1 - first_vertex;
+
+        return GL_TRUE;
+    }
+
+    // rank-one update of the isoparametric lines after a single control point has been moved
+    GLboolean TensorProductSurface3::UpdateIsoparametricLinesForDataChange(
+            GLuint direction, GLuint row, GLuint column, const DCoordinate3& delta,
+            RowMatrix<GenericCurve3*>& lines) const
+    {
+        GLuint line_count = lines.GetColumnCount();
+
+        if (direction > 1 || row >= _data.GetRowCount() || column >= _data.GetColumnCount() || line_count < 2)
+            return GL_FALSE;
+
+        for (GLuint line = 0; line < line_count; ++line)
+        {
+            if (!lines[line] || lines[line]->GetPointCount() != lines[0]->GetPointCount() ||
+                lines[line]->GetMaximumOrderOfDerivatives() != lines[0]->GetMaximumOrderOfDerivatives())
+                return GL_FALSE;
+        }
+
+        GLuint point_count = lines[0]->GetPointCount();
+        GLuint order_count = lines[0]->GetMaximumOrderOfDerivatives() + 1;
+
+        // the lines are differentiated in the given direction, along which their points are distributed,
+        // while their fixed parameters are distributed uniformly in the other direction
+        GLuint along_index = direction ? column : row;
+        GLuint fixed_index = direction ? row : column;
+
+        shared_ptr<const Matrix<GLdouble> > along = _UniformBlendingFunctionTable(direction, point_count, order_count - 1);
+        shared_ptr<const Matrix<GLdouble> > fixed = _UniformBlendingFunctionTable(1 - direction, line_count, 0);
+
+        if (!along || !fixed)
+            return GL_FALSE;
+
+        for (GLuint line = 0; line < line_count; ++line)
+        {
+            GLdouble weight = (*fixed)(line, fixed_index);
+
+            if (weight == 0.0)
+                continue;
+
+            DCoordinate3 scaled_delta = delta * weight;
+            GenericCurve3 &curve = *lines[line];
+
+            for (GLuint k = 0; k < point_count; ++k)
+            {
+                for (GLuint r = 0; r < order_count; ++r)
+                {
+                    curve(r, k) += scaled_delta * (*along)(order_count * k + r, along_index);
+                }
+            }
+        }
+
+        return GL_TRUE;
+    }
+
     // ensures interpolation, i.e. s(u_i, v_j) = d_{i,j}
     GLboolean TensorProductSurface3::UpdateDataForInterpolation(const RowMatrix<GLdouble>& u_knot_vector, const ColumnMatrix<GLdouble>& v_knot_vector, Matrix<DCoordinate3>& data_points_to_interpolate)
     {
@@ -252,36 +734,64 @@ namespace cagd {
         if (u_knot_vector.GetColumnCount() != row_count || v_knot_vector.GetRowCount() != column_count || data_points_to_interpolate.GetRowCount() != row_count || data_points_to_interpolate.GetColumnCount() != column_count)
             return GL_FALSE;
 
-        // 1: calculate the u-collocation matrix and perfom LU-decomposition on it
-        RowMatrix<GLdouble> u_blending_values;
+        // 1: calculate the u-collocation matrix and perfom LU-decomposition on it (unless it is cached)
+        vector<GLdouble> u_shape_parameters;
+        u_shape_parameters.push_back(_u_min);
+        u_shape_parameters.push_back(_u_max);
+        _AppendShapeParameters(0, u_shape_parameters);
+
+        CollocationKey u_key(typeid(*this), 0, u_shape_parameters, u_knot_vector);
 
-        RealSquareMatrix u_collocation_matrix(row_count);
+        shared_ptr<RealSquareMatrix> u_collocation_matrix = _collocation_cache.Find(u_key);
 
-        for (GLuint i = 0; i < row_count; ++i)
+        if (!u_collocation_matrix)
         {
-            if (!UBlendingFunctionValues(u_knot_vector(i), u_blending_values))
+            RowMatrix<GLdouble> u_blending_values;
+
+            u_collocation_matrix = make_shared<RealSquareMatrix>(row_count);
+
+            for (GLuint i = 0; i < row_count; ++i)
+            {
+                if (!UBlendingFunctionValues(u_knot_vector(i), u_blending_values))
+                    return GL_FALSE;
+                u_collocation_matrix->SetRow(i, u_blending_values);
+            }
+
+            if (!u_collocation_matrix->PerformLUDecomposition())
                 return GL_FALSE;
-            u_collocation_matrix.SetRow(i, u_blending_values);
+
+            _collocation_cache.Insert(u_key, u_collocation_matrix);
         }
 
-        if (!u_collocation_matrix.PerformLUDecomposition())
-            return GL_FALSE;
+        // 2: calculate the v-collocation matrix and perform LU-decomposition on it (unless it is cached)
+        vector<GLdouble> v_shape_parameters;
+        v_shape_parameters.push_back(_v_min);
+        v_shape_parameters.push_back(_v_max);
+        _AppendShapeParameters(1, v_shape_parameters);
 
-        // 2: calculate the v-collocation matrix and perform LU-decomposition on it
-        RowMatrix<GLdouble> v_blending_values;
+        CollocationKey v_key(typeid(*this), 1, v_shape_parameters, v_knot_vector);
 
-        RealSquareMatrix v_collocation_matrix(column_count);
+        shared_ptr<RealSquareMatrix> v_collocation_matrix = _collocation_cache.Find(v_key);
 
-        for (GLuint j = 0; j < column_count; ++j)
+        if (!v_collocation_matrix)
         {
-            if (!VBlendingFunctionValues(v_knot_vector(j), v_blending_values))
-                return GL_FALSE;
-            v_collocation_matrix.SetRow(j, v_blending_values);
-        }
+            RowMatrix<GLdouble> v_blending_values;
 
-        if (!v_collocation_matrix.PerformLUDecomposition())
+            v_collocation_matrix = make_shared<RealSquareMatrix>(column_count);
+
+            for (GLuint j = 0; j < column_count; ++j)
+            {
+                if (!VBlendingFunctionValues(v_knot_vector(j), v_blending_values))
+                    return GL_FALSE;
+                v_collocation_matrix->SetRow(j, v_blending_values);
+            }
+
+            if (!v_collocation_matrix->PerformLUDecomposition())
                 return GL_FALSE;
 
+            _collocation_cache.Insert(v_key, v_collocation_matrix);
+        }
+
         // 3:   for all fixed j in {0, 1,..., column_count} determine control points
         //
         //      a_k(v_j) = sum_{l=0}^{column_count} _data(l, j) G_l(v_j), k = 0, 1,..., row_count
@@ -292,7 +802,7 @@ namespace cagd {
         //
         //      for all i = 0, 1,..., row_count.
         Matrix<DCoordinate3> a(row_count, column_count);
-        if (!u_collocation_matrix.SolveLinearSystem(data_points_to_interpolate, a))
+        if (!u_collocation_matrix->SolveLinearSystem(data_points_to_interpolate, a))
             return GL_FALSE;
 
         // 4:   for all fixed i in {0, 1,..., row_count} determine control point
@@ -304,12 +814,97 @@ namespace cagd {
         //      sum_{l=0}^{column_count} _data(i, l) G_l(v_j) = a_i(v_j)
         //
         //      for all j = 0, 1,..., column_count.
-        if (!v_collocation_matrix.SolveLinearSystem(a, _data, GL_FALSE))
+        if (!v_collocation_matrix->SolveLinearSystem(a, _data, GL_FALSE))
             return GL_FALSE;
 
         return GL_TRUE;
     }
 
+    // the default basis has no shape parameters besides its definition domain
+    GLvoid TensorProductSurface3::_AppendShapeParameters(GLuint, vector<GLdouble>&) const
+    {
+    }
+
+    // there are no specialized evaluations on uniform grids by default
+    GLboolean TensorProductSurface3::_EvaluateOnUniformGrid(GLuint, GLuint, vector<DCoordinate3>&, vector<DCoordinate3>&) const
+    {
+        return GL_FALSE;
+    }
+
+    GLboolean TensorProductSurface3::_EvaluateIsoparametricLineUniformly(GLuint, GLdouble, GLuint, GenericCurve3&) const
+    {
+        return GL_FALSE;
+    }
+
+    // the cache of collocation matrices
+    CollocationFactorizationCache TensorProductSurface3::_collocation_cache;
+
+    CollocationFactorizationCache& TensorProductSurface3::GetCollocationCache()
+    {
+        return _collocation_cache;
+    }
+
+    // the cache of blending function tables
+    BlendingFunctionTableCache TensorProductSurface3::_blending_function_table_cache;
+
+    BlendingFunctionTableCache& TensorProductSurface3::GetBlendingFunctionTableCache()
+    {
+        return _blending_function_table_cache;
+    }
+
+    // the table of blending function derivatives at the points of the uniform subdivision in the given direction
+    shared_ptr<const Matrix<GLdouble> > TensorProductSurface3::_UniformBlendingFunctionTable(
+            GLuint direction, GLuint div_point_count, GLuint maximum_order_of_derivatives) const
+    {
+        GLuint   function_count = direction ? _data.GetColumnCount() : _data.GetRowCount();
+        GLdouble min_value      = direction ? _v_min : _u_min;
+        GLdouble max_value      = direction ? _v_max : _u_max;
+
+        if (div_point_count <= 1 || !function_count)
+            return shared_ptr<const Matrix<GLdouble> >();
+
+        ColumnMatrix<GLdouble> parameters(div_point_count);
+        GLdouble step = (max_value - min_value) / (div_point_count - 1);
+
+        for (GLuint k = 0; k < div_point_count; ++k)
+            parameters(k) = min(min_value + k * step, max_value);
+
+        vector<GLdouble> shape_parameters;
+        shape_parameters.push_back(min_value);
+        shape_parameters.push_back(max_value);
+        _AppendShapeParameters(direction, shape_parameters);
+        shape_parameters.push_back(function_count);
+        shape_parameters.push_back(maximum_order_of_derivatives);
+
+        CollocationKey key(typeid(*this), direction, shape_parameters, parameters);
+
+        shared_ptr<const Matrix<GLdouble> > table = _blending_function_table_cache.Find(key);
+
+        if (table)
+            return table;
+
+        GLuint order_count = maximum_order_of_derivatives + 1;
+
+        shared_ptr<Matrix<GLdouble> > new_table = make_shared<Matrix<GLdouble> >(order_count * div_point_count, function_count);
+        Matrix<GLdouble> derivatives;
+
+        for (GLuint k = 0; k < div_point_count; ++k)
+        {
+            GLboolean is_evaluated = direction ? VBlendingFunctionDerivatives(maximum_order_of_derivatives, parameters(k), derivatives)
+                                               : UBlendingFunctionDerivatives(maximum_order_of_derivatives, parameters(k), derivatives);
+
+            if (!is_evaluated || derivatives.GetRowCount() < order_count || derivatives.GetColumnCount() != function_count)
+                return shared_ptr<const Matrix<GLdouble> >();
+
+            copy(derivatives.data(), derivatives.data() + order_count * function_count,
+                 new_table->data() + order_count * k * function_count);
+        }
+
+        _blending_function_table_cache.Insert(key, new_table);
+
+        return new_table;
+    }
+
     // homework: VBO handling methods
     GLvoid    TensorProductSurface3::DeleteVertexBufferObjectsOfData()
     {
@@ -414,7 +1009,7 @@ namespace cagd {
     {
         RowMatrix<GenericCurve3*>* lines = new RowMatrix<GenericCurve3*>(iso_line_count);
 
-        GLfloat u_step = (_u_max - _u_min) / (div_point_count - 1),
+        GLdouble u_step = (_u_max - _u_min) / (div_point_count - 1),
                 v_step = (_v_max - _v_min) / (iso_line_count - 1),
                 u, v;
         PartialDerivatives pd;
@@ -435,6 +1030,12 @@ namespace cagd {
                 return lines;
             }
 
+            if (_EvaluateIsoparametricLineUniformly(0, v, maximum_order_of_derivatives, *(*lines)[line]))
+            {
+                v += v_step;
+                continue;
+            }
+
             u = _u_min;
             for (GLuint point = 0; point < div_point_count - 1; point++)
             {
@@ -488,6 +1089,11 @@ namespace cagd {
             return lines;
         }
 
+        if (_EvaluateIsoparametricLineUniformly(0, _v_max, maximum_order_of_derivatives, *(*lines)[iso_line_count - 1]))
+        {
+            return lines;
+        }
+
         u = _u_min;
         for (GLuint point = 0; point < div_point_count - 1; point++)
         {
@@ -538,7 +1144,7 @@ namespace cagd {
     {
         RowMatrix<GenericCurve3*>* lines = new RowMatrix<GenericCurve3*>(iso_line_count);
 
-        GLfloat u_step = (_u_max - _u_min) / (iso_line_count - 1),
+        GLdouble u_step = (_u_max - _u_min) / (iso_line_count - 1),
                 v_step = (_v_max - _v_min) / (div_point_count - 1),
                 u, v;
         PartialDerivatives pd;
@@ -559,6 +1165,12 @@ namespace cagd {
                 return lines;
             }
 
+            if (_EvaluateIsoparametricLineUniformly(1, u, maximum_order_of_derivatives, *(*lines)[line]))
+            {
+                u += u_step;
+                continue;
+            }
+
             v = _v_min;
             for (GLuint point = 0; point < div_point_count - 1; point++)
             {
@@ -612,6 +1224,11 @@ namespace cagd {
             return lines;
         }
 
+        if (_EvaluateIsoparametricLineUniformly(1, _u_max, maximum_order_of_derivatives, *(*lines)[iso_line_count - 1]))
+        {
+            return lines;
+        }
+
         v = _v_min;
         for (GLuint point = 0; point < div_point_count - 1; point++)
         {
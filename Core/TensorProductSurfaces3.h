@@ -1,11 +1,16 @@
 #pragma once
 
+#include "BlendingFunctionTableCaches.h"
+#include "CollocationFactorizationCaches.h"
 #include "DCoordinates3.h"
 #include <GL/glew.h>
 #include <iostream>
 #include "Matrices.h"
 #include "GenericCurves3.h"
+#include "HomogeneousTransformations3.h"
+#include "RestrictedQuadtrees.h"
 #include "TriangulatedMeshes3.h"
+#include <memory>
 #include <vector>
 
 namespace cagd
@@ -32,6 +37,22 @@ namespace cagd
             GLvoid LoadNullVectors();
         };
 
+        // a nested class that stores the first order partial derivatives at the vertices of an image, which is
+        // generated on a uniform grid, by the same indices as the vertices; they are needed by incremental updates
+        // of the image
+        class ImagePartialDerivatives
+        {
+        public:
+            GLuint                      u_div_point_count, v_div_point_count;
+            std::vector<DCoordinate3>   u_derivative, v_derivative;
+
+            // default constructor, the partial derivatives are not available until they are generated
+            ImagePartialDerivatives();
+
+            GLboolean IsEmpty() const;
+            GLvoid    Clear();
+        };
+
 
     protected:
         GLboolean            _u_closed, _v_closed; // is the surface closed in direction u or v
@@ -40,6 +61,55 @@ namespace cagd
         GLdouble             _v_min, _v_max;       // definition domain in direction v
         Matrix<DCoordinate3> _data;                // the control net (usually stores position vectors)
 
+        // LU decompositions of recently used u- and v-directional collocation matrices
+        static CollocationFactorizationCache _collocation_cache;
+
+        // zeroth and first order blending function derivatives at the points of uniform subdivisions
+        static BlendingFunctionTableCache _blending_function_table_cache;
+
+        static const GLuint _parallel_threshold = 16384;   // minimal vertex count for threading
+
+        // Besides the definition domain, the blending functions may depend on further shape parameters,
+        // which are part of the keys of cached collocation matrices. Derived classes that have such
+        // parameters have to append the ones of the given direction (0: u, 1: v) to the vector.
+        virtual GLvoid _AppendShapeParameters(GLuint direction, std::vector<GLdouble>& shape_parameters) const;
+
+        // derived classes that can evaluate themselves faster on uniform grids (e.g., by forward differencing)
+        // may override the following methods, which are tried first by the image and isoparametric line
+        // generators; the default implementations return GL_FALSE
+        // - the surface point and the unit normal at the grid point (u_i, v_j) have to be stored at the
+        //   index i * v_div_point_count + j of the already allocated vectors;
+        // - the r-th row of the already allocated line has to store the r-th order derivatives in direction u
+        //   (direction = 0) along v = fixed_parameter, or in direction v (direction = 1) along u = fixed_parameter
+        virtual GLboolean _EvaluateOnUniformGrid(
+                GLuint u_div_point_count, GLuint v_div_point_count,
+                std::vector<DCoordinate3>& points, std::vector<DCoordinate3>& normals) const;
+
+        virtual GLboolean _EvaluateIsoparametricLineUniformly(
+                GLuint direction, GLdouble fixed_parameter,
+                GLuint maximum_order_of_derivatives, GenericCurve3& line) const;
+
+        // returns the zeroth and higher order derivatives of the u- (direction = 0) or v-directional (direction = 1)
+        // blending functions at the div_point_count uniformly distributed parameter values of the definition
+        // domain, the ((maximum_order_of_derivatives + 1) k + r)-th row of the table stores the r-th order
+        // derivatives at the k-th parameter value; a null pointer is returned if the blending function
+        // derivatives are not available
+        std::shared_ptr<const Matrix<GLdouble> > _UniformBlendingFunctionTable(
+                GLuint direction, GLuint div_point_count, GLuint maximum_order_of_derivatives = 1) const;
+
+        // generates an image in the precision of the scalar type T: if blending function derivatives
+        // are available, the control net and the tables of blending function derivatives are converted
+        // to T and the grid is evaluated in two stages, i.e., the control net is first combined with the
+        // u-directional blending functions at each u_i, then these curves of control points are combined
+        // with the v-directional blending functions at each v_j; otherwise each point is evaluated by
+        // CalculatePartialDerivatives; the rows of large grids are evaluated in parallel, therefore the
+        // overridden CalculatePartialDerivatives has to be safe to call concurrently; if partials is not a null
+        // pointer, the first order partial derivatives at the vertices are stored as well
+        template <typename T>
+        TriangulatedMesh3* _GenerateImage(
+                GLuint u_div_point_count, GLuint v_div_point_count, GLenum usage_flag,
+                ImagePartialDerivatives *partials = nullptr) const;
+
     public:
         // homework: special constructor
         TensorProductSurface3(
@@ -69,6 +139,9 @@ namespace cagd
         GLboolean GetData(GLuint row, GLuint column, GLdouble& x, GLdouble& y, GLdouble& z) const;
         GLboolean GetData(GLuint row, GLuint column, DCoordinate3& point) const;
 
+        // transforms the control net; due to the affine invariance of the basis, the surface is
+        // transformed accordingly, thus projective transformations are rejected
+        GLboolean TransformData(const HomogeneousTransformation3& transformation);
 
         // homework: get data by value
         DCoordinate3 operator ()(GLuint row, GLuint column) const;
@@ -83,6 +156,16 @@ namespace cagd
         virtual GLboolean VBlendingFunctionValues(
                 GLdouble v_knot, RowMatrix<GLdouble>& blending_values) const = 0;
 
+        // zeroth and higher order derivatives of the blending functions in u- and v-direction, the r-th
+        // row of the matrix stores the r-th order derivatives of all blending functions; the default
+        // implementations report that such tables are not available, in which case images are
+        // generated point by point by means of the method CalculatePartialDerivatives
+        virtual GLboolean UBlendingFunctionDerivatives(
+                GLuint maximum_order_of_derivatives, GLdouble u_knot, Matrix<GLdouble>& derivatives) const;
+
+        virtual GLboolean VBlendingFunctionDerivatives(
+                GLuint maximum_order_of_derivatives, GLdouble v_knot, Matrix<GLdouble>& derivatives) const;
+
         // calculates the point and higher order (mixed) partial derivatives of the
         // tensor product surface
         //
@@ -99,9 +182,53 @@ namespace cagd
                 GLuint u_div_point_count, GLuint v_div_point_count,
                 GLenum usage_flag = GL_STATIC_DRAW) const;
 
+        // generates the same mesh faster, but in single precision, e.g., during interactive editing
+        // (exact images, e.g., the ones that are exported, should be generated by GenerateImage)
+        TriangulatedMesh3* GeneratePreviewImage(
+                GLuint u_div_point_count, GLuint v_div_point_count,
+                GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // generates the same mesh as GenerateImage together with the first order partial derivatives at its
+        // vertices, which are needed by the method UpdateImageForDataChange
+        TriangulatedMesh3* GenerateImageWithPartialDerivatives(
+                GLuint u_div_point_count, GLuint v_div_point_count,
+                ImagePartialDerivatives& partials,
+                GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // upper bounds for the lengths of the second order partial derivatives s_uu, s_uv and s_vv over the definition
+        // domain; the default implementation reports that such bounds are not available
+        virtual GLboolean SecondOrderPartialDerivativeBounds(GLdouble& uu, GLdouble& uv, GLdouble& vv) const;
+
+        // the uniform grid of fewest vertices, the image of which deviates from the surface by at most epsilon: the
+        // linear interpolant over a right triangle with legs h_u and h_v deviates by at most
+        // (h_u^2 M_uu + 2 h_u h_v M_uv + h_v^2 M_vv) / 8 from the surface (Filip, Magedson and Markot), where M_uu, M_uv
+        // and M_vv are the bounds above; fails if the bounds are not available or if more than maximum_div_point_count
+        // points would be needed in one of the directions
+        GLboolean UniformResolutionForChordalError(
+                GLdouble epsilon, GLuint& u_div_point_count, GLuint& v_div_point_count,
+                GLuint maximum_div_point_count = 1024) const;
+
+        // generates a triangulated mesh over the leaves of a restricted quadtree, the unit square of which is mapped
+        // onto the definition domain; the vertices are evaluated by CalculatePartialDerivatives (in parallel, if there
+        // are many of them), the texture coordinates are their positions in the unit square
+        TriangulatedMesh3* GenerateAdaptiveImage(const RestrictedQuadtree& tree, GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // updates an image generated by GenerateImageWithPartialDerivatives after the control point (row, column)
+        // has been moved by delta: the surface depends linearly on its control net, thus the vertex (u_i, v_j)
+        // moves by delta F_row(u_i) G_column(v_j), while its partial derivatives change by delta F'_row(u_i) G_column(v_j)
+        // and delta F_row(u_i) G'_column(v_j), respectively; the unit normals are recalculated only at those
+        // vertices, where one of the partial derivatives changes; on success, the vertices outside of the index
+        // range [first_vertex, first_vertex + vertex_count) are left unchanged; fails if blending function tables
+        // are not available, in which case the image has to be regenerated
+        GLboolean UpdateImageForDataChange(
+                GLuint row, GLuint column, const DCoordinate3& delta,
+                TriangulatedMesh3& image, ImagePartialDerivatives& partials,
+                GLuint& first_vertex, GLuint& vertex_count) const;
+
         // ensures interpolation, i.e., updates the control net $\left[\mathbf{p}_{i,j}\right]_{i=0,j=0}^{n,m}$ stored by
         // the matrix _data such that interpolation conditions $\mathbf{s}(u_k, v_l) = \mathbf{d}_{k,l}$ hold for
-        // all $k = 0,1,...,n$ and $l = 0,1,...,m$
+        // all $k = 0,1,...,n$ and $l = 0,1,...,m$; the LU decompositions of the collocation matrices are
+        // reused as long as the basis and the knot vectors do not change
         GLboolean UpdateDataForInterpolation(
                 const RowMatrix<GLdouble>& u_knot_vector, const ColumnMatrix<GLdouble>& v_knot_vector,
                 Matrix<DCoordinate3>& data_points_to_interpolate);
@@ -123,6 +250,20 @@ namespace cagd
                                                               GLuint div_point_count,
                                                               GLenum usage_flag = GL_STATIC_DRAW) const;
 
+        // updates the isoparametric lines generated by GenerateUIsoparametricLines (direction = 0) or
+        // GenerateVIsoparametricLines (direction = 1) after the control point (row, column) has been moved by
+        // delta, similarly to the method UpdateImageForDataChange; the vertex buffer objects of the lines have to
+        // be updated by the caller
+        GLboolean UpdateIsoparametricLinesForDataChange(
+                GLuint direction, GLuint row, GLuint column, const DCoordinate3& delta,
+                RowMatrix<GenericCurve3*>& lines) const;
+
+        // the cache of collocation matrices, e.g., its hit/miss counters can be queried
+        static CollocationFactorizationCache& GetCollocationCache();
+
+        // the cache of blending function tables that are used by the image generators
+        static BlendingFunctionTableCache& GetBlendingFunctionTableCache();
+
         // homework: destructor
         virtual ~TensorProductSurface3();
     };
@@ -337,6 +337,95 @@ GLboolean TriangulatedMesh3::UpdateVertexBufferObjects(GLenum usage_flag)
     return GL_TRUE;
 }
 
+GLboolean TriangulatedMesh3::UpdateVertexBufferObjectsOfGeometry()
+{
+    if (!_vbo_vertices || !_vbo_normals)
+        return UpdateVertexBufferObjects(_usage_flag);
+
+    size_t vertex_byte_size = 3 * _vertex.size() * sizeof(GLfloat);
+
+    // the storages are reallocated before mapping, thus the driver does not have to wait for
+    // pending draw calls that still use the old contents
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    glBufferData(GL_ARRAY_BUFFER, vertex_byte_size, nullptr, _usage_flag);
+
+    GLfloat *vertex_coordinate = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_normals);
+    glBufferData(GL_ARRAY_BUFFER, vertex_byte_size, nullptr, _usage_flag);
+
+    GLfloat *normal_coordinate = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+
+    if (vertex_coordinate && normal_coordinate)
+    {
+        for (vector<DCoordinate3>::const_iterator
+             vit = _vertex.begin(),
+             nit = _normal.begin(); vit != _vertex.end(); ++vit, ++nit)
+        {
+            for (GLint component = 0; component < 3; ++component)
+            {
+                *vertex_coordinate = (GLfloat)(*vit)[component];
+                ++vertex_coordinate;
+
+                *normal_coordinate = (GLfloat)(*nit)[component];
+                ++normal_coordinate;
+            }
+        }
+    }
+
+    GLboolean result = vertex_coordinate && normal_coordinate;
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    if (vertex_coordinate && !glUnmapBuffer(GL_ARRAY_BUFFER))
+        result = GL_FALSE;
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_normals);
+    if (normal_coordinate && !glUnmapBuffer(GL_ARRAY_BUFFER))
+        result = GL_FALSE;
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return result;
+}
+
+GLboolean TriangulatedMesh3::UpdateVertexBufferObjectsOfGeometry(GLuint first_vertex, GLuint vertex_count)
+{
+    if (!_vbo_vertices || !_vbo_normals)
+        return UpdateVertexBufferObjects(_usage_flag);
+
+    if (first_vertex >= _vertex.size())
+        return vertex_count == 0;
+
+    vertex_count = min(vertex_count, static_cast<GLuint>(_vertex.size()) - first_vertex);
+
+    if (!vertex_count)
+        return GL_TRUE;
+
+    vector<GLfloat> vertex_coordinates(3 * vertex_count), normal_coordinates(3 * vertex_count);
+
+    for (GLuint i = 0; i < vertex_count; ++i)
+    {
+        for (GLuint component = 0; component < 3; ++component)
+        {
+            vertex_coordinates[3 * i + component] = (GLfloat)_vertex[first_vertex + i][component];
+            normal_coordinates[3 * i + component] = (GLfloat)_normal[first_vertex + i][component];
+        }
+    }
+
+    GLintptr   offset = 3 * first_vertex * sizeof(GLfloat);
+    GLsizeiptr size   = 3 * vertex_count * sizeof(GLfloat);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, &vertex_coordinates[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_normals);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, &normal_coordinates[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return GL_TRUE;
+}
+
 GLboolean TriangulatedMesh3::LoadFromOFF(
         const string &file_name, GLboolean translate_and_scale_to_unit_cube)
 {
@@ -537,3 +626,43 @@ GLboolean TriangulatedMesh3::GetVertex(GLuint index, DCoordinate3& coord)
 
     return GL_TRUE;
 }
+
+GLboolean TriangulatedMesh3::GetNormal(GLuint index, DCoordinate3& normal)
+{
+    normal = _normal[index];
+
+    return GL_TRUE;
+}
+
+GLboolean TriangulatedMesh3::Transform(const HomogeneousTransformation3& transformation)
+{
+    Matrix<GLdouble, 3, 3> inverse_transpose;
+
+    if (!transformation.IsAffine() || !transformation.InverseTransposeOfLinearPart(inverse_transpose))
+        return GL_FALSE;
+
+    if (_vertex.empty())
+        return GL_TRUE;
+
+    GLuint vertex_count = static_cast<GLuint>(_vertex.size());
+
+    transformation.TransformPoints(vertex_count, &_vertex[0]);
+
+    if (!_normal.empty())
+        transformation.TransformNormals(static_cast<GLuint>(_normal.size()), &_normal[0]);
+
+    // the transformed box is not necessarily axis-aligned, therefore it is recalculated
+    _leftmost_vertex.x() = _leftmost_vertex.y() = _leftmost_vertex.z() = numeric_limits<GLdouble>::max();
+    _rightmost_vertex.x() = _rightmost_vertex.y() = _rightmost_vertex.z() = -numeric_limits<GLdouble>::max();
+
+    for (vector<DCoordinate3>::const_iterator vit = _vertex.begin(); vit != _vertex.end(); ++vit)
+    {
+        for (GLuint i = 0; i < 3; i++)
+        {
+            _leftmost_vertex[i]  = min(_leftmost_vertex[i], (*vit)[i]);
+            _rightmost_vertex[i] = max(_rightmost_vertex[i], (*vit)[i]);
+        }
+    }
+
+    return GL_TRUE;
+}
@@ -2,6 +2,7 @@
 
 #include "DCoordinates3.h"
 #include <GL/glew.h>
+#include "HomogeneousTransformations3.h"
 #include <iostream>
 #include <string>
 #include "TriangularFaces.h"
@@ -65,6 +66,16 @@ namespace cagd
         // updates all vertex buffer objects
         GLboolean UpdateVertexBufferObjects(GLenum usage_flag = GL_STATIC_DRAW);
 
+        // refills only the vertex buffer objects of vertices and unit normal vectors (e.g., after a
+        // transformation), texture coordinates and faces are not uploaded again; if the buffers do not
+        // exist yet, all of them are created
+        GLboolean UpdateVertexBufferObjectsOfGeometry();
+
+        // overwrites the vertices and unit normal vectors of the given index range in the existing vertex
+        // buffer objects by means of glBufferSubData (e.g., after an incremental update of a part of the
+        // mesh); if the buffers do not exist yet, all of them are created
+        GLboolean UpdateVertexBufferObjectsOfGeometry(GLuint first_vertex, GLuint vertex_count);
+
         // loads the geometry (i.e. the array of vertices and faces) stored in an OFF file
         // at the same time calculates the unit normal vectors associated with vertices
         GLboolean LoadFromOFF(const std::string& file_name, GLboolean translate_and_scale_to_unit_cube = GL_FALSE);
@@ -87,6 +98,13 @@ namespace cagd
         size_t FaceCount() const;   // homework
 
         GLboolean GetVertex(GLuint index, DCoordinate3& coord);
+        GLboolean GetNormal(GLuint index, DCoordinate3& normal);
+
+        // transforms the vertices, the unit normal vectors (by the inverse transpose of the linear part,
+        // reversed by reflections) and the bounding box; fails for projective transformations and for
+        // singular linear parts; vertex buffer objects have to be updated by the caller
+        GLboolean Transform(const HomogeneousTransformation3& transformation);
+
         // destructor
         virtual ~TriangulatedMesh3();
     };
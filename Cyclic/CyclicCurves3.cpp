@@ -47,11 +47,51 @@ namespace cagd {
         LinearCombination3(0.0, TWO_PI, 2 * n + 1, data_usage_flag),
         _n(n),
         _c_n(_CalculateNormalizingCoefficient(n)),
-        _lambda_n(TWO_PI / (2 * n + 1))
+        _lambda_n(TWO_PI / (2 * n + 1)),
+        _dft(2 * n + 1)
     {
         _CalculateBinomialCoefficients(2 * _n, _bc);
     }
 
+    // copy constructor
+    CyclicCurve3::CyclicCurve3(const CyclicCurve3& curve) :
+        LinearCombination3(curve),
+        _n(curve._n),
+        _c_n(curve._c_n),
+        _lambda_n(curve._lambda_n),
+        _bc(curve._bc),
+        _dft(curve._dft)
+    {
+        lock_guard<mutex> lock(curve._coefficient_mutex);
+        _coefficients = curve._coefficients;
+    }
+
+    // assignment operator
+    CyclicCurve3& CyclicCurve3::operator =(const CyclicCurve3& rhs)
+    {
+        if (this != &rhs)
+        {
+            LinearCombination3::operator =(rhs);
+
+            _n = rhs._n;
+            _c_n = rhs._c_n;
+            _lambda_n = rhs._lambda_n;
+            _bc = rhs._bc;
+            _dft = rhs._dft;
+
+            shared_ptr<const FourierCoefficients> coefficients;
+            {
+                lock_guard<mutex> lock(rhs._coefficient_mutex);
+                coefficients = rhs._coefficients;
+            }
+
+            lock_guard<mutex> lock(_coefficient_mutex);
+            _coefficients = coefficients;
+        }
+
+        return *this;
+    }
+
     GLboolean CyclicCurve3::BlendingFunctionValues(GLdouble u, RowMatrix<GLdouble> &values) const
     {
         values.ResizeColumns(2 * _n + 1);
@@ -64,38 +104,290 @@ namespace cagd {
         return GL_TRUE;
     }
 
+    // returns coefficients that belong to the current control points
+    shared_ptr<const CyclicCurve3::FourierCoefficients> CyclicCurve3::_GetFourierCoefficients() const
+    {
+        typedef DiscreteFourierTransform::Complex Complex;
+
+        lock_guard<mutex> lock(_coefficient_mutex);
+
+        GLuint data_count = 2 * _n + 1;
+
+        if (_coefficients)
+        {
+            GLboolean data_is_unchanged = GL_TRUE;
+
+            for (GLuint i = 0; i < data_count && data_is_unchanged; ++i)
+            {
+                const DCoordinate3 &lhs = _coefficients->data[i], &rhs = _data[i];
+                data_is_unchanged = lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2];
+            }
+
+            if (data_is_unchanged)
+            {
+                return _coefficients;
+            }
+        }
+
+        shared_ptr<FourierCoefficients> coefficients = make_shared<FourierCoefficients>();
+
+        coefficients->data.assign(_data.data(), _data.data() + data_count);
+        coefficients->real.resize(_n);
+        coefficients->imag.resize(_n);
+
+        // the x and y coordinates are transformed together as the real and imaginary parts of a single
+        // complex sequence, and separated by means of the conjugate symmetry of real transforms
+        vector<Complex> xy(data_count), z(data_count);
+        for (GLuint i = 0; i < data_count; ++i)
+        {
+            const DCoordinate3 &d = _data[i];
+            xy[i] = Complex(d.x(), d.y());
+            z[i]  = Complex(d.z(), 0.0);
+        }
+
+        if (!_dft.Forward(xy) || !_dft.Forward(z))
+        {
+            return shared_ptr<const FourierCoefficients>();
+        }
+
+        coefficients->centroid = DCoordinate3(xy[0].real(), xy[0].imag(), z[0].real());
+        coefficients->centroid /= (GLdouble)data_count;
+
+        // the ratios binom(2n, n + k) / binom(2n, n) are calculated by a recurrence in order to avoid
+        // overflows for large orders
+        GLdouble ratio = 1.0;
+        for (GLuint k = 1; k <= _n; ++k)
+        {
+            ratio *= (GLdouble)(_n - k + 1) / (GLdouble)(_n + k);
+
+            GLdouble scale = 2.0 * ratio / (GLdouble)data_count;
+
+            Complex x = 0.5 * (xy[k] + conj(xy[data_count - k]));
+            Complex y = Complex(0.0, -0.5) * (xy[k] - conj(xy[data_count - k]));
+
+            coefficients->real[k - 1] = DCoordinate3(x.real(), y.real(), z[k].real()) * scale;
+            coefficients->imag[k - 1] = DCoordinate3(x.imag(), y.imag(), z[k].imag()) * scale;
+        }
+
+        _coefficients = coefficients;
+
+        return _coefficients;
+    }
+
+    // point and derivatives up to the given order at u
+    GLvoid CyclicCurve3::_Evaluate(const FourierCoefficients& coefficients, GLuint max_order_of_derivatives, GLdouble u,
+                                   DCoordinate3 *d, GLuint stride) const
+    {
+        d[0] = coefficients.centroid;
+
+        for (GLuint r = 1; r <= max_order_of_derivatives; ++r)
+        {
+            d[r * stride] = DCoordinate3();
+        }
+
+        // e^{iku} = e^{i(k-1)u} * e^{iu}
+        GLdouble c_1 = cos(u), s_1 = sin(u), c_k = 1.0, s_k = 0.0;
+
+        for (GLuint k = 1; k <= _n; ++k)
+        {
+            GLdouble c = c_k * c_1 - s_k * s_1;
+            s_k = s_k * c_1 + c_k * s_1;
+            c_k = c;
+
+            // e^{iku} * C_k = p + i * q
+            const DCoordinate3 &real = coefficients.real[k - 1], &imag = coefficients.imag[k - 1];
+
+            DCoordinate3 p(c_k * real[0] - s_k * imag[0], c_k * real[1] - s_k * imag[1], c_k * real[2] - s_k * imag[2]);
+            DCoordinate3 q(c_k * imag[0] + s_k * real[0], c_k * imag[1] + s_k * real[1], c_k * imag[2] + s_k * real[2]);
+
+            // the real part of (ik)^r * (p + i * q)
+            GLdouble power = 1.0;
+
+            for (GLuint r = 0; r <= max_order_of_derivatives; ++r, power *= k)
+            {
+                switch (r % 4)
+                {
+                case 0: d[r * stride] += p * power; break;
+                case 1: d[r * stride] -= q * power; break;
+                case 2: d[r * stride] -= p * power; break;
+                case 3: d[r * stride] += q * power; break;
+                }
+            }
+        }
+    }
+
     GLboolean CyclicCurve3::CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u, Derivatives &d) const
     {
+        shared_ptr<const FourierCoefficients> coefficients = _GetFourierCoefficients();
+
+        if (!coefficients)
+        {
+            return GL_FALSE;
+        }
+
         d.ResizeRows(max_order_of_derivatives + 1);
-        d.LoadNullVectors();
 
-        DCoordinate3 centroid;
+        _Evaluate(*coefficients, max_order_of_derivatives, u, d.data(), 1);
+
+        return GL_TRUE;
+    }
+
+    // the coefficients are calculated only once for the whole sweep
+    GLboolean CyclicCurve3::EvaluateMany(
+            const ColumnMatrix<GLdouble>& parameters, GLuint max_order_of_derivatives,
+            Matrix<DCoordinate3>& derivatives) const
+    {
+        shared_ptr<const FourierCoefficients> coefficients = _GetFourierCoefficients();
+
+        GLuint parameter_count = parameters.GetRowCount();
 
-        for (GLuint i = 0; i <= 2 * _n; ++i)
+        if (!coefficients ||
+            !derivatives.ResizeRows(max_order_of_derivatives + 1) ||
+            !derivatives.ResizeColumns(parameter_count))
         {
-            centroid += _data[i];
+            return GL_FALSE;
         }
-        centroid /= (GLdouble)(2 * _n + 1);
 
-        for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+        for (GLuint k = 0; k < parameter_count; ++k)
         {
-            for (GLuint i = 0; i <= 2 * _n; ++i)
+            _Evaluate(*coefficients, max_order_of_derivatives, parameters(k), derivatives.data() + k, parameter_count);
+        }
+
+        return GL_TRUE;
+    }
+
+    // F_i^{(r)}(u) = [r = 0] / (2n + 1) + 2 / (2n + 1) * sum_{k=1}^{n} binom(2n, n + k) / binom(2n, n) *
+    // k^r * cos(k * (u - i * _lambda_n) + r * pi / 2), where the cosines are generated by the
+    // angle-addition recurrence
+    GLboolean CyclicCurve3::BlendingFunctionDerivatives(GLuint max_order_of_derivatives, GLdouble u, Matrix<GLdouble> &derivatives) const
+    {
+        GLuint data_count = 2 * _n + 1;
+
+        derivatives.ResizeRows(max_order_of_derivatives + 1);
+        derivatives.ResizeColumns(data_count);
+
+        vector<GLdouble> weight(_n + 1);
+        weight[0] = 1.0 / (GLdouble)data_count;
+        for (GLuint k = 1; k <= _n; ++k)
+        {
+            weight[k] = weight[k - 1] * (GLdouble)(_n - k + 1) / (GLdouble)(_n + k);
+        }
+
+        for (GLuint i = 0; i < data_count; ++i)
+        {
+            for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
             {
-                GLdouble sum_k = 0.0;
+                derivatives(r, i) = r ? 0.0 : weight[0];
+            }
+
+            GLdouble t = u - i * _lambda_n;
+            GLdouble c_1 = cos(t), s_1 = sin(t), c_k = 1.0, s_k = 0.0;
+
+            for (GLuint k = 1; k <= _n; ++k)
+            {
+                GLdouble c = c_k * c_1 - s_k * s_1;
+                s_k = s_k * c_1 + c_k * s_1;
+                c_k = c;
 
-                for (GLuint k = 0; k <= _n - 1; ++k)
+                GLdouble power = 2.0 * weight[k];
+
+                for (GLuint r = 0; r <= max_order_of_derivatives; ++r, power *= k)
                 {
-                    sum_k += pow(_n - k, (GLuint) r) *
-                            _bc(2 * _n, k) *
-                            cos((_n - k) * (u - i * _lambda_n) + r * PI / 2.0);
+                    switch (r % 4)
+                    {
+                    case 0: derivatives(r, i) += power * c_k; break;
+                    case 1: derivatives(r, i) -= power * s_k; break;
+                    case 2: derivatives(r, i) -= power * c_k; break;
+                    case 3: derivatives(r, i) += power * s_k; break;
+                    }
                 }
-                d[r] += sum_k * _data[i];
             }
-            d[r] *= 2.0;
-            d[r] /= (GLdouble)(2 * _n + 1);
-            d[r] /= _bc(2 *_n, _n);
         }
-        d[0] += centroid;
+
+        return GL_TRUE;
+    }
+
+    GLboolean CyclicCurve3::UpdateDataForInterpolation(const ColumnMatrix<GLdouble>& knot_vector, const ColumnMatrix<DCoordinate3>& data_points_to_interpolate)
+    {
+        GLuint data_count = 2 * _n + 1;
+
+        if (data_count != knot_vector.GetRowCount() ||
+            data_count != data_points_to_interpolate.GetRowCount())
+            return GL_FALSE;
+
+        // is the knot vector an arithmetic progression with difference _lambda_n?
+        GLboolean knots_are_uniform = GL_TRUE;
+        for (GLuint r = 1; r < data_count && knots_are_uniform; ++r)
+        {
+            knots_are_uniform = abs(knot_vector[r] - knot_vector[0] - r * _lambda_n) <= EPS;
+        }
+
+        if (knots_are_uniform)
+        {
+            return _UpdateDataForUniformInterpolation(knot_vector[0], data_points_to_interpolate);
+        }
+
+        return LinearCombination3::UpdateDataForInterpolation(knot_vector, data_points_to_interpolate);
+    }
+
+    // Since F_i(u) = f(u - i * _lambda_n), where f(t) = _c_n * (1 + cos(t))^n, the collocation matrix
+    // [F_i(u_0 + r * _lambda_n)] = [f(u_0 + (r - i) * _lambda_n)] is circulant, i.e., the interpolation
+    // conditions form a cyclic convolution of the samples c_m = f(u_0 + m * _lambda_n) with the unknown
+    // control points. The function f is a trigonometric polynomial of order n:
+    //
+    // f(t) = 1 / (2n + 1) * sum_{k=-n}^{n} binom(2n, n + k) / binom(2n, n) * e^{ikt},
+    //
+    // therefore the k-th eigenvalue of the collocation matrix is
+    //
+    // e^{iku_0} * binom(2n, n + k) / binom(2n, n),
+    //
+    // and the control points are obtained by dividing the transformed data points by these eigenvalues.
+    // The complex linear system is real-linear, thus x and y coordinates are solved together as the real
+    // and imaginary parts of a single complex sequence.
+    GLboolean CyclicCurve3::_UpdateDataForUniformInterpolation(GLdouble u_0, const ColumnMatrix<DCoordinate3>& data_points_to_interpolate)
+    {
+        typedef DiscreteFourierTransform::Complex Complex;
+
+        GLuint data_count = 2 * _n + 1;
+
+        // eigenvalues of the collocation matrix, the ratios of binomial coefficients are
+        // calculated by a recurrence in order to avoid overflows for large orders
+        vector<Complex> eigenvalues(data_count);
+        GLdouble ratio = 1.0;
+        eigenvalues[0] = Complex(1.0, 0.0);
+        for (GLuint k = 1; k <= _n; ++k)
+        {
+            ratio *= (GLdouble)(_n - k + 1) / (GLdouble)(_n + k);
+
+            eigenvalues[k]              = ratio * Complex(cos(k * u_0),  sin(k * u_0));
+            eigenvalues[data_count - k] = ratio * Complex(cos(k * u_0), -sin(k * u_0));
+        }
+
+        vector<Complex> xy(data_count), z(data_count);
+        for (GLuint i = 0; i < data_count; ++i)
+        {
+            const DCoordinate3 &d = data_points_to_interpolate[i];
+            xy[i] = Complex(d.x(), d.y());
+            z[i]  = Complex(d.z(), 0.0);
+        }
+
+        if (!_dft.Forward(xy) || !_dft.Forward(z))
+            return GL_FALSE;
+
+        for (GLuint k = 0; k < data_count; ++k)
+        {
+            xy[k] /= eigenvalues[k];
+            z[k]  /= eigenvalues[k];
+        }
+
+        if (!_dft.Inverse(xy) || !_dft.Inverse(z))
+            return GL_FALSE;
+
+        for (GLuint i = 0; i < data_count; ++i)
+        {
+            _data[i] = DCoordinate3(xy[i].real(), xy[i].imag(), z[i].real());
+        }
+        ++_data_version;
 
         return GL_TRUE;
     }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "../Core/DiscreteFourierTransforms.h"
 #include "../Core/LinearCombination3.h"
 #include "../Core/Matrices.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace cagd {
 
@@ -13,16 +17,70 @@ namespace cagd {
 
         TriangularMatrix<GLdouble>  _bc;        // binomial coefficients
 
+        DiscreteFourierTransform    _dft;       // transform of length 2n + 1
+
+        // The curve can be written as
+        //
+        // c(u) = centroid + sum_{k=1}^{n} Re(e^{iku} * C_k),
+        //
+        // where C_k = 2 / (2n + 1) * binom(2n, n + k) / binom(2n, n) * sum_{i=0}^{2n} d_i e^{-iki * _lambda_n}
+        // are scaled discrete Fourier coefficients of the control points, while the r-th order derivative
+        // is obtained by replacing C_k with (ik)^r * C_k. The coefficients are recalculated only if the
+        // control points differ from the ones that were used to calculate them.
+        class FourierCoefficients
+        {
+        public:
+            std::vector<DCoordinate3>   data;           // control points used to calculate the coefficients
+            DCoordinate3                centroid;
+            std::vector<DCoordinate3>   real, imag;     // C_k = real[k] + i * imag[k], k = 1, 2, ..., n
+        };
+
+        mutable std::shared_ptr<const FourierCoefficients>  _coefficients;
+        mutable std::mutex                                  _coefficient_mutex;
+
+        // returns coefficients that belong to the current control points
+        std::shared_ptr<const FourierCoefficients> _GetFourierCoefficients() const;
+
+        // point and derivatives up to the given order at u, by means of the angle-addition recurrence of
+        // e^{iku}, i.e., by O(n * (max_order_of_derivatives + 1)) multiply-adds
+        GLvoid _Evaluate(const FourierCoefficients& coefficients, GLuint max_order_of_derivatives, GLdouble u,
+                         DCoordinate3 *d, GLuint stride) const;
+
         GLdouble    _CalculateNormalizingCoefficient(GLuint);
         GLvoid      _CalculateBinomialCoefficients(GLuint m, TriangularMatrix<GLdouble>& bc);
 
+        // solves the circulant interpolation problem that corresponds to the uniform knot vector
+        // u_r = u_0 + r * _lambda_n, r = 0, 1, ..., 2n, in O(n log n) operations
+        GLboolean   _UpdateDataForUniformInterpolation(GLdouble u_0, const ColumnMatrix<DCoordinate3>& data_points_to_interpolate);
+
     public:
         // special constructor
         CyclicCurve3(GLuint n, GLenum data_usage_flag = GL_STATIC_DRAW);
 
+        // copy constructor
+        CyclicCurve3(const CyclicCurve3& curve);
+
+        // assignment operator
+        CyclicCurve3& operator =(const CyclicCurve3& rhs);
+
         // redeclaration and define inherited pure virtual methods
         GLboolean BlendingFunctionValues(GLdouble u, RowMatrix<GLdouble>& values) const;
         GLboolean CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u, Derivatives &d) const;
+
+        // tables of blending function derivatives, which make repeated image generation and
+        // incremental image updates cheap
+        GLboolean BlendingFunctionDerivatives(GLuint max_order_of_derivatives, GLdouble u, Matrix<GLdouble> &derivatives) const;
+
+        // redeclared in order to evaluate whole sweeps by means of the Fourier coefficients, i.e., without
+        // blending function tables
+        GLboolean EvaluateMany(
+                const ColumnMatrix<GLdouble>& parameters, GLuint max_order_of_derivatives,
+                Matrix<DCoordinate3>& derivatives) const;
+
+        // redeclared in order to detect uniform knot vectors, for which the collocation matrix is
+        // circulant and can be diagonalized by the discrete Fourier transform; otherwise the
+        // dense solver of the base class is used
+        GLboolean UpdateDataForInterpolation(const ColumnMatrix<GLdouble>& knot_vector, const ColumnMatrix<DCoordinate3>& data_points_to_interpolate);
     };
 
 }
@@ -382,7 +382,7 @@ namespace cagd
         derivative[2] = spiral_on_cone::d2;
 
         _pc[0] = nullptr;
-        _pc[0] = new (nothrow) ParametricCurve3(derivative, spiral_on_cone::u_min, spiral_on_cone::u_max);
+        _pc[0] = new (nothrow) ParametricCurve3(derivative, spiral_on_cone::u_min, spiral_on_cone::u_max, spiral_on_cone::batch);
 
         if (!_pc[0])
         {
@@ -394,7 +394,7 @@ namespace cagd
         derivative[2] = torus_knot::d2;
 
         _pc[1] = nullptr;
-        _pc[1] = new (nothrow) ParametricCurve3(derivative, torus_knot::u_min, torus_knot::u_max);
+        _pc[1] = new (nothrow) ParametricCurve3(derivative, torus_knot::u_min, torus_knot::u_max, torus_knot::batch);
 
         if (!_pc[1])
         {
@@ -406,7 +406,7 @@ namespace cagd
         derivative[2] = spiral_on_sphere::d2;
 
         _pc[2] = nullptr;
-        _pc[2] = new (nothrow) ParametricCurve3(derivative, spiral_on_sphere::u_min, spiral_on_sphere::u_max);
+        _pc[2] = new (nothrow) ParametricCurve3(derivative, spiral_on_sphere::u_min, spiral_on_sphere::u_max, spiral_on_sphere::batch);
 
         if (!_pc[2])
         {
@@ -418,7 +418,7 @@ namespace cagd
         derivative[2] = viviani::d2;
 
         _pc[3] = nullptr;
-        _pc[3] = new (nothrow) ParametricCurve3(derivative, viviani::u_min, viviani::u_max);
+        _pc[3] = new (nothrow) ParametricCurve3(derivative, viviani::u_min, viviani::u_max, viviani::batch);
 
         if (!_pc[3])
         {
@@ -430,7 +430,7 @@ namespace cagd
         derivative[2] = hypocycloid::d2;
 
         _pc[4] = nullptr;
-        _pc[4] = new (nothrow) ParametricCurve3(derivative, hypocycloid::u_min, hypocycloid::u_max);
+        _pc[4] = new (nothrow) ParametricCurve3(derivative, hypocycloid::u_min, hypocycloid::u_max, hypocycloid::batch);
 
         if (!_pc[4])
         {
@@ -442,7 +442,7 @@ namespace cagd
         derivative[2] = epitrochoid::d2;
 
         _pc[5] = nullptr;
-        _pc[5] = new (nothrow) ParametricCurve3(derivative, epitrochoid::u_min, epitrochoid::u_max);
+        _pc[5] = new (nothrow) ParametricCurve3(derivative, epitrochoid::u_min, epitrochoid::u_max, epitrochoid::batch);
 
         if (!_pc[5])
         {
@@ -453,7 +453,7 @@ namespace cagd
 
         for (GLuint i = 0; i < _pc_count; i++)
         {
-            _image_of_pc[i] = _pc[i]->GenerateImage(_div_point_count, _usage_flag_pc);
+            _image_of_pc[i] = _generateParametricCurveImage(i);
 
             if (!_image_of_pc[i] || !_image_of_pc[i]->UpdateVertexBufferObjects(_scale, _usage_flag_pc))
             {
@@ -481,6 +481,17 @@ namespace cagd
         }
     }
 
+    // uniform or adaptive image of a parametric curve
+    GenericCurve3* GLWidget::_generateParametricCurveImage(GLuint index) const
+    {
+        if (_adaptive_pc)
+        {
+            return _pc[index]->GenerateAdaptiveImage(_pc_chord_tolerance, _pc_angular_tolerance, _usage_flag_pc);
+        }
+
+        return _pc[index]->GenerateImage(_div_point_count, _usage_flag_pc);
+    }
+
     bool GLWidget::_createSelectedParametricCurveImage()
     {
         if (_image_of_pc[_selected_pc])
@@ -488,7 +499,7 @@ namespace cagd
             delete _image_of_pc[_selected_pc];
         }
 
-        _image_of_pc[_selected_pc] = _pc[_selected_pc]->GenerateImage(_div_point_count, _usage_flag_pc);
+        _image_of_pc[_selected_pc] = _generateParametricCurveImage(_selected_pc);
 
         if (!_image_of_pc[_selected_pc] || !_image_of_pc[_selected_pc]->UpdateVertexBufferObjects(_scale, _usage_flag_pc))
         {
@@ -550,7 +561,8 @@ namespace cagd
         _ps[0] = new (nothrow) ParametricSurface3(
                     derivative,
                     torus::u_min, torus::u_max,
-                    torus::v_min, torus::v_max
+                    torus::v_min, torus::v_max,
+                    torus::batch
                     );
 
         if (!_ps[0])
@@ -565,7 +577,8 @@ namespace cagd
         _ps[1] = new (nothrow) ParametricSurface3(
                     derivative,
                     dupin_cyclide::u_min, dupin_cyclide::u_max,
-                    dupin_cyclide::v_min, dupin_cyclide::v_max
+                    dupin_cyclide::v_min, dupin_cyclide::v_max,
+                    dupin_cyclide::batch
                     );
 
         if (!_ps[1])
@@ -580,7 +593,8 @@ namespace cagd
         _ps[2] = new (nothrow) ParametricSurface3(
                     derivative,
                     sphere::u_min, sphere::u_max,
-                    sphere::v_min, sphere::v_max
+                    sphere::v_min, sphere::v_max,
+                    sphere::batch
                     );
 
         if (!_ps[2])
@@ -595,7 +609,8 @@ namespace cagd
         _ps[3] = new (nothrow) ParametricSurface3(
                     derivative,
                     cylinder::u_min, cylinder::u_max,
-                    cylinder::v_min, cylinder::v_max
+                    cylinder::v_min, cylinder::v_max,
+                    cylinder::batch
                     );
 
         if (!_ps[3])
@@ -610,7 +625,8 @@ namespace cagd
         _ps[4] = new (nothrow) ParametricSurface3(
                     derivative,
                     cone::u_min, cone::u_max,
-                    cone::v_min, cone::v_max
+                    cone::v_min, cone::v_max,
+                    cone::batch
                     );
 
         if (!_ps[4])
@@ -625,7 +641,8 @@ namespace cagd
         _ps[5] = new (nothrow) ParametricSurface3(
                     derivative,
                     seashell::u_min, seashell::u_max,
-                    seashell::v_min, seashell::v_max
+                    seashell::v_min, seashell::v_max,
+                    seashell::batch
                     );
 
         if (!_ps[5])
@@ -772,15 +789,34 @@ namespace cagd
             delete _image_of_cc;
         }
 
-        _image_of_cc = _cc->GenerateImage(_max_order_of_derivatives, _cc_div_point_count, GL_STATIC_DRAW);
+        // the vertex buffer objects of the image are rewritten in place by every control point edit
+        _image_of_cc = _cc->GenerateImage(_max_order_of_derivatives, _cc_div_point_count, GL_DYNAMIC_DRAW);
 
-        if (!_image_of_cc || !_image_of_cc->UpdateVertexBufferObjects())
+        if (!_image_of_cc || !_image_of_cc->UpdateVertexBufferObjects(0.2, GL_DYNAMIC_DRAW))
         {
             return false;
         }
         return true;
     }
 
+    // the image depends linearly on the control points, therefore after changing a single one of them
+    // the existing image is updated in place instead of being regenerated
+    bool GLWidget::_updateCyclicCurveImage(GLuint index, const DCoordinate3& delta)
+    {
+        if (!_cc->UpdateVertexBufferObjectsOfData())
+        {
+            _destroyCyclicCurvesAndTheirImages();
+            return false;
+        }
+
+        if (!_image_of_cc || !_cc->UpdateImageForDataChange(index, delta, *_image_of_cc))
+        {
+            return _updateCyclicCurveImage();
+        }
+
+        return _image_of_cc->UpdateVertexBufferObjectsInPlace();
+    }
+
     bool GLWidget::_updateInterpolatingCyclicCurveImage()
     {
         // updating VBO
@@ -1637,6 +1673,31 @@ namespace cagd
         }
     }
 
+    void GLWidget::setAdaptiveSampling(bool adaptive)
+    {
+        if (_adaptive_pc != adaptive)
+        {
+            _adaptive_pc = adaptive;
+            _createSelectedParametricCurveImage();
+            update();
+        }
+    }
+
+    void GLWidget::setChordTolerance(double chord_tolerance)
+    {
+        if (_pc_chord_tolerance != chord_tolerance)
+        {
+            _pc_chord_tolerance = chord_tolerance;
+
+            // uniform images do not depend on the tolerance
+            if (_adaptive_pc)
+            {
+                _createSelectedParametricCurveImage();
+                update();
+            }
+        }
+    }
+
     void GLWidget::resetPcAttributes()
     {
         _show_tangents = false;
@@ -1704,25 +1765,28 @@ namespace cagd
 
     void GLWidget::cc_cp_set_x(double x)
     {
+        DCoordinate3 delta(x - (*_cc)[_selected_cp].x(), 0.0, 0.0);
         _data_points[_selected_cp].x() = x;
         (*_cc)[_selected_cp].x() = x;
-        _updateCyclicCurveImage();
+        _updateCyclicCurveImage(_selected_cp, delta);
         _updateInterpolatingCyclicCurveImage();
         update();
     }
     void GLWidget::cc_cp_set_y(double y)
     {
+        DCoordinate3 delta(0.0, y - (*_cc)[_selected_cp].y(), 0.0);
         _data_points[_selected_cp].y() = y;
         (*_cc)[_selected_cp].y() = y;
-        _updateCyclicCurveImage();
+        _updateCyclicCurveImage(_selected_cp, delta);
         _updateInterpolatingCyclicCurveImage();
         update();
     }
     void GLWidget::cc_cp_set_z(double z)
     {
+        DCoordinate3 delta(0.0, 0.0, z - (*_cc)[_selected_cp].z());
         _data_points[_selected_cp].z() = z;
         (*_cc)[_selected_cp].z() = z;
-        _updateCyclicCurveImage();
+        _updateCyclicCurveImage(_selected_cp, delta);
         _updateInterpolatingCyclicCurveImage();
         update();
     }
@@ -2242,128 +2306,68 @@ namespace cagd
 
     void GLWidget::patch_move_x_minus()
     {
-
         DCoordinate3 selectedPoint;
-        for (GLuint i = 0; i <= 3; i++)
+        if (_compositeSurface->MovePatch(_selectedPatch1, DCoordinate3(-1.0, 0.0, 0.0)) &&
+            _compositeSurface->GetDataPointValues(_selectedPatch1, _selectedPointRow, _selectedPointCol, selectedPoint))
         {
-            for (GLuint j = 0; j <= 3; j++)
-            {
-                _compositeSurface->GetDataPointValues(_selectedPatch1, i, j, selectedPoint);
-                selectedPoint.x() = selectedPoint.x() - 1.0;
-                _compositeSurface->UpdatePatch(_selectedPatch1, i, j, selectedPoint);
-                if (_selectedPointRow == i && _selectedPointCol == j)
-                {
-                    emit patch_control_point_x_changed(selectedPoint.x());
-                }
-            }
+            emit patch_control_point_x_changed(selectedPoint.x());
         }
         update();
-
     }
 
     void GLWidget::patch_move_x_plus()
     {
-
         DCoordinate3 selectedPoint;
-        for (GLuint i = 0; i <= 3; i++)
+        if (_compositeSurface->MovePatch(_selectedPatch1, DCoordinate3(1.0, 0.0, 0.0)) &&
+            _compositeSurface->GetDataPointValues(_selectedPatch1, _selectedPointRow, _selectedPointCol, selectedPoint))
         {
-            for (GLuint j = 0; j <= 3; j++)
-            {
-                _compositeSurface->GetDataPointValues(_selectedPatch1, i, j, selectedPoint);
-                selectedPoint.x() = selectedPoint.x() + 1.0;
-                _compositeSurface->UpdatePatch(_selectedPatch1, i, j, selectedPoint);
-                if (_selectedPointRow == i && _selectedPointCol == j)
-                {
-                    emit patch_control_point_x_changed(selectedPoint.x());
-                }
-            }
+            emit patch_control_point_x_changed(selectedPoint.x());
         }
         update();
-
     }
 
     void GLWidget::patch_move_y_minus()
     {
-
         DCoordinate3 selectedPoint;
-        for (GLuint i = 0; i <= 3; i++)
+        if (_compositeSurface->MovePatch(_selectedPatch1, DCoordinate3(0.0, -1.0, 0.0)) &&
+            _compositeSurface->GetDataPointValues(_selectedPatch1, _selectedPointRow, _selectedPointCol, selectedPoint))
         {
-            for (GLuint j = 0; j <= 3; j++)
-            {
-                _compositeSurface->GetDataPointValues(_selectedPatch1, i, j, selectedPoint);
-                selectedPoint.y() = selectedPoint.y() - 1.0;
-                _compositeSurface->UpdatePatch(_selectedPatch1, i, j, selectedPoint);
-                if (_selectedPointRow == i && _selectedPointCol == j)
-                {
-                    emit patch_control_point_y_changed(selectedPoint.y());
-                }
-            }
+            emit patch_control_point_y_changed(selectedPoint.y());
         }
         update();
-
     }
 
     void GLWidget::patch_move_y_plus()
     {
-
         DCoordinate3 selectedPoint;
-        for (GLuint i = 0; i <= 3; i++)
+        if (_compositeSurface->MovePatch(_selectedPatch1, DCoordinate3(0.0, 1.0, 0.0)) &&
+            _compositeSurface->GetDataPointValues(_selectedPatch1, _selectedPointRow, _selectedPointCol, selectedPoint))
         {
-            for (GLuint j = 0; j <= 3; j++)
-            {
-                _compositeSurface->GetDataPointValues(_selectedPatch1, i, j, selectedPoint);
-                selectedPoint.y() = selectedPoint.y() + 1.0;
-                _compositeSurface->UpdatePatch(_selectedPatch1, i, j, selectedPoint);
-                if (_selectedPointRow == i && _selectedPointCol == j)
-                {
-                    emit patch_control_point_y_changed(selectedPoint.y());
-                }
-            }
+            emit patch_control_point_y_changed(selectedPoint.y());
         }
         update();
-
     }
 
     void GLWidget::patch_move_z_minus()
     {
-
         DCoordinate3 selectedPoint;
-        for (GLuint i = 0; i <= 3; i++)
+        if (_compositeSurface->MovePatch(_selectedPatch1, DCoordinate3(0.0, 0.0, -1.0)) &&
+            _compositeSurface->GetDataPointValues(_selectedPatch1, _selectedPointRow, _selectedPointCol, selectedPoint))
         {
-            for (GLuint j = 0; j <= 3; j++)
-            {
-                _compositeSurface->GetDataPointValues(_selectedPatch1, i, j, selectedPoint);
-                selectedPoint.z() = selectedPoint.z() - 1.0;
-                _compositeSurface->UpdatePatch(_selectedPatch1, i, j, selectedPoint);
-                if (_selectedPointRow == i && _selectedPointCol == j)
-                {
-                    emit patch_control_point_z_changed(selectedPoint.z());
-                }
-            }
+            emit patch_control_point_z_changed(selectedPoint.z());
         }
         update();
-
     }
 
     void GLWidget::patch_move_z_plus()
     {
-
         DCoordinate3 selectedPoint;
-        for (GLuint i = 0; i <= 3; i++)
+        if (_compositeSurface->MovePatch(_selectedPatch1, DCoordinate3(0.0, 0.0, 1.0)) &&
+            _compositeSurface->GetDataPointValues(_selectedPatch1, _selectedPointRow, _selectedPointCol, selectedPoint))
         {
-            for (GLuint j = 0; j <= 3; j++)
-            {
-                _compositeSurface->GetDataPointValues(_selectedPatch1, i, j, selectedPoint);
-                selectedPoint.z() = selectedPoint.z() + 1.0;
-                _compositeSurface->UpdatePatch(_selectedPatch1, i, j, selectedPoint);
-                if (_selectedPointRow == i && _selectedPointCol == j)
-                {
-                    emit patch_control_point_z_changed(selectedPoint.z());
-                }
-            }
+            emit patch_control_point_z_changed(selectedPoint.z());
         }
         update();
-
     }
 
     void GLWidget::update_u_iso_line_count(int iso_line_count){
@@ -2380,6 +2384,40 @@ namespace cagd
 
     }
 
+    void GLWidget::set_patch_max_deviation(double maximum_deviation){
+
+        _compositeSurface->SetMaximumDeviation(maximum_deviation);
+        update();
+
+    }
+
+    void GLWidget::set_patch_adaptive_tessellation(bool adaptive){
+
+        if (_adaptivePatches != adaptive)
+        {
+            _adaptivePatches = adaptive;
+            _compositeSurface->SetAdaptiveTessellation(_adaptivePatches, _patchChordTolerance);
+            update();
+        }
+
+    }
+
+    void GLWidget::set_patch_chord_tolerance(double chord_tolerance){
+
+        if (_patchChordTolerance != chord_tolerance)
+        {
+            _patchChordTolerance = chord_tolerance;
+
+            // uniform images do not depend on the tolerance
+            if (_adaptivePatches)
+            {
+                _compositeSurface->SetAdaptiveTessellation(_adaptivePatches, _patchChordTolerance);
+                update();
+            }
+        }
+
+    }
+
     DCoordinate3 GLWidget::getMouseCoords(QMouseEvent *event)
     {
         cout<<this->height()<< " " << this -> geometry().height()<< " ";
@@ -2524,6 +2562,8 @@ namespace cagd
                         {
                             emit set_selected_cp_patch_row(cpX);
                             emit set_selected_cp_patch_column(cpY);
+                            // the images that are rebuilt while the control point is dragged are previewed in single precision
+                            _compositeSurface -> SetInteractivePreview(GL_TRUE);
                             GLdouble x,y;
                             _compositeSurface -> moveToMouse(selectedPatch, cpX, cpY, mC, x, y);
                             emit patch_cp_set_x(x);
@@ -2540,6 +2580,7 @@ namespace cagd
                         emit selected_patch1(selectedPatch);
                         emit set_selected_cp_patch_row(cpX);
                         emit set_selected_cp_patch_column(cpY);
+                        _compositeSurface -> SetInteractivePreview(GL_TRUE);
                         GLdouble x,y;
                         _compositeSurface -> moveToMouse(selectedPatch, cpX, cpY, mC, x, y);
                         emit patch_cp_set_x(x);
@@ -2554,6 +2595,12 @@ namespace cagd
     void GLWidget::mouseReleaseEvent(QMouseEvent *event)
     {
         QWidget::mouseReleaseEvent(event);
+        if (_homework_id == 6)
+        {
+            // the previewed images are regenerated in double precision at the end of the drag
+            _compositeSurface -> SetInteractivePreview(GL_FALSE);
+            update();
+        }
     }
 
 }
@@ -94,12 +94,16 @@ namespace cagd
         bool                         _show_tangents = false;
         bool                         _show_acceleration_vectors = false;
         int                          _div_point_count = 200;
+        bool                         _adaptive_pc = false;          // adaptive instead of uniform sampling
+        GLdouble                     _pc_chord_tolerance = 1.0e-3;
+        GLdouble                     _pc_angular_tolerance = 0.1;   // in radians
         GLdouble                     _scale = 1.0;
         GLenum                       _usage_flag_pc = GL_STATIC_DRAW;
 
         bool _createAllParametricCurvesAndTheirImages();
         void _destroyAllExistingParametricCurvesAndTheirImages();
         bool _createSelectedParametricCurveImage();
+        GenericCurve3* _generateParametricCurveImage(GLuint index) const;
         bool _renderSelectedParametricCurve();
 
         // parametric surfaces
@@ -135,6 +139,7 @@ namespace cagd
 
         bool _createCyclicCurvesAndTheirImages();
         bool _updateCyclicCurveImage();
+        bool _updateCyclicCurveImage(GLuint index, const DCoordinate3& delta);
         bool _updateInterpolatingCyclicCurveImage();
         void _destroyCyclicCurvesAndTheirImages();
         bool _renderCyclicCurves();
@@ -173,6 +178,8 @@ namespace cagd
         bool        _showIsoLinesD1V    = false;
         bool        _showNormalVectors  = false;
         bool        _showPatchData      = false;
+        bool        _adaptivePatches    = false;    // adaptive instead of uniform tessellation
+        GLdouble    _patchChordTolerance = 1.0e-3;
 
         bool        _shader             = true;
         bool        _light              = false;
@@ -252,6 +259,8 @@ namespace cagd
         void setVisibilityOfAccelerationVectors(bool visibility);
         void setDerivativeScale(double scale);
         void setDivPointCount(int div_point_count);
+        void setAdaptiveSampling(bool adaptive);
+        void setChordTolerance(double chord_tolerance);
 
         void resetPcAttributes();
 
@@ -302,6 +311,9 @@ namespace cagd
 
         void update_u_iso_line_count(int);
         void update_v_iso_line_count(int);
+        void set_patch_max_deviation(double);
+        void set_patch_adaptive_tessellation(bool);
+        void set_patch_chord_tolerance(double);
 
 
         // patches
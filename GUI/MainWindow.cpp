@@ -112,6 +112,9 @@ namespace cagd
         connect(_side_widget->show_iso_v_check_box, SIGNAL(toggled(bool)), _gl_widget, SLOT(setIsoLineVVisibility(bool)));
         connect(_side_widget->update_u_iso_lines, SIGNAL(valueChanged(int)), _gl_widget, SLOT(update_u_iso_line_count(int)));
         connect(_side_widget->update_v_iso_lines, SIGNAL(valueChanged(int)), _gl_widget, SLOT(update_v_iso_line_count(int)));
+        connect(_side_widget->patch_max_deviation_spin_box, SIGNAL(valueChanged(double)), _gl_widget, SLOT(set_patch_max_deviation(double)));
+        connect(_side_widget->patch_adaptive_check_box, SIGNAL(toggled(bool)), _gl_widget, SLOT(set_patch_adaptive_tessellation(bool)));
+        connect(_side_widget->patch_chord_tolerance_spin_box, SIGNAL(valueChanged(double)), _gl_widget, SLOT(set_patch_chord_tolerance(double)));
         connect(_side_widget->show_iso_d1_u_check_box, SIGNAL(toggled(bool)), _gl_widget, SLOT(setIsoLineD1UVisibility(bool)));
         connect(_side_widget->show_iso_d1_v_check_box, SIGNAL(toggled(bool)), _gl_widget, SLOT(setIsoLineD1VVisibility(bool)));
         connect(_side_widget->showNormalVectorsCheckBox, SIGNAL(toggled(bool)), _gl_widget, SLOT(setNormalsVisibility(bool)));
@@ -166,6 +169,10 @@ namespace cagd
         connect(_side_widget->patch_move_z_minus, SIGNAL(clicked()), _gl_widget, SLOT(patch_move_z_minus()));
         connect(_side_widget->patch_move_z_plus, SIGNAL(clicked()), _gl_widget, SLOT(patch_move_z_plus()));
 
+        // parametric curves
+        connect(_side_widget->adaptive_sampling_check_box, SIGNAL(toggled(bool)), _gl_widget, SLOT(setAdaptiveSampling(bool)));
+        connect(_side_widget->chord_tolerance_spin_box, SIGNAL(valueChanged(double)), _gl_widget, SLOT(setChordTolerance(double)));
+
         // change scene
         connect(_side_widget->toolBox, SIGNAL(currentChanged(int)), _gl_widget, SLOT(setID(int)));
     }
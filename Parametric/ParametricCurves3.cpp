@@ -8,11 +8,31 @@ using namespace std;
 //-----------------------------------------
 
 // special constructor
-ParametricCurve3::ParametricCurve3(const RowMatrix<Derivative>& derivatives, GLdouble u_min, GLdouble u_max):
-    _u_min(u_min), _u_max(u_max), _derivatives(derivatives)
+ParametricCurve3::ParametricCurve3(const RowMatrix<Derivative>& derivatives, GLdouble u_min, GLdouble u_max, DerivativeBatch batch):
+    _u_min(u_min), _u_max(u_max), _derivatives(derivatives), _batch(batch)
 {
 }
 
+// copy constructor
+ParametricCurve3::ParametricCurve3(const ParametricCurve3& curve):
+    _u_min(curve._u_min), _u_max(curve._u_max), _derivatives(curve._derivatives), _batch(curve._batch)
+{
+}
+
+// assignment operator
+ParametricCurve3& ParametricCurve3::operator =(const ParametricCurve3& rhs)
+{
+    if (this != &rhs)
+    {
+        _u_min = rhs._u_min;
+        _u_max = rhs._u_max;
+        _derivatives = rhs._derivatives;
+        _batch = rhs._batch;
+    }
+
+    return *this;
+}
+
 // calculate derivative at parameter u:
 // 0th order derivative corresponds to the curve point at parameter u
 // 1st order derivative corresponds to the tangent vector at parameter u
@@ -23,32 +43,198 @@ DCoordinate3 ParametricCurve3::operator ()(GLuint order, GLdouble u) const
     return _derivatives[order](u);
 }
 
+namespace
+{
+    // evaluates the batch form of the derivatives by means of the individual function pointers
+    class DerivativeEvaluator
+    {
+    protected:
+        const RowMatrix<ParametricCurve3::Derivative>& _derivatives;
+
+    public:
+        DerivativeEvaluator(const RowMatrix<ParametricCurve3::Derivative>& derivatives):
+            _derivatives(derivatives)
+        {
+        }
+
+        GLvoid operator ()(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d) const
+        {
+            for (GLuint order = 0; order <= max_order_of_derivatives; ++order)
+            {
+                for (GLuint k = 0; k < count; ++k)
+                {
+                    d[order * count + k] = _derivatives[order](u[k]);
+                }
+            }
+        }
+    };
+}
+
 // generate image of the parametric curve
 GenericCurve3* ParametricCurve3::GenerateImage(GLuint div_point_count, GLenum usage_flag) const
 {
-    GenericCurve3* result = nullptr;
+    GLuint order_count = _derivatives.GetColumnCount();
 
-    result = new GenericCurve3(_derivatives.GetColumnCount() - 1, div_point_count, usage_flag);
+    if (!order_count)
+    {
+        return nullptr;
+    }
 
-    if (!result)
+    if (_batch)
+    {
+        return GenerateImage(_batch, _u_min, _u_max, order_count - 1, div_point_count, usage_flag);
+    }
+
+    return GenerateImage(DerivativeEvaluator(_derivatives), _u_min, _u_max, order_count - 1, div_point_count, usage_flag);
+}
+
+namespace
+{
+    // evaluates all given derivatives of a parametric curve for the adaptive sampler
+    class ParametricCurveEvaluator
+    {
+    protected:
+        const RowMatrix<ParametricCurve3::Derivative>& _derivatives;
+        ParametricCurve3::DerivativeBatch              _batch;
+
+    public:
+        ParametricCurveEvaluator(const RowMatrix<ParametricCurve3::Derivative>& derivatives, ParametricCurve3::DerivativeBatch batch):
+            _derivatives(derivatives), _batch(batch)
+        {
+        }
+
+        GLboolean operator ()(GLdouble u, DCoordinate3 *d) const
+        {
+            // a batch of a single point evaluates all derivatives in one pass
+            if (_batch)
+            {
+                _batch(1, &u, _derivatives.GetColumnCount() - 1, d);
+                return GL_TRUE;
+            }
+
+            for (GLuint order = 0; order < _derivatives.GetColumnCount(); ++order)
+            {
+                d[order] = _derivatives[order](u);
+            }
+
+            return GL_TRUE;
+        }
+    };
+}
+
+// generate an image with a variable number of points
+GenericCurve3* ParametricCurve3::GenerateAdaptiveImage(GLdouble chord_tolerance, GLdouble angular_tolerance, GLenum usage_flag) const
+{
+    GLuint order_count = _derivatives.GetColumnCount();
+
+    if (!order_count)
+    {
+        return nullptr;
+    }
+
+    AdaptiveCurveSampler sampler(chord_tolerance, angular_tolerance);
+
+    return sampler.GenerateImage(ParametricCurveEvaluator(_derivatives, _batch), _u_min, _u_max, order_count, order_count - 1, usage_flag);
+}
+
+namespace
+{
+    // the length of the first order derivative of a parametric curve
+    class ParametricCurveSpeed
+    {
+    protected:
+        ParametricCurve3::Derivative _d1;
+
+    public:
+        ParametricCurveSpeed(ParametricCurve3::Derivative d1): _d1(d1)
+        {
+        }
+
+        GLdouble operator ()(GLdouble u) const
+        {
+            return _d1(u).length();
+        }
+    };
+}
+
+// returns the arc length parametrization, rebuilds it if the domain or the derivatives have changed
+shared_ptr<const ParametricCurve3::ArcLengthParametrization> ParametricCurve3::_GetArcLengthParametrization() const
+{
+    lock_guard<mutex> lock(_arc_length_mutex);
+
+    if (_derivatives.GetColumnCount() < 2)
+    {
+        return shared_ptr<const ArcLengthParametrization>();
+    }
+
+    if (_arc_length && _arc_length->u_min == _u_min && _arc_length->u_max == _u_max && _arc_length->d1 == _derivatives[1])
+    {
+        return _arc_length;
+    }
+
+    shared_ptr<ArcLengthParametrization> arc_length = make_shared<ArcLengthParametrization>();
+
+    arc_length->u_min = _u_min;
+    arc_length->u_max = _u_max;
+    arc_length->d1    = _derivatives[1];
+
+    if (!arc_length->table.Build(ParametricCurveSpeed(arc_length->d1), _u_min, _u_max))
+    {
+        return shared_ptr<const ArcLengthParametrization>();
+    }
+
+    _arc_length = arc_length;
+
+    return _arc_length;
+}
+
+// total length of the curve
+GLdouble ParametricCurve3::GetArcLength() const
+{
+    shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+    return arc_length ? arc_length->table.GetLength() : 0.0;
+}
+
+// arc length s(u)
+GLdouble ParametricCurve3::ArcLength(GLdouble u) const
+{
+    shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+    return arc_length ? arc_length->table.ArcLength(ParametricCurveSpeed(arc_length->d1), u) : 0.0;
+}
+
+// parameter value u(s)
+GLdouble ParametricCurve3::ParameterAtArcLength(GLdouble s) const
+{
+    shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+    return arc_length ? arc_length->table.Parameter(ParametricCurveSpeed(arc_length->d1), s) : _u_min;
+}
+
+// generate an image whose points are distributed uniformly with respect to the arc length
+GenericCurve3* ParametricCurve3::GenerateArcLengthImage(GLuint div_point_count, GLenum usage_flag) const
+{
+    shared_ptr<const ArcLengthParametrization> arc_length = _GetArcLengthParametrization();
+
+    if (!arc_length || div_point_count < 2)
     {
         return nullptr;
     }
 
-    // set derivatives at the endpoints of the parametric curve
-    for (GLuint order = 0; order < _derivatives.GetColumnCount(); ++order)
+    GenericCurve3* result = new (nothrow) GenericCurve3(_derivatives.GetColumnCount() - 1, div_point_count, usage_flag);
+
+    if (!result)
     {
-        (*result)(order, 0) = _derivatives[order](_u_min);
-        (*result)(order, div_point_count - 1) = _derivatives[order](_u_max);
+        return nullptr;
     }
 
-    // calculate derivatives at inner curve points
-    GLdouble u_step = (_u_max - _u_min) / (div_point_count - 1);
-    GLdouble u = _u_min;
+    ParametricCurveSpeed speed(arc_length->d1);
+    GLdouble             s_step = arc_length->table.GetLength() / (div_point_count - 1);
 
-    for (GLuint i = 1; i < div_point_count - 1; i++)
+    for (GLuint i = 0; i < div_point_count; i++)
     {
-        u += u_step;
+        GLdouble u = (i == div_point_count - 1) ? _u_max : arc_length->table.Parameter(speed, i * s_step);
 
         for (GLuint order = 0; order < _derivatives.GetColumnCount(); ++order)
         {
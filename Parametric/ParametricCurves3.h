@@ -1,8 +1,16 @@
 #pragma once
 
+#include "../Core/AdaptiveCurveSamplers.h"
+#include "../Core/ArcLengthTables.h"
 #include "../Core/DCoordinates3.h"
+#include "../Core/DualNumbers.h"
 #include "../Core/GenericCurves3.h"
 #include "../Core/Matrices.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
 
 namespace cagd
 {
@@ -14,6 +22,16 @@ namespace cagd
     public:
         typedef DCoordinate3 (*Derivative)(GLdouble);
 
+        // batch form of the derivatives: the derivatives of order r = 0, 1, ..., max_order_of_derivatives are
+        // evaluated at the parameter values u[k], k = 0, 1, ..., count - 1, and stored by d[r * count + k]
+        typedef GLvoid (*DerivativeBatch)(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d);
+
+        // position function of the curve, which is differentiated automatically: if it is written as a template of
+        // its scalar type, it can be instantiated for nested dual numbers that carry the first and second order
+        // derivatives
+        typedef DualNumber<DualNumber<GLdouble, 1>, 1> Dual;
+        typedef Coordinate3<Dual> (*Position)(const Dual& u);
+
     private:
         // definition domain
         GLdouble _u_min, _u_max;
@@ -21,9 +39,33 @@ namespace cagd
         // derivatives of coordinate functions
         RowMatrix<Derivative> _derivatives;
 
+        // optional batch form of the derivatives, has to agree with _derivatives
+        DerivativeBatch _batch;
+
+        // the arc length table together with the definition domain and the first order derivative it was built from
+        class ArcLengthParametrization
+        {
+        public:
+            GLdouble        u_min, u_max;
+            Derivative      d1;
+            ArcLengthTable  table;
+        };
+
+        // arc length parametrization, rebuilt at the first query after the domain or the derivatives have changed
+        mutable std::shared_ptr<const ArcLengthParametrization> _arc_length;
+        mutable std::mutex                                      _arc_length_mutex;
+
+        std::shared_ptr<const ArcLengthParametrization> _GetArcLengthParametrization() const;
+
     public:
         // special constructor
-        ParametricCurve3(const RowMatrix<Derivative>& derivatives, GLdouble u_min, GLdouble u_max);
+        ParametricCurve3(const RowMatrix<Derivative>& derivatives, GLdouble u_min, GLdouble u_max, DerivativeBatch batch = nullptr);
+
+        // copy constructor
+        ParametricCurve3(const ParametricCurve3& curve);
+
+        // assignment operator
+        ParametricCurve3& operator =(const ParametricCurve3& rhs);
 
         // calculate derivative at the parameter value u
         DCoordinate3 operator ()(GLuint order, GLdouble u) const;
@@ -31,11 +73,142 @@ namespace cagd
         // generate image/arc
         GenericCurve3* GenerateImage(GLuint div_point_count, GLenum usage_flag = GL_STATIC_DRAW) const;
 
+        // the derivative of the given order (at most 2) of the curve that is given by its position function,
+        // instances can be stored by the row matrix of derivatives
+        template <Position position, GLuint order>
+        static DCoordinate3 AutomaticDerivative(GLdouble u);
+
+        // the batch form of the derivatives (up to the second order) of the curve that is given by its position
+        // function, each point is evaluated in a single pass
+        template <Position position>
+        static GLvoid AutomaticDerivativeBatch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d);
+
+        // generates the image of the curve that is described by the function object evaluate, which has to provide
+        // the method
+        //
+        //      GLvoid operator ()(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d) const
+        //
+        // with the same semantics as DerivativeBatch (thus batch function pointers are accepted as well); all
+        // subdivision points are evaluated by a single call that can be inlined
+        template <class Evaluator>
+        static GenericCurve3* GenerateImage(
+                const Evaluator& evaluate, GLdouble u_min, GLdouble u_max,
+                GLuint max_order_of_derivatives, GLuint div_point_count, GLenum usage_flag = GL_STATIC_DRAW);
+
+        // generate an image with a variable number of points: the uniform subdivision is refined until the
+        // chord and angular tolerances (in radians) are met, see the class AdaptiveCurveSampler; the angular
+        // criterion requires the first order derivative
+        GenericCurve3* GenerateAdaptiveImage(GLdouble chord_tolerance, GLdouble angular_tolerance, GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // arc length s(u) = int_{u_min}^{u} |c'(t)| dt, its inverse and the total length of the curve; the table
+        // of the arc length function is built on demand, and rebuilt lazily, i.e., at the first query after the
+        // definition domain or the derivatives have changed; the first order derivative is required
+        GLdouble GetArcLength() const;
+        GLdouble ArcLength(GLdouble u) const;
+        GLdouble ParameterAtArcLength(GLdouble s) const;
+
+        // generate an image whose points are distributed uniformly with respect to the arc length
+        GenericCurve3* GenerateArcLengthImage(GLuint div_point_count, GLenum usage_flag = GL_STATIC_DRAW) const;
+
         // set/get definition domain
         GLvoid SetDefinitionDomain(GLdouble u_min, GLdouble u_max);
         GLvoid GetDefinitionDomain(GLdouble& u_min, GLdouble& u_max) const;
 
         // set derivatives
         GLvoid SetDerivatives(const RowMatrix<Derivative>& derivatives);
+
+        // set/get the batch form of the derivatives, the null pointer switches it off
+        GLvoid SetDerivativeBatch(DerivativeBatch batch);
+        DerivativeBatch GetDerivativeBatch() const;
     };
+
+    inline GLvoid ParametricCurve3::SetDerivativeBatch(DerivativeBatch batch)
+    {
+        _batch = batch;
+    }
+
+    inline ParametricCurve3::DerivativeBatch ParametricCurve3::GetDerivativeBatch() const
+    {
+        return _batch;
+    }
+
+    template <ParametricCurve3::Position position, GLuint order>
+    DCoordinate3 ParametricCurve3::AutomaticDerivative(GLdouble u)
+    {
+        static_assert(order <= 2, "only the derivatives up to the second order are supported");
+
+        DCoordinate3 d[3];
+
+        AutomaticDerivativeBatch<position>(1, &u, order, d);
+
+        return d[order];
+    }
+
+    template <ParametricCurve3::Position position>
+    GLvoid ParametricCurve3::AutomaticDerivativeBatch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+    {
+        typedef DualNumber<GLdouble, 1> FirstOrderDual;
+
+        for (GLuint k = 0; k < count; ++k)
+        {
+            Coordinate3<Dual> p = position(Dual::Variable(FirstOrderDual::Variable(u[k], 0), 0));
+
+            for (GLuint i = 0; i < 3; ++i)
+            {
+                d[k][i] = p[i].value().value();
+
+                if (max_order_of_derivatives >= 1)
+                {
+                    d[count + k][i] = p[i].value().partial(0);
+                }
+
+                if (max_order_of_derivatives >= 2)
+                {
+                    d[2 * count + k][i] = p[i].partial(0).partial(0);
+                }
+            }
+        }
+    }
+
+    template <class Evaluator>
+    GenericCurve3* ParametricCurve3::GenerateImage(
+            const Evaluator& evaluate, GLdouble u_min, GLdouble u_max,
+            GLuint max_order_of_derivatives, GLuint div_point_count, GLenum usage_flag)
+    {
+        if (div_point_count < 2)
+        {
+            return nullptr;
+        }
+
+        GenericCurve3 *result = new (std::nothrow) GenericCurve3(max_order_of_derivatives, div_point_count, usage_flag);
+
+        if (!result)
+        {
+            return nullptr;
+        }
+
+        std::vector<GLdouble>     u(div_point_count);
+        std::vector<DCoordinate3> d((max_order_of_derivatives + 1) * div_point_count);
+
+        GLdouble u_step = (u_max - u_min) / (div_point_count - 1);
+
+        for (GLuint i = 0; i < div_point_count - 1; i++)
+        {
+            u[i] = std::min(u_min + i * u_step, u_max);
+        }
+
+        u[div_point_count - 1] = u_max;
+
+        evaluate(div_point_count, &u[0], max_order_of_derivatives, &d[0]);
+
+        for (GLuint order = 0; order <= max_order_of_derivatives; ++order)
+        {
+            for (GLuint i = 0; i < div_point_count; i++)
+            {
+                (*result)(order, i) = d[order * div_point_count + i];
+            }
+        }
+
+        return result;
+    }
 }
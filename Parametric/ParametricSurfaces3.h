@@ -1,7 +1,11 @@
 #pragma once
 
 #include <GL/glew.h>
+#include <algorithm>
+#include <new>
+#include <vector>
 #include "../Core/DCoordinates3.h"
+#include "../Core/DualNumbers.h"
 #include "../Core/Matrices.h"
 #include "../Core/TriangulatedMeshes3.h"
 
@@ -14,22 +18,230 @@ namespace cagd
         // of the parametric surface
         typedef DCoordinate3 (*PartialDerivative)(GLdouble, GLdouble);
 
+        // function pointer definition to the batch form of the zeroth and first order partial derivatives: the
+        // surface point and its partial derivatives with respect to u and v are evaluated at the parameter pairs
+        // (u[k], v[k]), k = 0, 1, ..., count - 1, and stored by d00[k], d10[k] and d01[k], respectively
+        typedef GLvoid (*PartialDerivativeBatch)(
+                GLuint count, const GLdouble *u, const GLdouble *v,
+                DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01);
+
+        // function pointer definition to the position function of the surface, which is differentiated automatically:
+        // if it is written as a template of its scalar type, it can be instantiated for dual numbers that carry the
+        // partial derivatives with respect to u and v
+        typedef DualNumber<GLdouble, 2> Dual;
+        typedef Coordinate3<Dual> (*Position)(const Dual& u, const Dual& v);
+
     protected:
         TriangularMatrix<PartialDerivative> _pd;    // function pointers
+        PartialDerivativeBatch _batch;              // optional, has to agree with _pd(0, 0), _pd(1, 0) and _pd(1, 1)
         GLdouble _u_min, _u_max;                    // definition domain in direction u
         GLdouble _v_min, _v_max;                    // definition domain in direction v
 
+        static const GLuint _parallel_threshold = 4096; // minimal vertex count for threading
+
     public:
         // special constructor
         ParametricSurface3(
                 const TriangularMatrix<PartialDerivative> &pd,
                 GLdouble u_min, GLdouble u_max,
-                GLdouble v_min, GLdouble v_max);
+                GLdouble v_min, GLdouble v_max,
+                PartialDerivativeBatch batch = nullptr);
+
+        // set/get the batch form of the partial derivatives, the null pointer switches it off
+        GLvoid SetPartialDerivativeBatch(PartialDerivativeBatch batch);
+        PartialDerivativeBatch GetPartialDerivativeBatch() const;
+
+        // the partial derivative of order (order_u, order_v), where order_u + order_v <= 1, of the surface that is
+        // given by its position function; instances can be stored by the triangular matrix of partial derivatives
+        template <Position position, GLuint order_u, GLuint order_v>
+        static DCoordinate3 AutomaticPartialDerivative(GLdouble u, GLdouble v);
+
+        // the batch form of the zeroth and first order partial derivatives of the surface that is given by its
+        // position function, each point is evaluated in a single pass
+        template <Position position>
+        static GLvoid AutomaticPartialDerivativeBatch(
+                GLuint count, const GLdouble *u, const GLdouble *v,
+                DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01);
 
         // generates the approximated tesselated image of the parametric surface
         TriangulatedMesh3* GenerateImage(
                 GLuint u_div_point_count,           // number of subdivision points in direction u
                 GLuint v_div_point_count,           // number of subdivision points in direction v
                 GLenum usage_flag = GL_STATIC_DRAW) const;
+
+        // generates the tesselated image of the surface that is described by the function object evaluate, which
+        // has to provide the method
+        //
+        //      GLvoid operator ()(GLuint count, const GLdouble *u, const GLdouble *v,
+        //                         DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01) const
+        //
+        // with the same semantics as PartialDerivativeBatch (thus batch function pointers are accepted as well);
+        // the surface is evaluated row by row, i.e., each call receives v_div_point_count parameter pairs with a
+        // common u value, and since the type of the function object is known at compile time, its calls can be
+        // inlined; the rows of large grids are evaluated in parallel, thus evaluate may be called concurrently
+        template <class Evaluator>
+        static TriangulatedMesh3* GenerateImage(
+                const Evaluator &evaluate,
+                GLdouble u_min, GLdouble u_max,
+                GLdouble v_min, GLdouble v_max,
+                GLuint u_div_point_count,
+                GLuint v_div_point_count,
+                GLenum usage_flag = GL_STATIC_DRAW);
     };
+
+    inline GLvoid ParametricSurface3::SetPartialDerivativeBatch(PartialDerivativeBatch batch)
+    {
+        _batch = batch;
+    }
+
+    inline ParametricSurface3::PartialDerivativeBatch ParametricSurface3::GetPartialDerivativeBatch() const
+    {
+        return _batch;
+    }
+
+    template <ParametricSurface3::Position position, GLuint order_u, GLuint order_v>
+    DCoordinate3 ParametricSurface3::AutomaticPartialDerivative(GLdouble u, GLdouble v)
+    {
+        static_assert(order_u + order_v <= 1, "only the zeroth and first order partial derivatives are supported");
+
+        Coordinate3<Dual> p = position(Dual::Variable(u, 0), Dual::Variable(v, 1));
+
+        if (order_u + order_v == 0)
+        {
+            return DCoordinate3(p[0].value(), p[1].value(), p[2].value());
+        }
+
+        GLuint variable = order_u ? 0 : 1;
+
+        return DCoordinate3(p[0].partial(variable), p[1].partial(variable), p[2].partial(variable));
+    }
+
+    template <ParametricSurface3::Position position>
+    GLvoid ParametricSurface3::AutomaticPartialDerivativeBatch(
+            GLuint count, const GLdouble *u, const GLdouble *v,
+            DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
+    {
+        for (GLuint k = 0; k < count; ++k)
+        {
+            Coordinate3<Dual> p = position(Dual::Variable(u[k], 0), Dual::Variable(v[k], 1));
+
+            for (GLuint i = 0; i < 3; ++i)
+            {
+                d00[k][i] = p[i].value();
+                d10[k][i] = p[i].partial(0);
+                d01[k][i] = p[i].partial(1);
+            }
+        }
+    }
+
+    template <class Evaluator>
+    TriangulatedMesh3* ParametricSurface3::GenerateImage(
+            const Evaluator &evaluate,
+            GLdouble u_min, GLdouble u_max,
+            GLdouble v_min, GLdouble v_max,
+            GLuint u_div_point_count,
+            GLuint v_div_point_count,
+            GLenum usage_flag)
+    {
+        if (u_div_point_count < 2 || v_div_point_count < 2)
+        {
+            return nullptr;
+        }
+
+        TriangulatedMesh3 *result = new (std::nothrow) TriangulatedMesh3(
+                u_div_point_count * v_div_point_count,                  // number of unique vertices
+                2 * (u_div_point_count - 1) * (v_div_point_count - 1),  // number of triangular faces
+                usage_flag);
+
+        if (!result)
+        {
+            return nullptr;
+        }
+
+        // distance between consecutive subdivision points
+        GLdouble du = (u_max - u_min) / (u_div_point_count - 1);
+        GLdouble dv = (v_max - v_min) / (v_div_point_count - 1);
+
+        // distance between consecutive subdivision points for texture coordinates
+        GLfloat ds = 1.0f / (u_div_point_count - 1);
+        GLfloat dt = 1.0f / (v_div_point_count - 1);
+
+        // the rows of the grid are distributed among the threads in contiguous blocks, each row writes only its
+        // own vertices and faces, thus the mesh does not depend on the number of threads
+        #pragma omp parallel if(u_div_point_count * v_div_point_count >= _parallel_threshold)
+        {
+            // parameters and partial derivatives with respect to v of the current row
+            std::vector<GLdouble>     u(v_div_point_count), v(v_div_point_count);
+            std::vector<GLfloat>      t(v_div_point_count);
+            std::vector<DCoordinate3> d01(v_div_point_count);
+
+            for (GLuint j = 0; j < v_div_point_count; ++j)
+            {
+                v[j] = std::min(v_min + j * dv, v_max);
+                t[j] = std::min(j * dt, 1.0f);
+            }
+
+            #pragma omp for schedule(static)
+            for (GLint row = 0; row < static_cast<GLint>(u_div_point_count); ++row)
+            {
+                GLuint i = static_cast<GLuint>(row);
+
+                std::fill(u.begin(), u.end(), std::min(u_min + i * du, u_max));
+
+                GLfloat s = std::min(i * ds, 1.0f);
+
+                // the points and the partial derivatives with respect to u are stored in place
+                GLuint first = i * v_div_point_count;
+
+                DCoordinate3 *vertex = &result->_vertex[first];
+                DCoordinate3 *normal = &result->_normal[first];
+
+                evaluate(v_div_point_count, &u[0], &v[0], vertex, normal, &d01[0]);
+
+                for (GLuint j = 0; j < v_div_point_count; ++j)
+                {
+                    // the surface normal is obtained as the cross product of the first order partial derivatives
+                    normal[j] ^= d01[j];
+                    normal[j].normalize();
+
+                    // texture coordinates
+                    result->_tex[first + j].s() = s;
+                    result->_tex[first + j].t() = t[j];
+                }
+
+                // connectivity information, the faces of the row follow the ones of the previous rows
+                if (i < u_div_point_count - 1)
+                {
+                    GLuint current_face = 2 * i * (v_div_point_count - 1);
+
+                    /*
+                        3-2
+                        |/|
+                        0-1
+                    */
+                    for (GLuint j = 0; j < v_div_point_count - 1; ++j)
+                    {
+                        GLuint index[4];
+
+                        index[0] = first + j;
+                        index[1] = index[0] + 1;
+                        index[2] = index[1] + v_div_point_count;
+                        index[3] = index[2] - 1;
+
+                        result->_face[current_face][0] = index[0];
+                        result->_face[current_face][1] = index[1];
+                        result->_face[current_face][2] = index[2];
+                        ++current_face;
+
+                        result->_face[current_face][0] = index[0];
+                        result->_face[current_face][1] = index[2];
+                        result->_face[current_face][2] = index[3];
+                        ++current_face;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
 }
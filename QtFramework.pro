@@ -51,6 +51,11 @@ unix: !mac {
 
     # for GLEW installed into /usr/lib/libGLEW.so or /usr/lib/glew.lib
     LIBS += -lGLEW -lGLU
+
+    # OpenMP is used by the numerical and tessellation kernels
+    # (without it the corresponding loops simply run on a single thread)
+    QMAKE_CXXFLAGS += -fopenmp
+    LIBS += -fopenmp
 }
 
 mac {
@@ -78,16 +83,28 @@ HEADERS += \
     Bezier/BicubicCompositeSurface3.h \
     Bezier/CubicBezierArcs3.h \
     Bezier/CubicCompositeCurve3.h \
+    Bezier/CubicForwardDifferences.h \
+    Core/AdaptiveCurveSamplers.h \
+    Core/ArcLengthTables.h \
+    Core/BoundingVolumeHierarchies.h \
+    Core/BlendingFunctionTableCaches.h \
+    Core/CollocationFactorizationCaches.h \
     Core/Colors4.h \
     Core/Constants.h \
+    Core/DCoordinate3Batches.h \
     Core/DCoordinates3.h \
+    Core/DiscreteFourierTransforms.h \
+    Core/DualNumbers.h \
     Core/GenericCurves3.h \
     Core/HCoordinates3.h \
+    Core/HomogeneousTransformations3.h \
     Core/Lights.h \
     Core/LinearCombination3.h \
+    Core/LRUCaches.h \
     Core/Materials.h \
     Core/Matrices.h \
     Core/RealSquareMatrices.h \
+    Core/RestrictedQuadtrees.h \
     Core/ShaderPrograms.h \
     Core/TCoordinates4.h \
     Core/TensorProductSurfaces3.h \
@@ -108,11 +125,20 @@ SOURCES += \
     Bezier/BicubicCompositeSurface3.cpp \
     Bezier/CubicBezierArcs3.cpp \
     Bezier/CubicCompositeCurve3.cpp \
+    Bezier/CubicForwardDifferences.cpp \
+    Core/AdaptiveCurveSamplers.cpp \
+    Core/ArcLengthTables.cpp \
+    Core/BoundingVolumeHierarchies.cpp \
+    Core/CollocationFactorizationCaches.cpp \
+    Core/DCoordinate3Batches.cpp \
+    Core/DiscreteFourierTransforms.cpp \
     Core/GenericCurves3.cpp \
+    Core/HomogeneousTransformations3.cpp \
     Core/Lights.cpp \
     Core/LinearCombination3.cpp \
     Core/Materials.cpp \
     Core/RealSquareMatrices.cpp \
+    Core/RestrictedQuadtrees.cpp \
     Core/ShaderPrograms.cpp \
     Core/TensorProductSurfaces3.cpp \
     Core/TriangulatedMeshes3.cpp \
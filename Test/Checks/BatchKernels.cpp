@@ -0,0 +1,144 @@
+#include "Checks.h"
+#include "../../Core/DCoordinate3Batches.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // results of every batch operation on the same operands, computed by the active instruction set
+    class BatchResults
+    {
+    public:
+        DCoordinate3Batch sum, scaled, axpy, weighted, cross, normalized;
+        vector<GLdouble>  dot;
+    };
+
+    GLvoid Evaluate(const DCoordinate3Batch& lhs, const DCoordinate3Batch& rhs, const vector<GLdouble>& coefficients,
+                    BatchResults& results)
+    {
+        results.sum = lhs;
+        results.sum.Add(rhs);
+
+        results.scaled = lhs;
+        results.scaled.Scale(-1.75);
+
+        results.axpy = lhs;
+        results.axpy.MultiplyAdd(0.625, rhs);
+
+        results.weighted = lhs;
+        results.weighted.MultiplyAdd(coefficients.data(), DCoordinate3(1.5, -2.0, 0.25));
+
+        results.cross.Cross(lhs, rhs);
+
+        results.dot.resize(lhs.GetSize());
+        lhs.Dot(rhs, results.dot.data());
+
+        // the operand contains null vectors, which have to be left unchanged
+        results.normalized = lhs;
+        results.normalized.Normalize();
+    }
+
+    // maximal relative difference of the points of two batches
+    GLdouble Difference(const DCoordinate3Batch& lhs, const DCoordinate3Batch& rhs)
+    {
+        GLdouble difference = 0.0;
+
+        for (GLuint i = 0; i < lhs.GetSize(); i++)
+        {
+            DCoordinate3 a = lhs[i], b = rhs[i];
+
+            for (GLuint k = 0; k < 3; k++)
+            {
+                difference = max(difference, abs(a[k] - b[k]) / max(1.0, abs(b[k])));
+            }
+        }
+
+        return difference;
+    }
+
+    GLdouble Difference(const BatchResults& lhs, const BatchResults& rhs)
+    {
+        GLdouble difference = max(max(Difference(lhs.sum, rhs.sum), Difference(lhs.scaled, rhs.scaled)),
+                                  max(Difference(lhs.axpy, rhs.axpy), Difference(lhs.weighted, rhs.weighted)));
+
+        difference = max(difference, max(Difference(lhs.cross, rhs.cross), Difference(lhs.normalized, rhs.normalized)));
+
+        for (GLuint i = 0; i < lhs.dot.size(); i++)
+        {
+            difference = max(difference, abs(lhs.dot[i] - rhs.dot[i]) / max(1.0, abs(rhs.dot[i])));
+        }
+
+        return difference;
+    }
+}
+
+// every instruction set of DCoordinate3Batch against the portable scalar kernels
+GLboolean cagd::CheckBatchKernels()
+{
+    static const char *names[3] = {"scalar", "sse2", "avx2"};
+
+    DCoordinate3Batch::InstructionSet original = DCoordinate3Batch::GetInstructionSet();
+    DCoordinate3Batch::InstructionSet widest = DCoordinate3Batch::DetectInstructionSet();
+
+    mt19937 generator(2024);
+    uniform_real_distribution<GLdouble> distribution(-10.0, 10.0);
+
+    GLboolean passed = GL_TRUE;
+
+    printf("widest supported instruction set: %s\n", names[widest]);
+
+    // the sizes cover empty batches as well as the remainders of the 2- and 4-wide loops
+    for (GLuint size = 0; size <= 37; size++)
+    {
+        DCoordinate3Batch lhs(size), rhs(size);
+        vector<GLdouble> coefficients(size);
+
+        for (GLuint i = 0; i < size; i++)
+        {
+            // every fifth point of the left operand is a null vector
+            if (i % 5 != 0)
+            {
+                lhs.Set(i, DCoordinate3(distribution(generator), distribution(generator), distribution(generator)));
+            }
+
+            rhs.Set(i, DCoordinate3(distribution(generator), distribution(generator), distribution(generator)));
+            coefficients[i] = distribution(generator);
+        }
+
+        BatchResults reference;
+
+        DCoordinate3Batch::SetInstructionSet(DCoordinate3Batch::SCALAR);
+        Evaluate(lhs, rhs, coefficients, reference);
+
+        for (GLuint set = DCoordinate3Batch::SSE2; set <= widest; set++)
+        {
+            BatchResults results;
+
+            DCoordinate3Batch::SetInstructionSet(static_cast<DCoordinate3Batch::InstructionSet>(set));
+            Evaluate(lhs, rhs, coefficients, results);
+
+            // fused multiply-adds may round differently from separate multiplications and additions
+            GLdouble difference = Difference(results, reference);
+
+            if (difference > 1.0e-14)
+            {
+                printf("%s differs from scalar by %.2e at size %u\n", names[set], difference, size);
+                passed = GL_FALSE;
+            }
+        }
+    }
+
+    for (GLuint set = DCoordinate3Batch::SSE2; set <= DCoordinate3Batch::AVX2; set++)
+    {
+        printf("%-6s %s\n", names[set], set <= widest ? "compared with scalar on sizes 0..37" : "not supported, skipped");
+    }
+
+    DCoordinate3Batch::SetInstructionSet(original);
+
+    return passed;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <chrono>
+
+namespace cagd
+{
+    //----------------------------------------------------------------------------------------------------------
+    // Every check prints its measurements to the standard output and returns GL_TRUE if the results it compares
+    // agree within their tolerances. Timings are printed for information only, they never make a check fail.
+    //----------------------------------------------------------------------------------------------------------
+
+    // blocked LU decomposition of RealSquareMatrix against the classical unblocked elimination, n = 8..2048
+    GLboolean CheckBlockedLUDecomposition();
+
+    // every instruction set of DCoordinate3Batch that the processor supports against the portable scalar kernels
+    GLboolean CheckBatchKernels();
+
+    // derivatives of cyclic curves from cached Fourier coefficients against the direct summation, n = 2..64
+    GLboolean CheckCyclicCurveDerivatives();
+
+    // images transformed together with the control nets of surfaces against new tessellations of the transformed
+    // surfaces, including reflections, which have to reverse the normals
+    GLboolean CheckMeshTransformations();
+
+    // mixed precision solutions of random, Hilbert and collocation matrices against the double precision solutions,
+    // the refinement statistics are validated, too
+    GLboolean CheckMixedPrecisionSolves();
+
+    // row-block parallel tessellation of surfaces from one thread up to the number of processors, the meshes have
+    // to be bitwise identical for every thread count
+    GLboolean CheckParallelTessellation();
+
+    // single precision preview images against the double precision images of Bezier and trigonometric surfaces
+    GLboolean CheckPreviewImages();
+
+    // hand-fused batches of the test surfaces against their partial derivatives by automatic differentiation
+    GLboolean CheckSurfaceBatches();
+
+    //------------
+    // class Timer
+    //------------
+    class Timer
+    {
+    private:
+        std::chrono::steady_clock::time_point _start;
+
+    public:
+        // the timer is started by the constructor
+        Timer();
+
+        GLvoid   Restart();
+        GLdouble ElapsedMilliseconds() const;
+    };
+
+    inline Timer::Timer(): _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    inline GLvoid Timer::Restart()
+    {
+        _start = std::chrono::steady_clock::now();
+    }
+
+    inline GLdouble Timer::ElapsedMilliseconds() const
+    {
+        return std::chrono::duration<GLdouble, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    }
+}
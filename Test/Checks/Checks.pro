@@ -0,0 +1,78 @@
+# Opt-in console program that runs the numerical checks and benchmarks of the core classes.
+# It is not part of QtFramework.pro, build it separately, e.g.,
+#
+#   qmake Test/Checks/Checks.pro && make && ./Checks [name ...]
+#
+# without arguments every check is run, the exit code is non-zero if one of them fails.
+
+TEMPLATE = app
+TARGET   = Checks
+
+QT      -= core gui
+CONFIG  += console c++11
+CONFIG  -= app_bundle
+
+QMAKE_CXXFLAGS += -std=gnu++14
+
+INCLUDEPATH += $$PWD/../.. $$PWD/../../Dependencies/Include
+DEPENDPATH  += $$PWD/../..
+
+win32 {
+    LIBS += -lopengl32
+
+    contains(QT_ARCH, i386) {
+        LIBS += -L"$$PWD/../../Dependencies/Lib/GL/x86/" -lglew32
+    } else {
+        LIBS += -L"$$PWD/../../Dependencies/Lib/GL/x64/" -lglew32
+    }
+
+    msvc {
+      QMAKE_CXXFLAGS += -openmp -arch:AVX -D "_CRT_SECURE_NO_WARNINGS"
+      QMAKE_CXXFLAGS_RELEASE *= -O2
+    }
+}
+
+unix: !mac {
+    LIBS += -lGLEW -lGL
+
+    QMAKE_CXXFLAGS += -fopenmp
+    LIBS += -fopenmp
+}
+
+mac {
+    LIBS += -lGLEW -framework OpenGL
+}
+
+HEADERS += \
+    Checks.h
+
+SOURCES += \
+    ../../Bezier/BicubicBezierPatches.cpp \
+    ../../Bezier/CubicBezierArcs3.cpp \
+    ../../Bezier/CubicForwardDifferences.cpp \
+    ../../Core/AdaptiveCurveSamplers.cpp \
+    ../../Core/ArcLengthTables.cpp \
+    ../../Core/CollocationFactorizationCaches.cpp \
+    ../../Core/DCoordinate3Batches.cpp \
+    ../../Core/DiscreteFourierTransforms.cpp \
+    ../../Core/GenericCurves3.cpp \
+    ../../Core/HomogeneousTransformations3.cpp \
+    ../../Core/LinearCombination3.cpp \
+    ../../Core/RealSquareMatrices.cpp \
+    ../../Core/RestrictedQuadtrees.cpp \
+    ../../Core/TensorProductSurfaces3.cpp \
+    ../../Core/TriangulatedMeshes3.cpp \
+    ../../Cyclic/CyclicCurves3.cpp \
+    ../../Parametric/ParametricCurves3.cpp \
+    ../../Parametric/ParametricSurfaces3.cpp \
+    ../TestFunctions.cpp \
+    ../../Trigonometric/TrigonometricBernsteinSurfaces.cpp \
+    BatchKernels.cpp \
+    CyclicCurveDerivatives.cpp \
+    LUDecompositions.cpp \
+    Main.cpp \
+    MeshTransformations.cpp \
+    MixedPrecisionSolves.cpp \
+    ParallelTessellation.cpp \
+    PreviewImages.cpp \
+    SurfaceBatches.cpp
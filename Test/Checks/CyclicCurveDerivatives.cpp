@@ -0,0 +1,143 @@
+#include "Checks.h"
+#include "../../Core/Constants.h"
+#include "../../Cyclic/CyclicCurves3.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // the direct summation of all blending function derivatives, i.e., the evaluator that the cached Fourier
+    // coefficients replaced; it costs O(n^2 * (max_order_of_derivatives + 1)) operations per point
+    GLvoid DirectDerivatives(GLuint n, const TriangularMatrix<GLdouble>& bc, const vector<DCoordinate3>& data,
+                             GLuint max_order_of_derivatives, GLdouble u, vector<DCoordinate3>& d)
+    {
+        GLdouble lambda = TWO_PI / (2 * n + 1);
+
+        d.assign(max_order_of_derivatives + 1, DCoordinate3());
+
+        DCoordinate3 centroid;
+        for (GLuint i = 0; i <= 2 * n; ++i)
+        {
+            centroid += data[i];
+        }
+        centroid /= (GLdouble)(2 * n + 1);
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+        {
+            for (GLuint i = 0; i <= 2 * n; ++i)
+            {
+                GLdouble sum_k = 0.0;
+
+                for (GLuint k = 0; k <= n - 1; ++k)
+                {
+                    sum_k += pow(n - k, (GLuint) r) * bc(2 * n, k) * cos((n - k) * (u - i * lambda) + r * PI / 2.0);
+                }
+                d[r] += sum_k * data[i];
+            }
+            d[r] *= 2.0;
+            d[r] /= (GLdouble)(2 * n + 1);
+            d[r] /= bc(2 * n, n);
+        }
+        d[0] += centroid;
+    }
+}
+
+// derivatives of cyclic curves evaluated from cached Fourier coefficients against the direct summation,
+// n = 2..64
+GLboolean cagd::CheckCyclicCurveDerivatives()
+{
+    const GLuint max_order_of_derivatives = 2, point_count = 200;
+
+    GLboolean passed = GL_TRUE;
+
+    printf("%4s %12s %12s %12s %9s %12s\n", "n", "direct us", "cached us", "batched us", "speedup", "max rel diff");
+
+    for (GLuint n = 2; n <= 64; n *= 2)
+    {
+        CyclicCurve3 curve(n);
+        vector<DCoordinate3> data(2 * n + 1);
+
+        for (GLuint i = 0; i <= 2 * n; i++)
+        {
+            curve[i] = data[i] = DCoordinate3(cos(1.3 * i), sin(0.7 * i), 0.1 * i);
+        }
+
+        TriangularMatrix<GLdouble> bc(2 * n + 1);
+        bc(0, 0) = 1.0;
+        for (GLuint r = 1; r <= 2 * n; r++)
+        {
+            bc(r, 0) = bc(r, r) = 1.0;
+            for (GLuint i = 1; i < r; i++)
+            {
+                bc(r, i) = bc(r - 1, i - 1) + bc(r - 1, i);
+            }
+        }
+
+        ColumnMatrix<GLdouble> parameters(point_count);
+        for (GLuint k = 0; k < point_count; k++)
+        {
+            parameters(k) = k * TWO_PI / point_count;
+        }
+
+        // the direct summation is slow for large orders, thus it is repeated less
+        GLuint direct_repetition_count = n <= 16 ? 20 : 2, repetition_count = 50 * direct_repetition_count;
+
+        vector<DCoordinate3> reference;
+        GLdouble difference = 0.0, scale = 0.0;
+
+        Timer timer;
+        for (GLuint r = 0; r < direct_repetition_count; r++)
+        {
+            for (GLuint k = 0; k < point_count; k++)
+            {
+                DirectDerivatives(n, bc, data, max_order_of_derivatives, parameters(k), reference);
+            }
+        }
+        GLdouble direct_time = timer.ElapsedMilliseconds() * 1000.0 / (direct_repetition_count * point_count);
+
+        LinearCombination3::Derivatives d;
+
+        timer.Restart();
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            for (GLuint k = 0; k < point_count; k++)
+            {
+                curve.CalculateDerivatives(max_order_of_derivatives, parameters(k), d);
+            }
+        }
+        GLdouble cached_time = timer.ElapsedMilliseconds() * 1000.0 / (repetition_count * point_count);
+
+        Matrix<DCoordinate3> sweep;
+
+        timer.Restart();
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            curve.EvaluateMany(parameters, max_order_of_derivatives, sweep);
+        }
+        GLdouble batched_time = timer.ElapsedMilliseconds() * 1000.0 / (repetition_count * point_count);
+
+        for (GLuint k = 0; k < point_count; k++)
+        {
+            DirectDerivatives(n, bc, data, max_order_of_derivatives, parameters(k), reference);
+            curve.CalculateDerivatives(max_order_of_derivatives, parameters(k), d);
+
+            for (GLuint r = 0; r <= max_order_of_derivatives; r++)
+            {
+                difference = max(difference, max((d[r] - reference[r]).length(), (sweep(r, k) - reference[r]).length()));
+                scale = max(scale, reference[r].length());
+            }
+        }
+
+        difference /= scale;
+        passed = passed && difference <= 1.0e-12;
+
+        printf("%4u %12.3f %12.3f %12.3f %8.0fx %12.2e\n",
+               n, direct_time, cached_time, batched_time, direct_time / cached_time, difference);
+    }
+
+    return passed;
+}
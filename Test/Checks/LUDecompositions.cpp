@@ -0,0 +1,141 @@
+#include "Checks.h"
+#include "../../Core/RealSquareMatrices.h"
+
+#include <cstdio>
+#include <random>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // the classical unblocked elimination with scaled partial pivoting, i.e., the loop that the blocked
+    // decomposition replaced; it returns the row-major factors
+    GLboolean UnblockedLUDecomposition(GLuint size, vector<GLdouble>& a)
+    {
+        const GLdouble tiny = numeric_limits<GLdouble>::min();
+
+        vector<GLdouble> implicit_scaling_of_each_row(size);
+
+        for (GLuint i = 0; i < size; ++i)
+        {
+            GLdouble big = 0.0;
+            for (GLuint j = 0; j < size; ++j)
+                big = max(big, abs(a[i * size + j]));
+
+            if (big == 0.0)
+                return GL_FALSE;
+
+            implicit_scaling_of_each_row[i] = 1.0 / big;
+        }
+
+        for (GLuint k = 0; k < size; ++k)
+        {
+            GLuint imax = k;
+            GLdouble big = 0.0;
+            for (GLuint i = k; i < size; ++i)
+            {
+                GLdouble temp = implicit_scaling_of_each_row[i] * abs(a[i * size + k]);
+                if (temp > big)
+                {
+                    big = temp;
+                    imax = i;
+                }
+            }
+
+            if (k != imax)
+            {
+                swap_ranges(a.begin() + k * size, a.begin() + (k + 1) * size, a.begin() + imax * size);
+                implicit_scaling_of_each_row[imax] = implicit_scaling_of_each_row[k];
+            }
+
+            if (a[k * size + k] == 0.0)
+                a[k * size + k] = tiny;
+
+            for (GLuint i = k + 1; i < size; ++i)
+            {
+                GLdouble temp = a[i * size + k] /= a[k * size + k];
+
+                for (GLuint j = k + 1; j < size; ++j)
+                    a[i * size + j] -= temp * a[k * size + j];
+            }
+        }
+
+        return GL_TRUE;
+    }
+}
+
+// blocked LU decomposition of RealSquareMatrix against the classical unblocked elimination; matrices that fit into a
+// single panel (n <= 64) are factored by the same unblocked loop, so their speedup is expected to be about 1
+GLboolean cagd::CheckBlockedLUDecomposition()
+{
+    mt19937 generator(2024);
+    uniform_real_distribution<GLdouble> distribution(-1.0, 1.0);
+
+    GLboolean passed = GL_TRUE;
+
+    printf("%6s %12s %12s %9s %14s\n", "n", "unblocked ms", "blocked ms", "speedup", "max factor diff");
+
+    for (GLuint size = 8; size <= 2048; size *= 2)
+    {
+        vector<GLdouble> elements(size * size);
+
+        for (GLuint i = 0; i < elements.size(); i++)
+        {
+            elements[i] = distribution(generator);
+        }
+
+        // small matrices are factored repeatedly, so that the timings are not dominated by the clock resolution
+        GLuint repetition_count = size < 256 ? (1u << 24) / (size * size * size) : 1;
+
+        vector<GLdouble> reference;
+        Timer timer;
+
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            reference = elements;
+
+            if (!UnblockedLUDecomposition(size, reference))
+            {
+                return GL_FALSE;
+            }
+        }
+
+        GLdouble unblocked_time = timer.ElapsedMilliseconds() / repetition_count;
+
+        RealSquareMatrix A(size);
+        GLdouble blocked_time = 0.0;
+
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            A = RealSquareMatrix(size);
+            copy(elements.begin(), elements.end(), A.data());
+
+            timer.Restart();
+
+            if (!A.PerformLUDecomposition())
+            {
+                return GL_FALSE;
+            }
+
+            blocked_time += timer.ElapsedMilliseconds();
+        }
+
+        blocked_time /= repetition_count;
+
+        // the blocked elimination performs the same operations in a different order
+        GLdouble difference = 0.0;
+
+        for (GLuint i = 0; i < elements.size(); i++)
+        {
+            difference = max(difference, abs(A.data()[i] - reference[i]) / max(1.0, abs(reference[i])));
+        }
+
+        passed = passed && difference <= 1.0e-10;
+
+        printf("%6u %12.4f %12.4f %9.2f %14.2e\n",
+               size, unblocked_time, blocked_time, unblocked_time / blocked_time, difference);
+    }
+
+    return passed;
+}
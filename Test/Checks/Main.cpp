@@ -0,0 +1,90 @@
+#include "Checks.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    class Check
+    {
+    public:
+        const char *name;
+        GLboolean  (*run)();
+    };
+
+    const Check checks[] =
+    {
+        {"lu",      CheckBlockedLUDecomposition},
+        {"batch",   CheckBatchKernels},
+        {"cyclic",  CheckCyclicCurveDerivatives},
+        {"mixed",   CheckMixedPrecisionSolves},
+        {"transform", CheckMeshTransformations},
+        {"parallel", CheckParallelTessellation},
+        {"preview", CheckPreviewImages},
+        {"surfaces", CheckSurfaceBatches}
+    };
+
+    const GLuint check_count = sizeof(checks) / sizeof(checks[0]);
+}
+
+// runs the checks named by the arguments, or all of them if there are no arguments
+int main(int argc, char **argv)
+{
+    // unknown names are reported, so that typos do not pass silently
+    for (int k = 1; k < argc; k++)
+    {
+        GLboolean known = GL_FALSE;
+
+        for (GLuint i = 0; i < check_count && !known; i++)
+        {
+            known = (strcmp(argv[k], checks[i].name) == 0);
+        }
+
+        if (!known)
+        {
+            cerr << "unknown check: " << argv[k] << endl << "available checks:";
+
+            for (GLuint i = 0; i < check_count; i++)
+            {
+                cerr << " " << checks[i].name;
+            }
+
+            cerr << endl;
+
+            return 2;
+        }
+    }
+
+    GLuint failure_count = 0;
+
+    for (GLuint i = 0; i < check_count; i++)
+    {
+        GLboolean selected = (argc < 2);
+
+        for (int k = 1; k < argc && !selected; k++)
+        {
+            selected = (strcmp(argv[k], checks[i].name) == 0);
+        }
+
+        if (!selected)
+        {
+            continue;
+        }
+
+        cout << "--- " << checks[i].name << endl;
+
+        GLboolean passed = checks[i].run();
+
+        cout << "--- " << checks[i].name << (passed ? ": passed" : ": FAILED") << endl << endl;
+
+        if (!passed)
+        {
+            failure_count++;
+        }
+    }
+
+    return failure_count > 0 ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+#include "Checks.h"
+#include "../../Bezier/BicubicBezierPatches.h"
+#include "../../Core/Constants.h"
+#include "../../Core/HomogeneousTransformations3.h"
+#include "../../Trigonometric/TrigonometricBernsteinSurfaces.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    const GLuint div_point_count = 200;
+
+    // the same control net of size data_count x data_count is generated for every transformation
+    GLvoid LoadData(TensorProductSurface3& surface, GLuint data_count)
+    {
+        for (GLuint i = 0; i < data_count; i++)
+        {
+            for (GLuint j = 0; j < data_count; j++)
+            {
+                surface.SetData(i, j, i + 0.2 * sin(1.7 * j), j + 0.2 * cos(2.3 * i), sin(0.9 * i + 1.3 * j));
+            }
+        }
+    }
+
+    // An image generated before the transformation of the control net and transformed together with it (like the
+    // cached images of composite patches) against a new tessellation of the transformed surface. Surfaces are
+    // affine invariant, thus the vertices have to agree up to rounding errors, and so do the unit normals, which
+    // also have to keep their orientation relative to the new tessellation, even if the transformation is a
+    // reflection.
+    GLboolean CheckTransformation(const char *surface_name, TensorProductSurface3& surface, GLuint data_count,
+                                  const char *transformation_name, const HomogeneousTransformation3& transformation)
+    {
+        LoadData(surface, data_count);
+
+        TriangulatedMesh3 *image = surface.GenerateImage(div_point_count, div_point_count);
+
+        if (!image)
+        {
+            printf("%-13s %-12s: could not generate the image\n", surface_name, transformation_name);
+            return GL_FALSE;
+        }
+
+        Timer timer;
+        GLboolean transformed = image->Transform(transformation) && surface.TransformData(transformation);
+        GLdouble transformation_time = timer.ElapsedMilliseconds();
+
+        timer.Restart();
+        TriangulatedMesh3 *reference = surface.GenerateImage(div_point_count, div_point_count);
+        GLdouble tessellation_time = timer.ElapsedMilliseconds();
+
+        GLboolean passed = transformed && reference &&
+                           image->VertexCount() == reference->VertexCount() &&
+                           image->FaceCount() == reference->FaceCount();
+
+        GLdouble vertex_difference = 0.0, normal_difference = 0.0, scale = 1.0;
+
+        for (GLuint i = 0; passed && i < image->VertexCount(); i++)
+        {
+            DCoordinate3 a, b;
+
+            image->GetVertex(i, a);
+            reference->GetVertex(i, b);
+
+            vertex_difference = max(vertex_difference, (a - b).length());
+            scale = max(scale, b.length());
+
+            image->GetNormal(i, a);
+            reference->GetNormal(i, b);
+
+            normal_difference = max(normal_difference, (a - b).length());
+        }
+
+        vertex_difference /= scale;
+
+        passed = passed && vertex_difference <= 1.0e-12 && normal_difference <= 1.0e-9;
+
+        printf("%-13s %-12s %11.2e %11.2e %12.3f %12.3f%s\n", surface_name, transformation_name,
+               vertex_difference, normal_difference, transformation_time, tessellation_time,
+               passed ? "" : "  <- differs from the new tessellation");
+
+        delete reference;
+        delete image;
+
+        return passed;
+    }
+}
+
+// images transformed together with the control nets of Bezier and trigonometric surfaces against new tessellations
+// of the transformed surfaces, including reflections
+GLboolean cagd::CheckMeshTransformations()
+{
+    const GLuint transformation_count = 6;
+
+    const char *names[transformation_count] =
+    {
+        "translation", "rotation", "scaling", "mirror x", "mirror+rot", "point mirror"
+    };
+
+    HomogeneousTransformation3 transformations[transformation_count] =
+    {
+        HomogeneousTransformation3::Translation(0.5, -1.0, 2.0),
+        HomogeneousTransformation3::Rotation(DCoordinate3(1.0, 2.0, 3.0), 0.7),
+        HomogeneousTransformation3::Scaling(2.0, 0.5, 3.0),
+        HomogeneousTransformation3::Scaling(-1.0, 1.0, 1.0),
+        HomogeneousTransformation3::Rotation(DCoordinate3(0.0, 1.0, 1.0), 1.1) *
+        HomogeneousTransformation3::Scaling(1.0, -2.0, 1.0),
+        HomogeneousTransformation3::Scaling(-1.0, -1.0, -1.0)
+    };
+
+    printf("%-13s %-12s %11s %11s %12s %12s\n", "surface", "transform", "vertex diff", "normal diff",
+           "transform ms", "new mesh ms");
+
+    GLboolean passed = GL_TRUE;
+
+    BicubicBezierPatch patch;
+    TrigonometricBernsteinSurface3 trigonometric(PI / 2.0, 2, PI / 2.0, 2);
+
+    for (GLuint t = 0; t < transformation_count; t++)
+    {
+        passed &= CheckTransformation("bezier", patch, 4, names[t], transformations[t]);
+        passed &= CheckTransformation("trigonometric", trigonometric, 5, names[t], transformations[t]);
+    }
+
+    return passed;
+}
@@ -0,0 +1,247 @@
+#include "Checks.h"
+#include "../../Core/Constants.h"
+#include "../../Core/RealSquareMatrices.h"
+#include "../../Cyclic/CyclicCurves3.h"
+#include "../../Trigonometric/TrigonometricBernsteinSurfaces.h"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    const GLuint rhs_count = 4;
+
+    // expected outcome of a mixed precision solution
+    enum Outcome {CONVERGENCE, FALLBACK, EITHER};
+
+    // ||A||_1 * ||A^{-1}||_1, where the inverse is obtained by a double precision solution
+    GLdouble ConditionNumber(const RealSquareMatrix& A)
+    {
+        GLuint size = A.GetRowCount();
+
+        RealSquareMatrix LU(A);
+        Matrix<GLdouble> identity(size, size), inverse;
+        for (GLuint i = 0; i < size; i++)
+        {
+            identity(i, i) = 1.0;
+        }
+
+        if (!LU.SolveLinearSystem(identity, inverse))
+        {
+            return numeric_limits<GLdouble>::infinity();
+        }
+
+        GLdouble norm = 0.0, norm_of_inverse = 0.0;
+        for (GLuint j = 0; j < size; j++)
+        {
+            GLdouble column_sum = 0.0, inverse_column_sum = 0.0;
+            for (GLuint i = 0; i < size; i++)
+            {
+                column_sum += abs(A(i, j));
+                inverse_column_sum += abs(inverse(i, j));
+            }
+            norm = max(norm, column_sum);
+            norm_of_inverse = max(norm_of_inverse, inverse_column_sum);
+        }
+
+        return norm * norm_of_inverse;
+    }
+
+    // Solves A x = b both in double and in mixed precision. If the refinement converges, the solutions have to
+    // agree within the forward error bound cond(A) * eps of the double precision solution, the refinement has to
+    // perform at least one correction (single precision factors alone cannot reach the stopping criterion) and
+    // Hager's estimate has to be a lower bound of the condition number that is rarely smaller than a tenth of it.
+    // If the refinement falls back to the double precision decomposition, the solutions have to be identical, and
+    // an expected fallback has to be caused by an estimate that reaches 1 / eps_single. (The estimate of a nearly
+    // singular matrix is calculated by inaccurate single precision factors, thus it is not compared then.)
+    // If exact_condition_number is false, the estimate is not compared, since the inverse would be too expensive.
+    GLboolean CheckSolve(const char *name, const RealSquareMatrix& A, const Matrix<DCoordinate3>& b,
+                         Outcome expected_outcome, GLboolean exact_condition_number)
+    {
+        GLuint size = A.GetRowCount();
+
+        Timer timer;
+        RealSquareMatrix D(A);
+        Matrix<DCoordinate3> reference;
+        if (!D.SolveLinearSystem(b, reference))
+        {
+            printf("%-13s %5u: the double precision solution failed\n", name, size);
+            return GL_FALSE;
+        }
+        GLdouble double_time = timer.ElapsedMilliseconds();
+
+        timer.Restart();
+        RealSquareMatrix M(A);
+        Matrix<DCoordinate3> x;
+        if (!M.SetPrecisionMode(RealSquareMatrix::MIXED_PRECISION) || !M.SolveLinearSystem(b, x))
+        {
+            printf("%-13s %5u: the mixed precision solution failed\n", name, size);
+            return GL_FALSE;
+        }
+        GLdouble mixed_time = timer.ElapsedMilliseconds();
+
+        const RealSquareMatrix::RefinementStatistics &statistics = M.GetRefinementStatistics();
+
+        GLdouble difference = 0.0, norm_of_reference = 0.0;
+        for (GLuint i = 0; i < size; i++)
+        {
+            for (GLuint k = 0; k < rhs_count; k++)
+            {
+                for (GLuint c = 0; c < 3; c++)
+                {
+                    difference = max(difference, abs(x(i, k)[c] - reference(i, k)[c]));
+                    norm_of_reference = max(norm_of_reference, abs(reference(i, k)[c]));
+                }
+            }
+        }
+        difference /= norm_of_reference;
+
+        GLdouble condition_number = exact_condition_number ? ConditionNumber(A) : 0.0;
+
+        GLboolean passed = (expected_outcome == EITHER ||
+                            (expected_outcome == CONVERGENCE) == (statistics.converged == GL_TRUE));
+
+        if (statistics.converged)
+        {
+            passed = passed && statistics.refinement_step_count >= 1 && statistics.refinement_step_count <= 30;
+            passed = passed && statistics.relative_residual <= sqrt(GLdouble(size)) * numeric_limits<GLdouble>::epsilon();
+            passed = passed && difference <= 10.0 * statistics.condition_number_estimate * numeric_limits<GLdouble>::epsilon();
+        }
+        else
+        {
+            passed = passed && difference == 0.0;
+        }
+
+        if (expected_outcome == FALLBACK)
+        {
+            passed = passed && statistics.condition_number_estimate * numeric_limits<GLfloat>::epsilon() >= 1.0;
+        }
+
+        if (statistics.converged && exact_condition_number)
+        {
+            passed = passed && statistics.condition_number_estimate <= 1.01 * condition_number &&
+                               statistics.condition_number_estimate >= 0.1 * condition_number;
+        }
+
+        char exact[16] = "-";
+        if (exact_condition_number)
+        {
+            snprintf(exact, sizeof(exact), "%.2e", condition_number);
+        }
+
+        printf("%-13s %5u %10.2e %10s %5u %9s %10.2e %10.2e %10.3f %10.3f%s\n", name, size,
+               statistics.condition_number_estimate, exact, statistics.refinement_step_count,
+               statistics.converged ? "yes" : "fallback", statistics.relative_residual, difference,
+               double_time, mixed_time, passed ? "" : "  <- unexpected");
+
+        return passed;
+    }
+
+    GLvoid RandomRightHandSides(GLuint size, mt19937& generator, Matrix<DCoordinate3>& b)
+    {
+        uniform_real_distribution<GLdouble> distribution(-1.0, 1.0);
+
+        b.ResizeRows(size);
+        b.ResizeColumns(rhs_count);
+
+        for (GLuint i = 0; i < size; i++)
+        {
+            for (GLuint k = 0; k < rhs_count; k++)
+            {
+                b(i, k) = DCoordinate3(distribution(generator), distribution(generator), distribution(generator));
+            }
+        }
+    }
+}
+
+// mixed precision solutions of random, Hilbert and collocation matrices against the double precision solutions
+GLboolean cagd::CheckMixedPrecisionSolves()
+{
+    mt19937 generator(2025);
+    uniform_real_distribution<GLdouble> distribution(-1.0, 1.0);
+
+    GLboolean passed = GL_TRUE;
+
+    printf("%-13s %5s %10s %10s %5s %9s %10s %10s %10s %10s\n", "matrix", "n", "cond est", "cond", "steps",
+           "converged", "residual", "max diff", "double ms", "mixed ms");
+
+    Matrix<DCoordinate3> b;
+
+    // well-conditioned dense matrices, the refinement has to converge
+    for (GLuint size = 64; size <= 1024; size *= 4)
+    {
+        RealSquareMatrix A(size);
+        for (GLuint i = 0; i < size; i++)
+        {
+            for (GLuint j = 0; j < size; j++)
+            {
+                A(i, j) = distribution(generator);
+            }
+        }
+
+        RandomRightHandSides(size, generator, b);
+        passed &= CheckSolve("random", A, b, CONVERGENCE, size <= 256);
+    }
+
+    // cond(H_n) * eps_single >= 1 if n >= 6, thus the double precision fallback has to be taken
+    for (GLuint size = 6; size <= 12; size += 2)
+    {
+        RealSquareMatrix H(size);
+        for (GLuint i = 0; i < size; i++)
+        {
+            for (GLuint j = 0; j < size; j++)
+            {
+                H(i, j) = 1.0 / (i + j + 1);
+            }
+        }
+
+        RandomRightHandSides(size, generator, b);
+        passed &= CheckSolve("hilbert", H, b, FALLBACK, GL_TRUE);
+    }
+
+    // collocation matrices of cyclic curves at perturbed uniform knots and of trigonometric surfaces at uniform
+    // knots; their outcome is not prescribed, they are reported since they decide whether the interpolation
+    // methods should use the mixed precision mode: the sizes that are well-conditioned enough for the refinement
+    // are too small to profit from single precision factors, while the larger ones always take the fallback
+    RowMatrix<GLdouble> values;
+
+    for (GLuint n = 2; n <= 128; n *= 4)
+    {
+        CyclicCurve3 curve(n);
+        GLuint size = 2 * n + 1;
+
+        RealSquareMatrix A(size);
+        for (GLuint r = 0; r < size; r++)
+        {
+            curve.BlendingFunctionValues((r + 0.25 * distribution(generator)) * TWO_PI / size, values);
+            A.SetRow(r, values);
+        }
+
+        RandomRightHandSides(size, generator, b);
+        passed &= CheckSolve("cyclic", A, b, EITHER, GL_TRUE);
+    }
+
+    for (GLuint n = 2; n <= 32; n *= 2)
+    {
+        GLdouble alpha = PI / 2.0;
+        TrigonometricBernsteinSurface3 surface(alpha, n, alpha, n);
+        GLuint size = 2 * n + 1;
+
+        RealSquareMatrix A(size);
+        for (GLuint r = 0; r < size; r++)
+        {
+            surface.UBlendingFunctionValues(r * alpha / (size - 1), values);
+            A.SetRow(r, values);
+        }
+
+        RandomRightHandSides(size, generator, b);
+        passed &= CheckSolve("trigonometric", A, b, EITHER, GL_TRUE);
+    }
+
+    return passed;
+}
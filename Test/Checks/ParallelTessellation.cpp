@@ -0,0 +1,151 @@
+#include "Checks.h"
+#include "../TestFunctions.h"
+#include "../../Parametric/ParametricSurfaces3.h"
+#include "../../Trigonometric/TrigonometricBernsteinSurfaces.h"
+
+#include <cstdio>
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // the rows of the grid are distributed among the threads, but every vertex is computed by the same
+    // operations, thus the meshes have to be bitwise identical for any number of threads
+    GLboolean AreIdentical(TriangulatedMesh3& lhs, TriangulatedMesh3& rhs)
+    {
+        if (lhs.VertexCount() != rhs.VertexCount() || lhs.FaceCount() != rhs.FaceCount())
+            return GL_FALSE;
+
+        for (GLuint i = 0; i < lhs.VertexCount(); i++)
+        {
+            DCoordinate3 a, b;
+
+            lhs.GetVertex(i, a);
+            rhs.GetVertex(i, b);
+
+            if (a[0] != b[0] || a[1] != b[1] || a[2] != b[2])
+                return GL_FALSE;
+
+            lhs.GetNormal(i, a);
+            rhs.GetNormal(i, b);
+
+            if (a[0] != b[0] || a[1] != b[1] || a[2] != b[2])
+                return GL_FALSE;
+        }
+
+        return GL_TRUE;
+    }
+
+    GLvoid SetThreadCount(GLuint thread_count)
+    {
+    #ifdef _OPENMP
+        omp_set_num_threads(thread_count);
+    #else
+        (void)thread_count;
+    #endif
+    }
+
+    // generates the image of a trigonometric surface, or of the torus if surface is null
+    TriangulatedMesh3* GenerateImage(const TrigonometricBernsteinSurface3 *surface, GLuint div_point_count)
+    {
+        if (surface)
+            return surface->GenerateImage(div_point_count, div_point_count);
+
+        return ParametricSurface3::GenerateImage(torus::batch, torus::u_min, torus::u_max, torus::v_min, torus::v_max,
+                                                 div_point_count, div_point_count);
+    }
+
+    GLboolean CheckSurface(const char *name, const TrigonometricBernsteinSurface3 *surface, GLuint div_point_count,
+                           GLuint processor_count)
+    {
+        GLuint repetition_count = max(1u, 1000000u / (div_point_count * div_point_count));
+
+        SetThreadCount(1);
+        TriangulatedMesh3 *reference = GenerateImage(surface, div_point_count);
+
+        if (!reference)
+        {
+            printf("%-13s %4u: could not generate the image\n", name, div_point_count);
+            return GL_FALSE;
+        }
+
+        GLboolean passed = GL_TRUE;
+        GLdouble  serial_time = 0.0;
+
+        for (GLuint thread_count = 1; thread_count <= processor_count; thread_count++)
+        {
+            SetThreadCount(thread_count);
+
+            TriangulatedMesh3 *image = nullptr;
+            Timer timer;
+            for (GLuint r = 0; r < repetition_count; r++)
+            {
+                delete image;
+                image = GenerateImage(surface, div_point_count);
+            }
+            GLdouble time = timer.ElapsedMilliseconds() / repetition_count;
+
+            if (thread_count == 1)
+                serial_time = time;
+
+            GLboolean identical = image && AreIdentical(*reference, *image);
+            passed = passed && identical;
+
+            printf("%-13s %4u %7u %12.3f %8.2fx %9.0f%%%s\n", name, div_point_count, thread_count, time,
+                   serial_time / time, 100.0 * serial_time / (time * thread_count),
+                   identical ? "" : "  <- mesh differs");
+
+            delete image;
+        }
+
+        delete reference;
+
+        return passed;
+    }
+}
+
+// scaling of the row-block parallel tessellation of a trigonometric surface and of the torus from one thread up to
+// the number of processors
+GLboolean cagd::CheckParallelTessellation()
+{
+    GLuint processor_count = 1, default_thread_count = 1;
+
+#ifdef _OPENMP
+    processor_count = static_cast<GLuint>(omp_get_num_procs());
+    default_thread_count = static_cast<GLuint>(omp_get_max_threads());
+#else
+    printf("compiled without OpenMP, only the serial tessellation is measured\n");
+#endif
+
+    mt19937 generator(7);
+    uniform_real_distribution<GLdouble> perturbation(-0.5, 0.5);
+
+    TrigonometricBernsteinSurface3 trigonometric(1.5, 3, 1.5, 3);
+    for (GLuint i = 0; i < 7; i++)
+    {
+        for (GLuint j = 0; j < 7; j++)
+        {
+            trigonometric.SetData(i, j, i + 0.1 * perturbation(generator), j + 0.1 * perturbation(generator),
+                                  perturbation(generator));
+        }
+    }
+
+    printf("%-13s %4s %7s %12s %9s %10s\n", "surface", "grid", "threads", "time [ms]", "speedup", "efficiency");
+
+    GLboolean passed = GL_TRUE;
+    for (GLuint div_point_count = 200; div_point_count <= 800; div_point_count *= 2)
+    {
+        passed &= CheckSurface("trigonometric", &trigonometric, div_point_count, processor_count);
+        passed &= CheckSurface("torus", nullptr, div_point_count, processor_count);
+    }
+
+    SetThreadCount(default_thread_count);
+
+    return passed;
+}
@@ -0,0 +1,144 @@
+#include "Checks.h"
+#include "../../Bezier/BicubicBezierPatches.h"
+#include "../../Trigonometric/TrigonometricBernsteinSurfaces.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    // the single precision preview may differ from the double precision image by the rounding errors of floats,
+    // the vertices are compared relative to the diagonal of the bounding box of the image, and the unit
+    // normal vectors absolutely
+    const GLdouble maximum_vertex_error = 1.0e-6;
+    const GLdouble maximum_normal_error = 1.0e-5;
+
+    GLboolean CheckSurface(const char *name, const TensorProductSurface3& surface, GLuint div_point_count)
+    {
+        GLuint repetition_count = max(1u, 250000u / (div_point_count * div_point_count));
+        Timer  timer;
+
+        TriangulatedMesh3 *image = nullptr;
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            delete image;
+            image = surface.GenerateImage(div_point_count, div_point_count);
+        }
+        GLdouble image_time = timer.ElapsedMilliseconds() / repetition_count;
+
+        timer.Restart();
+        TriangulatedMesh3 *preview = nullptr;
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            delete preview;
+            preview = surface.GeneratePreviewImage(div_point_count, div_point_count);
+        }
+        GLdouble preview_time = timer.ElapsedMilliseconds() / repetition_count;
+
+        // while a control point is dragged, its moves are applied to the image by rank-one updates, the inner
+        // control point changes every vertex, thus this is the most expensive one
+        TensorProductSurface3::ImagePartialDerivatives partials;
+        TriangulatedMesh3 *updated = surface.GenerateImageWithPartialDerivatives(div_point_count, div_point_count, partials);
+
+        timer.Restart();
+        for (GLuint r = 0; updated && r < repetition_count; r++)
+        {
+            GLuint first_vertex, vertex_count;
+            surface.UpdateImageForDataChange(1, 1, DCoordinate3(0.0, 0.0, (r % 2) ? -0.01 : 0.01), *updated, partials,
+                                             first_vertex, vertex_count);
+        }
+        GLdouble update_time = timer.ElapsedMilliseconds() / repetition_count;
+
+        delete updated;
+
+        if (!image || !preview || image->VertexCount() != preview->VertexCount())
+        {
+            printf("%-13s %4u: could not generate the images\n", name, div_point_count);
+            delete image;
+            delete preview;
+            return GL_FALSE;
+        }
+
+        DCoordinate3 minimum(HUGE_VAL, HUGE_VAL, HUGE_VAL), maximum(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+        for (GLuint i = 0; i < image->VertexCount(); i++)
+        {
+            DCoordinate3 vertex;
+            image->GetVertex(i, vertex);
+
+            for (GLuint k = 0; k < 3; k++)
+            {
+                minimum[k] = min(minimum[k], vertex[k]);
+                maximum[k] = max(maximum[k], vertex[k]);
+            }
+        }
+        GLdouble diagonal = (maximum - minimum).length();
+
+        GLdouble vertex_error = 0.0, normal_error = 0.0;
+        for (GLuint i = 0; i < image->VertexCount(); i++)
+        {
+            DCoordinate3 a, b;
+
+            image->GetVertex(i, a);
+            preview->GetVertex(i, b);
+            vertex_error = max(vertex_error, (a - b).length() / diagonal);
+
+            image->GetNormal(i, a);
+            preview->GetNormal(i, b);
+            normal_error = max(normal_error, (a - b).length());
+        }
+
+        delete image;
+        delete preview;
+
+        GLboolean passed = vertex_error <= maximum_vertex_error && normal_error <= maximum_normal_error;
+
+        printf("%-13s %4u %12.4f %12.4f %12.4f %8.2fx %12.2e %12.2e%s\n", name, div_point_count, image_time,
+               preview_time, update_time, image_time / preview_time, vertex_error, normal_error,
+               passed ? "" : "  <- too large");
+
+        return passed;
+    }
+}
+
+// single precision previews against the double precision images of Bezier and trigonometric surfaces
+GLboolean cagd::CheckPreviewImages()
+{
+    mt19937 generator(5);
+    uniform_real_distribution<GLdouble> perturbation(-0.5, 0.5);
+
+    BicubicBezierPatch bezier;
+    for (GLuint i = 0; i < 4; i++)
+    {
+        for (GLuint j = 0; j < 4; j++)
+        {
+            bezier.SetData(i, j, 10.0 * i + perturbation(generator), 10.0 * j + perturbation(generator),
+                           5.0 * perturbation(generator));
+        }
+    }
+
+    TrigonometricBernsteinSurface3 trigonometric(1.5, 3, 1.5, 3);
+    for (GLuint i = 0; i < 7; i++)
+    {
+        for (GLuint j = 0; j < 7; j++)
+        {
+            trigonometric.SetData(i, j, i + 0.1 * perturbation(generator), j + 0.1 * perturbation(generator),
+                                  perturbation(generator));
+        }
+    }
+
+    printf("%-13s %4s %12s %12s %12s %9s %12s %12s\n", "surface", "grid", "double [ms]", "float [ms]", "update [ms]",
+           "speedup", "vertex err", "normal err");
+
+    GLboolean passed = GL_TRUE;
+    for (GLuint div_point_count = 10; div_point_count <= 640; div_point_count *= 4)
+    {
+        passed &= CheckSurface("bezier", bezier, div_point_count);
+        passed &= CheckSurface("trigonometric", trigonometric, div_point_count);
+    }
+
+    return passed;
+}
@@ -0,0 +1,109 @@
+#include "Checks.h"
+#include "../TestFunctions.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace cagd;
+using namespace std;
+
+namespace
+{
+    typedef DCoordinate3 (*PartialDerivative)(GLdouble, GLdouble);
+    typedef GLvoid (*PartialDerivativeBatch)(GLuint, const GLdouble*, const GLdouble*,
+                                             DCoordinate3*, DCoordinate3*, DCoordinate3*);
+
+    // the hand-fused batch of a test surface against its partial derivatives that are obtained by automatic
+    // differentiation; the parameters are passed row by row, like by the images of parametric surfaces
+    GLboolean CheckSurface(const char *name, PartialDerivative d00, PartialDerivative d10, PartialDerivative d01,
+                           PartialDerivativeBatch batch, GLdouble u_min, GLdouble u_max, GLdouble v_min, GLdouble v_max)
+    {
+        const GLuint div_point_count = 400, repetition_count = 5;
+
+        vector<GLdouble> u(div_point_count * div_point_count), v(div_point_count * div_point_count);
+
+        for (GLuint i = 0; i < div_point_count; i++)
+        {
+            for (GLuint j = 0; j < div_point_count; j++)
+            {
+                u[i * div_point_count + j] = u_min + i * (u_max - u_min) / (div_point_count - 1);
+                v[i * div_point_count + j] = v_min + j * (v_max - v_min) / (div_point_count - 1);
+            }
+        }
+
+        vector<DCoordinate3> reference[3], fused[3];
+
+        for (GLuint k = 0; k < 3; k++)
+        {
+            reference[k].resize(u.size());
+            fused[k].resize(u.size());
+        }
+
+        Timer timer;
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            for (GLuint i = 0; i < u.size(); i++)
+            {
+                reference[0][i] = d00(u[i], v[i]);
+                reference[1][i] = d10(u[i], v[i]);
+                reference[2][i] = d01(u[i], v[i]);
+            }
+        }
+        GLdouble automatic_time = timer.ElapsedMilliseconds() / repetition_count;
+
+        timer.Restart();
+        for (GLuint r = 0; r < repetition_count; r++)
+        {
+            for (GLuint i = 0; i < div_point_count; i++)
+            {
+                GLuint offset = i * div_point_count;
+
+                batch(div_point_count, &u[offset], &v[offset], &fused[0][offset], &fused[1][offset], &fused[2][offset]);
+            }
+        }
+        GLdouble fused_time = timer.ElapsedMilliseconds() / repetition_count;
+
+        GLdouble difference = 0.0;
+
+        for (GLuint k = 0; k < 3; k++)
+        {
+            for (GLuint i = 0; i < u.size(); i++)
+            {
+                difference = max(difference, (fused[k][i] - reference[k][i]).length() /
+                                              max(1.0, reference[k][i].length()));
+            }
+        }
+
+        GLboolean passed = difference <= 1.0e-12;
+
+        printf("%-14s %12.3f %12.3f %8.2fx %12.2e%s\n", name, automatic_time, fused_time,
+               automatic_time / fused_time, difference, passed ? "" : "  <- too large");
+
+        return passed;
+    }
+}
+
+// hand-fused batches of the test surfaces against their automatic partial derivatives, 400x400 grids
+GLboolean cagd::CheckSurfaceBatches()
+{
+    printf("%-14s %12s %12s %9s %12s\n", "surface", "pointwise ms", "fused ms", "speedup", "max rel diff");
+
+    GLboolean passed = GL_TRUE;
+
+    passed &= CheckSurface("torus", torus::d00, torus::d10, torus::d01, torus::batch,
+                           torus::u_min, torus::u_max, torus::v_min, torus::v_max);
+    passed &= CheckSurface("dupin cyclide", dupin_cyclide::d00, dupin_cyclide::d10, dupin_cyclide::d01,
+                           dupin_cyclide::batch, dupin_cyclide::u_min, dupin_cyclide::u_max,
+                           dupin_cyclide::v_min, dupin_cyclide::v_max);
+    passed &= CheckSurface("sphere", sphere::d00, sphere::d10, sphere::d01, sphere::batch,
+                           sphere::u_min, sphere::u_max, sphere::v_min, sphere::v_max);
+    passed &= CheckSurface("cylinder", cylinder::d00, cylinder::d10, cylinder::d01, cylinder::batch,
+                           cylinder::u_min, cylinder::u_max, cylinder::v_min, cylinder::v_max);
+    passed &= CheckSurface("cone", cone::d00, cone::d10, cone::d01, cone::batch,
+                           cone::u_min, cone::u_max, cone::v_min, cone::v_max);
+    passed &= CheckSurface("seashell", seashell::d00, seashell::d10, seashell::d01, seashell::batch,
+                           seashell::u_min, seashell::u_max, seashell::v_min, seashell::v_max);
+
+    return passed;
+}
@@ -1,163 +1,206 @@
 #include <cmath>
 #include "TestFunctions.h"
 #include "../Core/Constants.h"
+#include "../Parametric/ParametricCurves3.h"
+#include "../Parametric/ParametricSurfaces3.h"
 
 using namespace cagd;
 using namespace std;
 
+// Each test curve and surface is given by its position function, which is written as a template of its scalar
+// type; the derivatives are obtained by automatic differentiation, see the class DualNumber. Images of surfaces
+// are generated by their batches, which are therefore fused by hand: they reuse the trigonometric values of u
+// along a row and are about two to four times faster than the automatic ones. The check "surfaces" of the
+// program Test/Checks compares them with the automatic derivatives.
+
 GLdouble spiral_on_cone::u_min = -TWO_PI;
 GLdouble spiral_on_cone::u_max = +TWO_PI;
 
+template <typename T>
+Coordinate3<T> spiral_on_cone::position(const T& u)
+{
+    return Coordinate3<T>(u * cos(u),
+                          u * sin(u),
+                          u);
+}
+
 DCoordinate3 spiral_on_cone::d0(GLdouble u)
 {
-    return DCoordinate3(u * cos(u),
-                        u * sin(u),
-                        u);
+    return ParametricCurve3::AutomaticDerivative<position, 0>(u);
 }
 
 DCoordinate3 spiral_on_cone::d1(GLdouble u)
 {
-    GLdouble c = cos(u), s = sin(u);
-    return DCoordinate3(c - u * s,
-                        s + u * c,
-                        1.0);
+    return ParametricCurve3::AutomaticDerivative<position, 1>(u);
 }
 
 DCoordinate3 spiral_on_cone::d2(GLdouble u)
 {
-    GLdouble c = cos(u), s = sin(u);
-    return DCoordinate3(-2.0 * s - u * c,
-                        2.0 * c - u * s,
-                        0.0);
+    return ParametricCurve3::AutomaticDerivative<position, 2>(u);
+}
+
+GLvoid spiral_on_cone::batch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+{
+    ParametricCurve3::AutomaticDerivativeBatch<position>(count, u, max_order_of_derivatives, d);
 }
 
 GLdouble torus_knot::u_min = 0.0;
 GLdouble torus_knot::u_max = 3 * TWO_PI;
 
+template <typename T>
+Coordinate3<T> torus_knot::position(const T& u)
+{
+    T c23 = cos(2.0/3.0 * u);
+    return Coordinate3<T>( (c23 + 2.0) * cos(u),
+                           (c23 + 2.0) * sin(u),
+                           sin(2.0/3.0 * u)
+                         );
+}
+
 DCoordinate3 torus_knot::d0(GLdouble u)
 {
-    GLdouble c = cos(u), s = sin(u), c23 = cos(2.0/3.0 * u);
-    return DCoordinate3( (c23 + 2.0) * c,
-                         (c23 + 2.0) * s,
-                         sin(2.0/3.0 * u)
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 0>(u);
 }
 
 DCoordinate3 torus_knot::d1(GLdouble u)
 {
-    GLdouble c = cos(u), s = sin(u), c23 = cos(2.0/3.0 * u), s23 = sin(2.0/3.0 * u);
-    return DCoordinate3(-(c23 + 2.0) * s - 2.0/3.0 * s23 * c,
-                         (c23 + 2.0) * c - 2.0 / 3.0 * s23 * s,
-                         2.0/3.0 * c23
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 1>(u);
 }
 
 DCoordinate3 torus_knot::d2(GLdouble u)
 {
-    GLdouble c = cos(u), s = sin(u), c23 = cos(2.0/3.0 * u), s23 = sin(2.0/3.0 * u);
-    return DCoordinate3( (12.0 * s23 * s - (13.0 * c23 + 18.0) * c) / 9.0,
-                         ((13.0 * c23 + 18.0) * s + 12.0 * s23 * c) / -9.0,
-                         -4.0/9.0 * s23
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 2>(u);
+}
+
+GLvoid torus_knot::batch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+{
+    ParametricCurve3::AutomaticDerivativeBatch<position>(count, u, max_order_of_derivatives, d);
 }
 
 GLdouble spiral_on_sphere::u_min = -PI;
 GLdouble spiral_on_sphere::u_max = PI;
 
+template <typename T>
+Coordinate3<T> spiral_on_sphere::position(const T& u)
+{
+    return Coordinate3<T>( sin(u) * cos(2.0*u),
+                           sin(u) * sin(2.0*u),
+                           cos(u));
+}
+
 DCoordinate3 spiral_on_sphere::d0(GLdouble u)
 {
-    return DCoordinate3( sin(u) * cos(2.0*u),
-                         sin(u) * sin(2.0*u),
-                         cos(u));
+    return ParametricCurve3::AutomaticDerivative<position, 0>(u);
 }
 
 DCoordinate3 spiral_on_sphere::d1(GLdouble u)
 {
-    return DCoordinate3( cos(u)*cos(2.0*u) - 2.0*sin(u)*sin(2.0*u),
-                         cos(u)*sin(2.0*u) + 2.0*sin(u)*cos(2.0*u),
-                         -sin(u));
+    return ParametricCurve3::AutomaticDerivative<position, 1>(u);
 }
 
 DCoordinate3 spiral_on_sphere::d2(GLdouble u)
 {
-    return DCoordinate3( -4.0*cos(u)*sin(2.0*u) - 5*sin(u)*cos(2*u),
-                         4.0*cos(u)*cos(2.0*u) - 5*sin(u)*sin(2*u),
-                         -cos(u));
+    return ParametricCurve3::AutomaticDerivative<position, 2>(u);
+}
+
+GLvoid spiral_on_sphere::batch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+{
+    ParametricCurve3::AutomaticDerivativeBatch<position>(count, u, max_order_of_derivatives, d);
 }
 
 GLdouble viviani::u_min = -PI;
 GLdouble viviani::u_max = PI;
 
+template <typename T>
+Coordinate3<T> viviani::position(const T& u)
+{
+    T s, c;
+    SinCos(u, s, c);
+    return Coordinate3<T>( s * c,
+                           s*s,
+                           c);
+}
+
 DCoordinate3 viviani::d0(GLdouble u)
 {
-    GLdouble s = sin(u), c = cos(u);
-    return DCoordinate3( s * c,
-                         s*s,
-                         c);
+    return ParametricCurve3::AutomaticDerivative<position, 0>(u);
 }
 
 DCoordinate3 viviani::d1(GLdouble u)
 {
-    GLdouble s = sin(u), c = cos(u);
-    return DCoordinate3( c*c - s*s,
-                         2.0 * s * c,
-                         -s);
+    return ParametricCurve3::AutomaticDerivative<position, 1>(u);
 }
 
 DCoordinate3 viviani::d2(GLdouble u)
 {
-    GLdouble s = sin(u), c = cos(u);
-    return DCoordinate3( -4.0 * c * s,
-                         2.0 * (c*c - s*s),
-                         -c);
+    return ParametricCurve3::AutomaticDerivative<position, 2>(u);
+}
+
+GLvoid viviani::batch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+{
+    ParametricCurve3::AutomaticDerivativeBatch<position>(count, u, max_order_of_derivatives, d);
 }
 
 GLdouble hypocycloid::u_min = -PI;
 GLdouble hypocycloid::u_max = PI;
 
+template <typename T>
+Coordinate3<T> hypocycloid::position(const T& u)
+{
+    return Coordinate3<T>( 8.0 * cos(u) + cos(8.0 * u),
+                           8.0 * sin(u) + sin(8.0 * u)
+                         );
+}
+
 DCoordinate3 hypocycloid::d0(GLdouble u)
 {
-    return DCoordinate3( 8.0 * cos(u) + cos(8.0 * u),
-                         8.0 * sin(u) + sin(8.0 * u)
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 0>(u);
 }
 
 DCoordinate3 hypocycloid::d1(GLdouble u)
 {
-    return DCoordinate3( -8.0 * (sin(u) + sin(8.0 * u)),
-                         8.0 * (cos(u) + cos(8.0 * u))
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 1>(u);
 }
 
 DCoordinate3 hypocycloid::d2(GLdouble u)
 {
-    return DCoordinate3( -8.0 * (cos(u) + 8.0 * cos(8.0 * u)),
-                         -8.0 * (sin(u) + 8.0 * sin(8.0 * u))
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 2>(u);
+}
+
+GLvoid hypocycloid::batch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+{
+    ParametricCurve3::AutomaticDerivativeBatch<position>(count, u, max_order_of_derivatives, d);
 }
 
 GLdouble epitrochoid::u_min = -PI;
 GLdouble epitrochoid::u_max = PI;
 
+template <typename T>
+Coordinate3<T> epitrochoid::position(const T& u)
+{
+    return Coordinate3<T>( 4.0 * cos(u) - 0.5 * cos(4.0 * u),
+                           4.0 * sin(u) - 0.5 * sin(4.0 * u)
+                         );
+}
+
 DCoordinate3 epitrochoid::d0(GLdouble u)
 {
-    return DCoordinate3( 4.0 * cos(u) - 0.5 * cos(4.0 * u),
-                         4.0 * sin(u) - 0.5 * sin(4.0 * u)
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 0>(u);
 }
 
 DCoordinate3 epitrochoid::d1(GLdouble u)
 {
-    return DCoordinate3( -4.0 * (sin(u) - 0.5 * sin(4.0 * u)),
-                         4.0 * (cos(u) - 0.5 * cos(4.0 * u))
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 1>(u);
 }
 
 DCoordinate3 epitrochoid::d2(GLdouble u)
 {
-    return DCoordinate3( 4.0 * (2.0 * cos(4.0 * u) - cos(u)),
-                         4.0 * (2.0 * sin(4.0 * u) - sin(u))
-                       );
+    return ParametricCurve3::AutomaticDerivative<position, 2>(u);
+}
+
+GLvoid epitrochoid::batch(GLuint count, const GLdouble *u, GLuint max_order_of_derivatives, DCoordinate3 *d)
+{
+    ParametricCurve3::AutomaticDerivativeBatch<position>(count, u, max_order_of_derivatives, d);
 }
 
 
@@ -169,28 +212,54 @@ GLdouble torus::u_max = TWO_PI;
 GLdouble torus::v_min = 0.0;
 GLdouble torus::v_max = TWO_PI;
 
+template <typename T>
+Coordinate3<T> torus::position(const T& u, const T& v)
+{
+    T su, cu, sv, cv;
+    SinCos(u, su, cu);
+    SinCos(v, sv, cv);
+    return Coordinate3<T>((R + r * cv) * cu,
+                          (R + r * cv) * su,
+                          r * sv
+                          );
+}
+
 DCoordinate3 torus::d00(GLdouble u, GLdouble v)
 {
-    return DCoordinate3((R + r * cos(v)) * cos(u),
-                        (R + r * cos(v)) * sin(u),
-                        r * sin(v)
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 0>(u, v);
 }
 
 DCoordinate3 torus::d10(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(-(R + r * cos(v)) * sin(u),
-                        (R + r * cos(v)) * cos(u),
-                        0.0
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 1, 0>(u, v);
 }
 
 DCoordinate3 torus::d01(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(-r * sin(v) * cos(u),
-                        -r * sin(v) * sin(u),
-                        r * cos(v)
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 1>(u, v);
+}
+
+GLvoid torus::batch(GLuint count, const GLdouble *u, const GLdouble *v, DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
+{
+    GLdouble cu = 0.0, su = 0.0;
+
+    for (GLuint k = 0; k < count; k++)
+    {
+        // images are evaluated row by row, thus the trigonometric values of u are reused
+        if (!k || u[k] != u[k - 1])
+        {
+            SinCos(u[k], su, cu);
+        }
+
+        GLdouble sv, cv;
+        SinCos(v[k], sv, cv);
+
+        GLdouble w = R + r * cv;
+
+        d00[k] = DCoordinate3(w * cu, w * su, r * sv);
+        d10[k] = DCoordinate3(-w * su, w * cu, 0.0);
+        d01[k] = DCoordinate3(-r * sv * cu, -r * sv * su, r * cv);
+    }
 }
 
 GLdouble dupin_cyclide::a = 1.0;
@@ -203,33 +272,61 @@ GLdouble dupin_cyclide::u_max = TWO_PI;
 GLdouble dupin_cyclide::v_min = 0.0;
 GLdouble dupin_cyclide::v_max = TWO_PI;
 
+template <typename T>
+Coordinate3<T> dupin_cyclide::position(const T& u, const T& v)
+{
+    T cu = cos(u), cv = cos(v), denom = (a - c * cu * cv);
+    return Coordinate3<T>((d * (c - a * cu * cv) + b*b * cu) / denom,
+                          b * sin(u) * (a - d * cv) / denom,
+                          b * sin(v) * (c * cu - d) / denom
+                          );
+}
+
 DCoordinate3 dupin_cyclide::d00(GLdouble u, GLdouble v)
 {
-    GLdouble cu = cos(u), cv = cos(v), denom = (a - c * cu * cv);
-    return DCoordinate3((d * (c - a * cu * cv) + b*b * cu) / denom,
-                        b * sin(u) * (a - d * cv) / denom,
-                        b * sin(v) * (c * cu - d) / denom
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 0>(u, v);
 }
 
 DCoordinate3 dupin_cyclide::d10(GLdouble u, GLdouble v)
 {
-    GLdouble cu = cos(u), cv = cos(v), su = sin(u), sv = sin(v), denom = (a - c * cu * cv);
-    denom *= denom;
-    return DCoordinate3(- ((c*c - a*a) * d * cv + a * b*b) * su / denom,
-                        b * (d * cv - a) * (c * cv * su*su + c * cv * cu*cu - a * cu) / denom,
-                        b * c * (d * cv - a) * sv * su / denom
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 1, 0>(u, v);
 }
 
 DCoordinate3 dupin_cyclide::d01(GLdouble u, GLdouble v)
 {
-    GLdouble cu = cos(u), cv = cos(v), su = sin(u), sv = sin(v), denom = (a - c * cu * cv);
-    denom *= denom;
-    return DCoordinate3(- cu * (b*b * c * cu + (c*c - a*a) * d) * sv / denom,
-                        - a * b * (c * cu - d) * su * sv / denom,
-                        - b * (c * cu - d) * (c * cu * sv*sv + c * cu * cv*cv - a * cv) / denom
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 1>(u, v);
+}
+
+GLvoid dupin_cyclide::batch(GLuint count, const GLdouble *u, const GLdouble *v, DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
+{
+    GLdouble cu = 0.0, su = 0.0;
+
+    for (GLuint k = 0; k < count; k++)
+    {
+        // images are evaluated row by row, thus the trigonometric values of u are reused
+        if (!k || u[k] != u[k - 1])
+        {
+            SinCos(u[k], su, cu);
+        }
+
+        GLdouble sv, cv;
+        SinCos(v[k], sv, cv);
+
+        GLdouble denom = (a - c * cu * cv), denom2 = denom * denom;
+
+        d00[k] = DCoordinate3((d * (c - a * cu * cv) + b*b * cu) / denom,
+                              b * su * (a - d * cv) / denom,
+                              b * sv * (c * cu - d) / denom
+                              );
+        d10[k] = DCoordinate3(- ((c*c - a*a) * d * cv + a * b*b) * su / denom2,
+                              b * (d * cv - a) * (c * cv * su*su + c * cv * cu*cu - a * cu) / denom2,
+                              b * c * (d * cv - a) * sv * su / denom2
+                              );
+        d01[k] = DCoordinate3(- cu * (b*b * c * cu + (c*c - a*a) * d) * sv / denom2,
+                              - a * b * (c * cu - d) * su * sv / denom2,
+                              - b * (c * cu - d) * (c * cu * sv*sv + c * cu * cv*cv - a * cv) / denom2
+                              );
+    }
 }
 
 GLdouble sphere::R = 2.0;
@@ -239,28 +336,53 @@ GLdouble sphere::u_max = TWO_PI;
 GLdouble sphere::v_min = EPS;
 GLdouble sphere::v_max = PI - EPS;
 
+template <typename T>
+Coordinate3<T> sphere::position(const T& u, const T& v)
+{
+    T su, cu, sv, cv;
+    SinCos(u, su, cu);
+    SinCos(v, sv, cv);
+    return Coordinate3<T>(R * cu * sv,
+                          R * su * sv,
+                          R * cv
+                          );
+}
+
+// the partial derivatives are exchanged, thus d10 ^ d01 is the outward normal of the sphere
 DCoordinate3 sphere::d00(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(R * cos(u) * sin(v),
-                        R * sin(u) * sin(v),
-                        R * cos(v)
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 0>(u, v);
+}
+
+DCoordinate3 sphere::d10(GLdouble u, GLdouble v)
+{
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 1>(u, v);
 }
 
 DCoordinate3 sphere::d01(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(- R * sin(u) * sin(v),
-                        R * cos(u) * sin(v),
-                        0.0
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 1, 0>(u, v);
 }
 
-DCoordinate3 sphere::d10(GLdouble u, GLdouble v)
+GLvoid sphere::batch(GLuint count, const GLdouble *u, const GLdouble *v, DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
 {
-    return DCoordinate3(R * cos(u) * cos(v),
-                        R * sin(u) * cos(v),
-                        - R * sin(v)
-                        );
+    GLdouble cu = 0.0, su = 0.0;
+
+    for (GLuint k = 0; k < count; k++)
+    {
+        // images are evaluated row by row, thus the trigonometric values of u are reused
+        if (!k || u[k] != u[k - 1])
+        {
+            SinCos(u[k], su, cu);
+        }
+
+        GLdouble sv, cv;
+        SinCos(v[k], sv, cv);
+
+        d00[k] = DCoordinate3(R * cu * sv, R * su * sv, R * cv);
+        d10[k] = DCoordinate3(R * cu * cv, R * su * cv, - R * sv);
+        d01[k] = DCoordinate3(- R * su * sv, R * cu * sv, 0.0);
+    }
 }
 
 GLdouble cylinder::R = 1.8;
@@ -270,19 +392,43 @@ GLdouble cylinder::u_max = TWO_PI;
 GLdouble cylinder::v_min = -2.0;
 GLdouble cylinder::v_max = 2.0;
 
+template <typename T>
+Coordinate3<T> cylinder::position(const T& u, const T& v)
+{
+    return Coordinate3<T>(R * sin(u), v, R * cos(u));
+}
+
 DCoordinate3 cylinder::d00(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(R * sin(u), v, R * cos(u));
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 0>(u, v);
 }
 
 DCoordinate3 cylinder::d10(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(R * cos(u), 0.0, -R * sin(u));
+    return ParametricSurface3::AutomaticPartialDerivative<position, 1, 0>(u, v);
 }
 
 DCoordinate3 cylinder::d01(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(0.0, 1.0, 0.0);
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 1>(u, v);
+}
+
+GLvoid cylinder::batch(GLuint count, const GLdouble *u, const GLdouble *v, DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
+{
+    GLdouble cu = 0.0, su = 0.0;
+
+    for (GLuint k = 0; k < count; k++)
+    {
+        // images are evaluated row by row, thus the trigonometric values of u are reused
+        if (!k || u[k] != u[k - 1])
+        {
+            SinCos(u[k], su, cu);
+        }
+
+        d00[k] = DCoordinate3(R * su, v[k], R * cu);
+        d10[k] = DCoordinate3(R * cu, 0.0, -R * su);
+        d01[k] = DCoordinate3(0.0, 1.0, 0.0);
+    }
 }
 
 GLdouble cone::R = 0.5;
@@ -292,21 +438,44 @@ GLdouble cone::u_max = TWO_PI;
 GLdouble cone::v_min = -2.0;
 GLdouble cone::v_max = 2.0;
 
+template <typename T>
+Coordinate3<T> cone::position(const T& u, const T& v)
+{
+    return Coordinate3<T>(v, R * v * sin(u), R * v * cos(u));
+}
+
 DCoordinate3 cone::d00(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(v, R * v * sin(u), R * v * cos(u));
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 0>(u, v);
 }
 
 DCoordinate3 cone::d10(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(0.0, R * v * cos(u), -R * v * sin(u));
+    return ParametricSurface3::AutomaticPartialDerivative<position, 1, 0>(u, v);
 }
 
 DCoordinate3 cone::d01(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(1.0, R * sin(u), R * cos(u));
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 1>(u, v);
 }
 
+GLvoid cone::batch(GLuint count, const GLdouble *u, const GLdouble *v, DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
+{
+    GLdouble cu = 0.0, su = 0.0;
+
+    for (GLuint k = 0; k < count; k++)
+    {
+        // images are evaluated row by row, thus the trigonometric values of u are reused
+        if (!k || u[k] != u[k - 1])
+        {
+            SinCos(u[k], su, cu);
+        }
+
+        d00[k] = DCoordinate3(v[k], R * v[k] * su, R * v[k] * cu);
+        d10[k] = DCoordinate3(0.0, R * v[k] * cu, -R * v[k] * su);
+        d01[k] = DCoordinate3(1.0, R * su, R * cu);
+    }
+}
 
 GLdouble seashell::c = 5.0/4.0;
 
@@ -315,26 +484,57 @@ GLdouble seashell::u_max = TWO_PI;
 GLdouble seashell::v_min = -TWO_PI;
 GLdouble seashell::v_max = TWO_PI;
 
+template <typename T>
+Coordinate3<T> seashell::position(const T& u, const T& v)
+{
+    T w = 1.0 - v / TWO_PI, s2 = sin(2.0*v), c2 = cos(2.0*v);
+    return Coordinate3<T>(c * w * s2 * (1.0 + cos(u)) + s2,
+                          c * w * c2 * (1.0 + cos(u)) + c2,
+                          c * v + c * w * sin(u)
+                          );
+}
+
 DCoordinate3 seashell::d00(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(c * (1.0 - v / TWO_PI) * sin(2.0*v) * (1 + cos(u)) + sin(2.0*v),
-                        c * (1.0 - v / TWO_PI) * cos(2.0*v) * (1 + cos(u)) + cos(2.0*v),
-                        c * v + c * (1.0 - v / TWO_PI) * sin(u)
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 0>(u, v);
 }
 
 DCoordinate3 seashell::d10(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(- c * (1.0 - v / TWO_PI) * sin(2.0*v) * sin(u),
-                        - c * (1.0 - v / TWO_PI) * cos(2.0*v) * sin(u),
-                        c * (1.0 - v / TWO_PI) * cos(u)
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 1, 0>(u, v);
 }
 
 DCoordinate3 seashell::d01(GLdouble u, GLdouble v)
 {
-    return DCoordinate3(c * (1 + cos(u)) * (sin(2.0*v) / TWO_PI + (1.0 - v / TWO_PI) * 2.0 * cos(2.0*v)) + 2.0 * cos(2.0*v),
-                        c * (1 + cos(u)) * (cos(2.0*v) / TWO_PI - (1.0 - v / TWO_PI) * 2.0 * sin(2.0*v)) - 2.0 * sin(2.0*v),
-                        (1.0 - c * sin(u)) / TWO_PI
-                        );
+    return ParametricSurface3::AutomaticPartialDerivative<position, 0, 1>(u, v);
+}
+
+GLvoid seashell::batch(GLuint count, const GLdouble *u, const GLdouble *v, DCoordinate3 *d00, DCoordinate3 *d10, DCoordinate3 *d01)
+{
+    GLdouble cu = 0.0, su = 0.0;
+
+    for (GLuint k = 0; k < count; k++)
+    {
+        // images are evaluated row by row, thus the trigonometric values of u are reused
+        if (!k || u[k] != u[k - 1])
+        {
+            SinCos(u[k], su, cu);
+        }
+
+        GLdouble w = 1.0 - v[k] / TWO_PI, s2, c2;
+        SinCos(2.0*v[k], s2, c2);
+
+        d00[k] = DCoordinate3(c * w * s2 * (1 + cu) + s2,
+                              c * w * c2 * (1 + cu) + c2,
+                              c * v[k] + c * w * su
+                              );
+        d10[k] = DCoordinate3(- c * w * s2 * su,
+                              - c * w * c2 * su,
+                              c * w * cu
+                              );
+        d01[k] = DCoordinate3(c * (1 + cu) * (w * 2.0 * c2 - s2 / TWO_PI) + 2.0 * c2,
+                              - c * (1 + cu) * (w * 2.0 * s2 + c2 / TWO_PI) - 2.0 * s2,
+                              c * (1.0 - su / TWO_PI)
+                              );
+    }
 }
@@ -8,49 +8,85 @@ namespace cagd
     {
         extern GLdouble u_min, u_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&);
+
         DCoordinate3 d0(GLdouble);
         DCoordinate3 d1(GLdouble);
         DCoordinate3 d2(GLdouble);
+
+        // d0, d1 and d2 at count parameter values, see ParametricCurve3::DerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, GLuint, DCoordinate3*);
     }
 
     namespace torus_knot {
         extern GLdouble u_min, u_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&);
+
         DCoordinate3 d0(GLdouble);
         DCoordinate3 d1(GLdouble);
         DCoordinate3 d2(GLdouble);
+
+        // d0, d1 and d2 at count parameter values, see ParametricCurve3::DerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, GLuint, DCoordinate3*);
     }
 
     namespace spiral_on_sphere {
         extern GLdouble u_min, u_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&);
+
         DCoordinate3 d0(GLdouble);
         DCoordinate3 d1(GLdouble);
         DCoordinate3 d2(GLdouble);
+
+        // d0, d1 and d2 at count parameter values, see ParametricCurve3::DerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, GLuint, DCoordinate3*);
     }
 
     namespace viviani {
         extern GLdouble u_min, u_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&);
+
         DCoordinate3 d0(GLdouble);
         DCoordinate3 d1(GLdouble);
         DCoordinate3 d2(GLdouble);
+
+        // d0, d1 and d2 at count parameter values, see ParametricCurve3::DerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, GLuint, DCoordinate3*);
     }
 
     namespace hypocycloid {
         extern GLdouble u_min, u_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&);
+
         DCoordinate3 d0(GLdouble);
         DCoordinate3 d1(GLdouble);
         DCoordinate3 d2(GLdouble);
+
+        // d0, d1 and d2 at count parameter values, see ParametricCurve3::DerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, GLuint, DCoordinate3*);
     }
 
     namespace epitrochoid {
         extern GLdouble u_min, u_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&);
+
         DCoordinate3 d0(GLdouble);
         DCoordinate3 d1(GLdouble);
         DCoordinate3 d2(GLdouble);
+
+        // d0, d1 and d2 at count parameter values, see ParametricCurve3::DerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, GLuint, DCoordinate3*);
     }
 
     namespace torus {
@@ -58,9 +94,15 @@ namespace cagd
 
         extern GLdouble u_min, u_max, v_min, v_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&, const T&);
+
         DCoordinate3 d00(GLdouble, GLdouble);
         DCoordinate3 d10(GLdouble, GLdouble);
         DCoordinate3 d01(GLdouble, GLdouble);
+
+        // d00, d10 and d01 at count parameter pairs, see ParametricSurface3::PartialDerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, const GLdouble*, DCoordinate3*, DCoordinate3*, DCoordinate3*);
     }
 
     namespace dupin_cyclide {
@@ -68,9 +110,15 @@ namespace cagd
 
         extern GLdouble u_min, u_max, v_min, v_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&, const T&);
+
         DCoordinate3 d00(GLdouble, GLdouble);
         DCoordinate3 d10(GLdouble, GLdouble);
         DCoordinate3 d01(GLdouble, GLdouble);
+
+        // d00, d10 and d01 at count parameter pairs, see ParametricSurface3::PartialDerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, const GLdouble*, DCoordinate3*, DCoordinate3*, DCoordinate3*);
     }
 
     namespace sphere {
@@ -78,9 +126,15 @@ namespace cagd
 
         extern GLdouble u_min, u_max, v_min, v_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&, const T&);
+
         DCoordinate3 d00(GLdouble, GLdouble);
         DCoordinate3 d10(GLdouble, GLdouble);
         DCoordinate3 d01(GLdouble, GLdouble);
+
+        // d00, d10 and d01 at count parameter pairs, see ParametricSurface3::PartialDerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, const GLdouble*, DCoordinate3*, DCoordinate3*, DCoordinate3*);
     }
 
     namespace cylinder {
@@ -88,9 +142,15 @@ namespace cagd
 
         extern GLdouble u_min, u_max, v_min, v_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&, const T&);
+
         DCoordinate3 d00(GLdouble, GLdouble);
         DCoordinate3 d10(GLdouble, GLdouble);
         DCoordinate3 d01(GLdouble, GLdouble);
+
+        // d00, d10 and d01 at count parameter pairs, see ParametricSurface3::PartialDerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, const GLdouble*, DCoordinate3*, DCoordinate3*, DCoordinate3*);
     }
 
     namespace cone {
@@ -98,9 +158,15 @@ namespace cagd
 
         extern GLdouble u_min, u_max, v_min, v_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&, const T&);
+
         DCoordinate3 d00(GLdouble, GLdouble);
         DCoordinate3 d10(GLdouble, GLdouble);
         DCoordinate3 d01(GLdouble, GLdouble);
+
+        // d00, d10 and d01 at count parameter pairs, see ParametricSurface3::PartialDerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, const GLdouble*, DCoordinate3*, DCoordinate3*, DCoordinate3*);
     }
 
     namespace seashell {
@@ -108,8 +174,14 @@ namespace cagd
 
         extern GLdouble u_min, u_max, v_min, v_max;
 
+        template <typename T>
+        Coordinate3<T> position(const T&, const T&);
+
         DCoordinate3 d00(GLdouble, GLdouble);
         DCoordinate3 d10(GLdouble, GLdouble);
         DCoordinate3 d01(GLdouble, GLdouble);
+
+        // d00, d10 and d01 at count parameter pairs, see ParametricSurface3::PartialDerivativeBatch
+        GLvoid batch(GLuint, const GLdouble*, const GLdouble*, DCoordinate3*, DCoordinate3*, DCoordinate3*);
     }
 }
@@ -12,12 +12,12 @@ namespace cagd {
 
         bc(0, 0) = 1.0;
 
-        for (GLuint r = 1; r < order; r++)
+        for (GLuint r = 1; r <= order; r++)
         {
             bc(r, 0) = 1.0;
             bc(r, r) = 1.0;
 
-            for (GLuint i = 1; i < r / 2; i++)
+            for (GLuint i = 1; i <= r / 2; i++)
             {
                 bc(r, i) = bc(r-1, i-1) + bc(r-1, i);
                 bc(r, r-i) = bc(r, i);
@@ -54,6 +54,21 @@ namespace cagd {
         return GL_TRUE;
     }
 
+    // the collocation matrices depend on the pairs (alpha, n) and (beta, m)
+    GLvoid TrigonometricBernsteinSurface3::_AppendShapeParameters(GLuint direction, vector<GLdouble>& shape_parameters) const
+    {
+        if (direction == 0)
+        {
+            shape_parameters.push_back(_alpha);
+            shape_parameters.push_back(_n);
+        }
+        else
+        {
+            shape_parameters.push_back(_beta);
+            shape_parameters.push_back(_m);
+        }
+    }
+
     // special constructor
     TrigonometricBernsteinSurface3::TrigonometricBernsteinSurface3(GLdouble alpha, GLuint n, GLdouble beta, GLuint m):
         TensorProductSurface3(0.0, alpha, 0.0, beta, 2 * n + 1, 2 * m + 1),
@@ -115,9 +130,9 @@ namespace cagd {
 
                     values[size - 1] = su_order;
 
-                    for(GLuint i = size - 2; i >= 0; i--)
+                    for(GLuint i = size - 1; i > 0; i--)
                     {
-                        values[i] = values[i + 1] * factor;
+                        values[i - 1] = values[i] * factor;
                     }
                 }
                 for (GLuint i = 0; i < size; i++)
@@ -179,9 +194,9 @@ namespace cagd {
 
                     values[size - 1] = sv_order;
 
-                    for(GLuint j = size - 2; j >= 0; j--)
+                    for(GLuint j = size - 1; j > 0; j--)
                     {
-                        values[j] = values[j + 1] * factor;
+                        values[j - 1] = values[j] * factor;
                     }
                 }
                 for (GLuint j = 0; j < size; j++)
@@ -194,6 +209,77 @@ namespace cagd {
         return GL_TRUE;
     }
 
+    // the derivatives are given by the three-term recurrence
+    // A'_{2n,i} = c_i / c_{i-1} * i / (2 sin(alpha / 2)) * A_{2n,i-1} - (n - i) / tan(alpha / 2) * A_{2n,i}
+    //           - c_i / c_{i+1} * (2n - i) / (2 sin(alpha / 2)) * A_{2n,i+1}
+    GLboolean TrigonometricBernsteinSurface3::UBlendingFunctionDerivatives(
+            GLuint maximum_order_of_derivatives, GLdouble u, Matrix<GLdouble>& derivatives) const
+    {
+        RowMatrix<GLdouble> Au;
+
+        if (!UBlendingFunctionValues(u, Au))
+        {
+            derivatives.ResizeRows(0);
+            return GL_FALSE;
+        }
+
+        GLuint u_size = 2 * _n + 1;
+
+        GLdouble sua = 2.0 * sin(_alpha / 2.0), tua = tan(_alpha / 2.0);
+
+        derivatives.ResizeRows(maximum_order_of_derivatives + 1);
+        derivatives.ResizeColumns(u_size);
+
+        derivatives.SetRow(0, Au);
+
+        for (GLuint d = 1; d <= maximum_order_of_derivatives; d++)
+        {
+            for (GLuint i = 0; i < u_size; i++)
+            {
+                derivatives(d, i) =
+                        ((i > 0) ? _u_c[i] / _u_c[i-1] * i / sua * derivatives(d-1, i-1) : 0.0)
+                        - ((static_cast<GLint>(_n) - static_cast<GLint>(i)) / tua * derivatives(d - 1, i))
+                        - (( i < 2 * _n ) ? (_u_c[i] / _u_c[i+1] * (2.0 * _n - i) / sua) * derivatives(d - 1, i+1) : 0.0);
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    GLboolean TrigonometricBernsteinSurface3::VBlendingFunctionDerivatives(
+            GLuint maximum_order_of_derivatives, GLdouble v, Matrix<GLdouble>& derivatives) const
+    {
+        RowMatrix<GLdouble> Av;
+
+        if (!VBlendingFunctionValues(v, Av))
+        {
+            derivatives.ResizeRows(0);
+            return GL_FALSE;
+        }
+
+        GLuint v_size = 2 * _m + 1;
+
+        GLdouble svb = 2.0 * sin(_beta / 2.0), tvb = tan(_beta / 2.0);
+
+        derivatives.ResizeRows(maximum_order_of_derivatives + 1);
+        derivatives.ResizeColumns(v_size);
+
+        derivatives.SetRow(0, Av);
+
+        for (GLuint d = 1; d <= maximum_order_of_derivatives; d++)
+        {
+            for (GLuint j = 0; j < v_size; j++)
+            {
+                derivatives(d, j) =
+                        ((j > 0) ? _v_c[j] / _v_c[j-1] * j / svb * derivatives(d-1, j-1) : 0.0)
+                        - ((static_cast<GLint>(_m) - static_cast<GLint>(j)) / tvb * derivatives(d - 1, j))
+                        - (( j < 2 * _m ) ? (_v_c[j] / _v_c[j+1] * (2.0 * _m - j) / svb) * derivatives(d - 1, j+1) : 0.0);
+            }
+        }
+
+        return GL_TRUE;
+    }
+
     GLboolean TrigonometricBernsteinSurface3::CalculatePartialDerivatives(
             GLuint maximum_order_of_partial_derivatives, GLdouble u, GLdouble v, PartialDerivatives &pd) const
     {
@@ -208,45 +294,25 @@ namespace cagd {
 
         GLuint u_size = 2 * _n + 1, v_size = 2 * _m + 1;
 
-        RowMatrix<GLdouble> Au, Av;
+        Matrix<GLdouble> dAu, dAv;
 
-        if (!UBlendingFunctionValues(u, Au) || !VBlendingFunctionValues(v, Av))
+        if (!UBlendingFunctionDerivatives(maximum_order_of_partial_derivatives, u, dAu) ||
+            !VBlendingFunctionDerivatives(maximum_order_of_partial_derivatives, v, dAv))
         {
             pd.ResizeRows(0);
             return GL_FALSE;
         }
 
-        GLdouble sua = 2.0 * sin(_alpha / 2.0), tua = tan(_alpha / 2.0);
-        GLdouble svb = 2.0 * sin(_beta / 2.0), tvb = tan(_beta / 2.0);
-
-        Matrix<GLdouble> dAu(maximum_order_of_partial_derivatives + 1, u_size);
-        Matrix<GLdouble> dAv(maximum_order_of_partial_derivatives + 1, v_size);
+        // allocated only once, and reset for each row of the control net
+        RowMatrix<DCoordinate3> diff_v(maximum_order_of_partial_derivatives + 1);
 
-        dAu.SetRow(0, Au);
-        dAv.SetRow(0, Av);
-
-        for (GLuint d = 1; d <= maximum_order_of_partial_derivatives; d++)
+        for (GLuint i = 0; i < u_size; i++)
         {
-            for (GLuint i = 0; i < u_size; i++)
-            {
-                dAu(d, i) =
-                        ((i > 0) ? _u_c[i] / _u_c[i-1] * i / sua * dAu(d-1, i-1) : 0.0)
-                        - ((static_cast<GLint>(_n) - static_cast<GLint>(i)) / tua * dAu(d - 1, i))
-                        - (( i < 2 * _n ) ? (_u_c[i] / _u_c[i+1] * (2.0 * _n * i) / sua) * dAu(d - 1, i+1) : 0.0);
-            }
-
-            for (GLuint j = 0; j < v_size; j++)
+            for (GLuint d = 0; d <= maximum_order_of_partial_derivatives; d++)
             {
-                dAv(d, j) =
-                        ((j > 0) ? _v_c[j] / _v_c[j-1] * j / svb * dAv(d-1, j-1) : 0.0)
-                        - ((static_cast<GLint>(_m) - static_cast<GLint>(j)) / tvb * dAv(d - 1, j))
-                        - (( j < 2 * _m ) ? (_v_c[j] / _v_c[j+1] * (2.0 * _m * j) / svb) * dAv(d - 1, j+1) : 0.0);
+                diff_v[d] = DCoordinate3();
             }
-        }
 
-        for (GLuint i = 0; i < u_size; i++)
-        {
-            RowMatrix<DCoordinate3> diff_v(maximum_order_of_partial_derivatives + 1);
             for (GLuint j = 0; j < v_size; j++)
             {
                 for (GLuint d = 0; d <= maximum_order_of_partial_derivatives; d++)
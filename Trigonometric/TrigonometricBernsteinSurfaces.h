@@ -24,6 +24,9 @@ namespace cagd {
         GLvoid                  _CalculateBinomialCoefficients(GLuint order, TriangularMatrix<GLdouble> &bc);
         GLboolean               _CalculateNormalizingCoefficients(GLuint order, GLdouble alpha, RowMatrix<GLdouble> &c);
 
+        // the collocation matrices depend on the pairs (alpha, n) and (beta, m)
+        GLvoid                  _AppendShapeParameters(GLuint direction, std::vector<GLdouble>& shape_parameters) const;
+
     public:
         // special constructor
         TrigonometricBernsteinSurface3(GLdouble alpha, GLuint n, GLdouble beta, GLuint m);
@@ -31,6 +34,10 @@ namespace cagd {
         // inherited pure virtual abstract methods that must be declared and defined
         GLboolean UBlendingFunctionValues(GLdouble u, RowMatrix<GLdouble>& values) const;
         GLboolean VBlendingFunctionValues(GLdouble v, RowMatrix<GLdouble>& values) const;
+
+        // zeroth and higher order derivatives of the blending functions, thus images are evaluated on whole grids
+        GLboolean UBlendingFunctionDerivatives(GLuint maximum_order_of_derivatives, GLdouble u, Matrix<GLdouble>& derivatives) const;
+        GLboolean VBlendingFunctionDerivatives(GLuint maximum_order_of_derivatives, GLdouble v, Matrix<GLdouble>& derivatives) const;
         GLboolean CalculatePartialDerivatives(GLuint maximum_order_of_partial_derivatives, GLdouble u, GLdouble v, PartialDerivatives& pd) const;
 
         //...